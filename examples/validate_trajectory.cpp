@@ -0,0 +1,191 @@
+// Copyright (c) 2017 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <franka/trajectory_validation.h>
+
+/**
+ * @example validate_trajectory.cpp
+ * A command line tool which checks planned trajectories before they are sent to the robot, without
+ * connecting to a robot. Each file contains one sample per line, as whitespace-separated numbers:
+ * 7 joint values, a column-major 4x4 pose or a 6-dimensional twist, optionally followed by the two
+ * elbow values for Cartesian motions. Empty lines and lines starting with `#` are ignored.
+ *
+ * Reports every sample that would be rejected or changed by rate limiting, and exits with 1 if any
+ * was found.
+ */
+
+namespace {
+
+constexpr size_t kMaxPrintedViolations = 20;
+
+auto toString(franka::TrajectoryViolationType type) -> const char* {
+  switch (type) {
+    case franka::TrajectoryViolationType::kNotFinite:
+      return "infinite or NaN";
+    case franka::TrajectoryViolationType::kInvalidTransformation:
+      return "invalid transformation";
+    case franka::TrajectoryViolationType::kInvalidElbow:
+      return "invalid elbow";
+    case franka::TrajectoryViolationType::kVelocityLimit:
+      return "velocity limit";
+    case franka::TrajectoryViolationType::kAccelerationLimit:
+      return "acceleration limit";
+    case franka::TrajectoryViolationType::kJerkLimit:
+      return "jerk limit";
+    case franka::TrajectoryViolationType::kRateLimited:
+      return "rate limited";
+  }
+  return "unknown";
+}
+
+auto toSample(const std::vector<double>& values, franka::JointPositions* /* tag */)
+    -> franka::JointPositions {
+  if (values.size() != 7) {
+    throw std::invalid_argument("expected 7 joint positions");
+  }
+  std::array<double, 7> q{};
+  std::copy(values.begin(), values.end(), q.begin());
+  return franka::JointPositions(q);
+}
+
+auto toSample(const std::vector<double>& values, franka::JointVelocities* /* tag */)
+    -> franka::JointVelocities {
+  if (values.size() != 7) {
+    throw std::invalid_argument("expected 7 joint velocities");
+  }
+  std::array<double, 7> dq{};
+  std::copy(values.begin(), values.end(), dq.begin());
+  return franka::JointVelocities(dq);
+}
+
+auto toSample(const std::vector<double>& values, franka::CartesianPose* /* tag */)
+    -> franka::CartesianPose {
+  if (values.size() != 16 && values.size() != 18) {
+    throw std::invalid_argument("expected 16 pose values and optionally 2 elbow values");
+  }
+  std::array<double, 16> pose{};
+  std::array<double, 2> elbow{};
+  std::copy(values.begin(), values.begin() + 16, pose.begin());
+  std::copy(values.begin() + 16, values.end(), elbow.begin());
+  return franka::CartesianPose(pose, elbow);
+}
+
+auto toSample(const std::vector<double>& values, franka::CartesianVelocities* /* tag */)
+    -> franka::CartesianVelocities {
+  if (values.size() != 6 && values.size() != 8) {
+    throw std::invalid_argument("expected 6 twist values and optionally 2 elbow values");
+  }
+  std::array<double, 6> twist{};
+  std::array<double, 2> elbow{};
+  std::copy(values.begin(), values.begin() + 6, twist.begin());
+  std::copy(values.begin() + 6, values.end(), elbow.begin());
+  return franka::CartesianVelocities(twist, elbow);
+}
+
+template <typename T>
+auto load(const std::string& path) -> franka::Trajectory<T> {
+  std::ifstream file(path);
+  if (!file) {
+    throw std::runtime_error(path + ": cannot open file");
+  }
+  franka::Trajectory<T> trajectory;
+  std::string line;
+  for (size_t line_number = 1; std::getline(file, line); line_number++) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    std::istringstream stream(line);
+    std::vector<double> values;
+    double value = 0.0;
+    while (stream >> value) {
+      values.push_back(value);
+    }
+    try {
+      if (!stream.eof()) {
+        throw std::invalid_argument("not a number");
+      }
+      trajectory.add(toSample(values, static_cast<T*>(nullptr)));
+    } catch (const std::invalid_argument& e) {
+      throw std::runtime_error(path + ":" + std::to_string(line_number) + ": " + e.what());
+    }
+  }
+  return trajectory;
+}
+
+template <typename T>
+auto validate(const std::vector<std::string>& paths) -> bool {
+  std::vector<franka::Trajectory<T>> trajectories;
+  trajectories.reserve(paths.size());
+  for (const std::string& path : paths) {
+    trajectories.push_back(load<T>(path));
+  }
+
+  std::vector<franka::TrajectoryValidationReport> reports =
+      franka::validateTrajectories(trajectories);
+
+  bool valid = true;
+  for (size_t i = 0; i < reports.size(); i++) {
+    const franka::TrajectoryValidationReport& report = reports[i];
+    std::cout << paths[i] << ": " << report.samples << " samples, ";
+    if (report.valid()) {
+      std::cout << "valid" << std::endl;
+      continue;
+    }
+    valid = false;
+    std::cout << report.violations.size() << " violations" << std::endl;
+    for (size_t j = 0; j < std::min(report.violations.size(), kMaxPrintedViolations); j++) {
+      const franka::TrajectoryViolation& violation = report.violations[j];
+      std::cout << "  sample " << violation.sample << ", component " << violation.component << ": "
+                << toString(violation.type);
+      if (violation.deviation > 0.0) {
+        std::cout << " (changed by " << violation.deviation << ")";
+      }
+      std::cout << std::endl;
+    }
+    if (report.violations.size() > kMaxPrintedViolations) {
+      std::cout << "  ..." << std::endl;
+    }
+  }
+  return valid;
+}
+
+}  // anonymous namespace
+
+int main(int argc, char** argv) {
+  if (argc < 3) {
+    std::cerr << "Usage: " << argv[0]
+              << " <joint_positions|joint_velocities|cartesian_pose|cartesian_velocities>"
+              << " <trajectory-file>..." << std::endl;
+    return -1;
+  }
+
+  std::string type(argv[1]);
+  std::vector<std::string> paths(argv + 2, argv + argc);
+  try {
+    bool valid = false;
+    if (type == "joint_positions") {
+      valid = validate<franka::JointPositions>(paths);
+    } else if (type == "joint_velocities") {
+      valid = validate<franka::JointVelocities>(paths);
+    } else if (type == "cartesian_pose") {
+      valid = validate<franka::CartesianPose>(paths);
+    } else if (type == "cartesian_velocities") {
+      valid = validate<franka::CartesianVelocities>(paths);
+    } else {
+      std::cerr << "Unknown motion type: " << type << std::endl;
+      return -1;
+    }
+    return valid ? 0 : 1;
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return -1;
+  }
+}
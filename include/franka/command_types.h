@@ -4,6 +4,7 @@
 
 #include <array>
 #include <cstdint>
+#include <optional>
 
 /**
  * @file command_types.h
@@ -39,4 +40,128 @@ struct VirtualWallCuboid {
   bool active;
 };
 
+/**
+ * Set of configuration commands that are sent to the robot together.
+ *
+ * Only the parameters that have been given are changed; the commands are sent in the order of the
+ * members below.
+ *
+ * @see Robot::configure
+ */
+struct RobotConfiguration {
+  /**
+   * Contact and collision thresholds.
+   *
+   * @see Robot::setCollisionBehavior
+   */
+  struct CollisionBehavior {
+    /**
+     * Contact torque thresholds during acceleration/deceleration for each joint in \f$[Nm]\f$.
+     */
+    std::array<double, 7> lower_torque_thresholds_acceleration;
+    /**
+     * Collision torque thresholds during acceleration/deceleration for each joint in \f$[Nm]\f$.
+     */
+    std::array<double, 7> upper_torque_thresholds_acceleration;
+    /**
+     * Contact torque thresholds for each joint in \f$[Nm]\f$.
+     */
+    std::array<double, 7> lower_torque_thresholds_nominal;
+    /**
+     * Collision torque thresholds for each joint in \f$[Nm]\f$.
+     */
+    std::array<double, 7> upper_torque_thresholds_nominal;
+    /**
+     * Contact force thresholds during acceleration/deceleration for \f$(x,y,z,R,P,Y)\f$ in
+     * \f$[N]\f$.
+     */
+    std::array<double, 6> lower_force_thresholds_acceleration;
+    /**
+     * Collision force thresholds during acceleration/deceleration for \f$(x,y,z,R,P,Y)\f$ in
+     * \f$[N]\f$.
+     */
+    std::array<double, 6> upper_force_thresholds_acceleration;
+    /**
+     * Contact force thresholds for \f$(x,y,z,R,P,Y)\f$ in \f$[N]\f$.
+     */
+    std::array<double, 6> lower_force_thresholds_nominal;
+    /**
+     * Collision force thresholds for \f$(x,y,z,R,P,Y)\f$ in \f$[N]\f$.
+     */
+    std::array<double, 6> upper_force_thresholds_nominal;
+  };
+
+  /**
+   * Unlocked movements in guiding mode.
+   *
+   * @see Robot::setGuidingMode
+   */
+  struct GuidingMode {
+    /**
+     * Unlocked movement in (x, y, z, R, P, Y) in guiding mode.
+     */
+    std::array<bool, 6> guiding_mode;
+    /**
+     * True if the elbow is free in guiding mode, false otherwise.
+     */
+    bool elbow;
+  };
+
+  /**
+   * Dynamic parameters of a payload.
+   *
+   * @see Robot::setLoad
+   */
+  struct Load {
+    /**
+     * Mass of the load in \f$[kg]\f$.
+     */
+    double load_mass;
+    /**
+     * Translation from flange to center of mass of load \f$^Fx_{C_\text{load}}\f$ in \f$[m]\f$.
+     */
+    std::array<double, 3> F_x_Cload;
+    /**
+     * Inertia matrix \f$I_\text{load}\f$ in \f$[kg \times m^2]\f$, column-major.
+     */
+    std::array<double, 9> load_inertia;
+  };
+
+  /**
+   * Collision behavior, see Robot::setCollisionBehavior.
+   */
+  std::optional<CollisionBehavior> collision_behavior;
+
+  /**
+   * Joint impedance values \f$K_{\theta}\f$, see Robot::setJointImpedance.
+   */
+  std::optional<std::array<double, 7>> joint_impedance;
+
+  /**
+   * Cartesian impedance values \f$K_x=(x, y, z, R, P, Y)\f$, see Robot::setCartesianImpedance.
+   */
+  std::optional<std::array<double, 6>> cartesian_impedance;
+
+  /**
+   * Guiding mode, see Robot::setGuidingMode.
+   */
+  std::optional<GuidingMode> guiding_mode;
+
+  /**
+   * Vectorized flange-to-EE transformation matrix \f$^FT_{EE}\f$, column-major, see
+   * Robot::setEE.
+   */
+  std::optional<std::array<double, 16>> F_T_EE;
+
+  /**
+   * Vectorized EE-to-K transformation matrix \f$^{EE}T_K\f$, column-major, see Robot::setK.
+   */
+  std::optional<std::array<double, 16>> EE_T_K;
+
+  /**
+   * Payload parameters, see Robot::setLoad.
+   */
+  std::optional<Load> load;
+};
+
 }  // namespace franka
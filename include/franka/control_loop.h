@@ -0,0 +1,653 @@
+// Copyright (c) 2017 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include <franka/control_loop_timing.h>
+#include <franka/control_loop_watchdog.h>
+#include <franka/control_types.h>
+#include <franka/duration.h>
+#include <franka/lowpass_filter.h>
+#include <franka/rate_limiting.h>
+#include <franka/robot_state.h>
+
+/**
+ * @file control_loop.h
+ * Contains the franka::ControlLoop type, which runs the callbacks given to Robot::control.
+ */
+
+/// @cond DO_NOT_DOCUMENT
+namespace research_interface {
+namespace robot {
+struct MotionGeneratorCommand;
+struct ControllerCommand;
+}  // namespace robot
+}  // namespace research_interface
+/// @endcond
+
+namespace franka {
+
+class RobotControl;
+class ControlLoopTimingRecorder;
+
+/**
+ * Checks whether Callback can be called with the arguments of Signature and returns exactly its
+ * result type.
+ */
+template <typename Callback, typename Signature, typename = void>
+struct IsCallbackFor : std::false_type {};
+
+/// @cond DO_NOT_DOCUMENT
+template <typename Callback, typename R, typename... Args>
+struct IsCallbackFor<
+    Callback,
+    R(Args...),
+    std::enable_if_t<std::is_same<std::invoke_result_t<Callback&, Args...>, R>::value>>
+    : std::true_type {};
+/// @endcond
+
+/**
+ * Checks whether T can be returned by a motion generator callback.
+ */
+template <typename T>
+struct IsMotionGeneratorOutput
+    : std::integral_constant<bool,
+                             std::is_same<T, JointPositions>::value ||
+                                 std::is_same<T, JointVelocities>::value ||
+                                 std::is_same<T, CartesianPose>::value ||
+                                 std::is_same<T, CartesianVelocities>::value> {};
+
+/**
+ * @name Rate limiting policies
+ * Decide whether a ControlLoop limits the commands to the robot's limits. Select them with the
+ * `TRateLimiting` parameter of ControlLoop.
+ * @{
+ */
+
+/**
+ * Always limits the commands.
+ */
+struct RateLimiting {
+  /// @return True.
+  constexpr auto enabled() const noexcept -> bool { return true; }
+};
+
+/**
+ * Never limits the commands. The loop contains no rate limiting code at all.
+ */
+struct NoRateLimiting {
+  /// @return False.
+  constexpr auto enabled() const noexcept -> bool { return false; }
+};
+
+/**
+ * Limits the commands if enabled at runtime. Implicitly created from the `limit_rate` flag of
+ * Robot::control.
+ */
+class ConfigurableRateLimiting {
+ public:
+  /**
+   * @param[in] limit_rate True if rate limiting should be activated.
+   */
+  constexpr ConfigurableRateLimiting(bool limit_rate) noexcept
+      : enabled_(limit_rate) {}
+
+  /// @return True if rate limiting is activated.
+  constexpr auto enabled() const noexcept -> bool { return enabled_; }
+
+ private:
+  bool enabled_;
+};
+
+/**
+ * @}
+ */
+
+/**
+ * @name Filtering policies
+ * Decide whether a ControlLoop applies a first-order low-pass filter to the commands. Select them
+ * with the `TFiltering` parameter of ControlLoop.
+ * @{
+ */
+
+/**
+ * Always filters the commands. The filter gain is computed once on construction.
+ */
+class LowpassFiltering {
+ public:
+  /**
+   * @param[in] cutoff_frequency Cutoff frequency of the low-pass filter.
+   *
+   * @throw std::invalid_argument if cutoff_frequency is zero, negative, infinite or NaN.
+   */
+  explicit LowpassFiltering(double cutoff_frequency)
+      : gain_(lowpassFilterGain(kDeltaT, cutoff_frequency)) {}
+
+  /// @return True.
+  constexpr auto enabled() const noexcept -> bool { return true; }
+
+  /// @return Filter gain.
+  constexpr auto gain() const noexcept -> double { return gain_; }
+
+ private:
+  double gain_;
+};
+
+/**
+ * Never filters the commands. The loop contains no filtering code at all.
+ */
+struct NoFiltering {
+  /// @return False.
+  constexpr auto enabled() const noexcept -> bool { return false; }
+
+  /// @return Filter gain which keeps the commands unchanged.
+  constexpr auto gain() const noexcept -> double { return 1.0; }
+};
+
+/**
+ * Filters the commands unless the cutoff frequency is set to kMaxCutoffFrequency at runtime.
+ * Implicitly created from the `cutoff_frequency` argument of Robot::control.
+ */
+class ConfigurableFiltering {
+ public:
+  /**
+   * @param[in] cutoff_frequency Cutoff frequency of the low-pass filter. Set to
+   * franka::kMaxCutoffFrequency to disable.
+   *
+   * @throw std::invalid_argument if cutoff_frequency is zero, negative, infinite or NaN.
+   */
+  ConfigurableFiltering(double cutoff_frequency)
+      : enabled_(cutoff_frequency < kMaxCutoffFrequency),
+        gain_(enabled_ ? lowpassFilterGain(kDeltaT, cutoff_frequency) : 1.0) {}
+
+  /// @return True if filtering is activated.
+  constexpr auto enabled() const noexcept -> bool { return enabled_; }
+
+  /// @return Filter gain.
+  constexpr auto gain() const noexcept -> double { return gain_; }
+
+ private:
+  bool enabled_;
+  double gain_;
+};
+
+/**
+ * @}
+ */
+
+/**
+ * Checks whether T is a rate limiting policy or a value a ConfigurableRateLimiting can be created
+ * from.
+ */
+template <typename T>
+struct IsRateLimitingPolicy
+    : std::integral_constant<bool,
+                             std::is_arithmetic<T>::value || std::is_same<T, RateLimiting>::value ||
+                                 std::is_same<T, NoRateLimiting>::value ||
+                                 std::is_same<T, ConfigurableRateLimiting>::value> {};
+
+/**
+ * Checks whether T is a filtering policy or a value a ConfigurableFiltering can be created from.
+ */
+template <typename T>
+struct IsFilteringPolicy
+    : std::integral_constant<bool,
+                             std::is_arithmetic<T>::value ||
+                                 std::is_same<T, LowpassFiltering>::value ||
+                                 std::is_same<T, NoFiltering>::value ||
+                                 std::is_same<T, ConfigurableFiltering>::value> {};
+
+/**
+ * Rate limiting policy for T, which is ConfigurableRateLimiting for plain values.
+ */
+template <typename T>
+using RateLimitingPolicy =
+    std::conditional_t<std::is_arithmetic<T>::value, ConfigurableRateLimiting, T>;
+
+/**
+ * Filtering policy for T, which is ConfigurableFiltering for plain values.
+ */
+template <typename T>
+using FilteringPolicy = std::conditional_t<std::is_arithmetic<T>::value, ConfigurableFiltering, T>;
+
+/**
+ * Part of a ControlLoop which does not depend on the type of the callbacks.
+ *
+ * Starts and finishes the motion, provides the steps to turn callback results into commands and
+ * exchanges them with the robot. It is compiled into the library for each motion generator type T.
+ *
+ * @tparam T Motion generator type, i.e. JointPositions, JointVelocities, CartesianPose or
+ * CartesianVelocities.
+ */
+template <typename T>
+class ControlLoopBase {
+ public:
+  /// @cond DO_NOT_DOCUMENT
+  ControlLoopBase(const ControlLoopBase&) = delete;
+  auto operator=(const ControlLoopBase&) -> ControlLoopBase& = delete;
+  /// @endcond
+
+ protected:
+  /**
+   * Applies the robot's RealtimeConfig to the current thread.
+   *
+   * @throw RealtimeException if a realtime setting cannot be applied and the robot enforces it.
+   */
+  explicit ControlLoopBase(RobotControl& robot);
+  ~ControlLoopBase() noexcept;
+
+  /**
+   * Starts a motion with an external controller, i.e. a control callback.
+   */
+  void startMotion();
+
+  /**
+   * Starts a motion with one of the robot's controllers.
+   *
+   * @throw std::invalid_argument if the controller mode is invalid.
+   */
+  void startMotion(ControllerMode controller_mode);
+
+  /**
+   * Sends the given commands and waits for the next robot state.
+   *
+   * @throw ControlException if the robot reports an error for the running motion.
+   */
+  auto update(const research_interface::robot::MotionGeneratorCommand* motion_command,
+              const research_interface::robot::ControllerCommand* control_command) -> RobotState;
+
+  /**
+   * Sends the given commands without waiting for the next robot state.
+   */
+  void send(const research_interface::robot::MotionGeneratorCommand* motion_command,
+            const research_interface::robot::ControllerCommand* control_command);
+
+  /**
+   * Waits for the next robot state after send.
+   *
+   * @throw ControlException if the robot reports an error for the running motion.
+   */
+  auto receive() -> RobotState;
+
+  /**
+   * Finishes the motion with the given last commands and waits until the robot has stopped.
+   */
+  void finishMotion(const research_interface::robot::MotionGeneratorCommand* motion_command,
+                    const research_interface::robot::ControllerCommand* control_command);
+
+  /**
+   * Cancels the motion after an error.
+   */
+  void cancelMotion() noexcept;
+
+  /**
+   * Writes the output of a motion generator callback into command.
+   */
+  static void copyMotion(const T& motion,
+                         research_interface::robot::MotionGeneratorCommand* command) noexcept;
+
+  /**
+   * Low-pass filters the motion in command with respect to the last commanded motion.
+   *
+   * @param[in] gain Filter gain as returned by lowpassFilterGain.
+   */
+  static void filterMotion(double gain,
+                           const RobotState& robot_state,
+                           research_interface::robot::MotionGeneratorCommand* command);
+
+  /**
+   * Limits the motion in command to the robot's velocity, acceleration and jerk limits.
+   */
+  static void limitMotion(const RobotState& robot_state,
+                          research_interface::robot::MotionGeneratorCommand* command);
+
+  /**
+   * Optionally low-pass filters the motion in command and then limits it to the robot's velocity,
+   * acceleration and jerk limits, like filterMotion followed by limitMotion.
+   *
+   * @param[in] filter True if the motion is filtered.
+   * @param[in] gain Filter gain as returned by lowpassFilterGain.
+   */
+  void filterAndLimitMotion(bool filter,
+                            double gain,
+                            const RobotState& robot_state,
+                            research_interface::robot::MotionGeneratorCommand* command);
+
+  /**
+   * @throw std::invalid_argument if the motion in command contains NaN, infinite or otherwise
+   * invalid values.
+   */
+  static void checkMotion(const research_interface::robot::MotionGeneratorCommand& command);
+
+  /**
+   * Writes the fallback of the watchdog for a motion generator callback into command.
+   *
+   * The fallback has to be limited with limitMotion afterwards, also if rate limiting is disabled.
+   */
+  void fallbackMotion(const RobotState& robot_state,
+                      research_interface::robot::MotionGeneratorCommand* command) const noexcept;
+
+  /**
+   * Writes the output of a control callback into command.
+   */
+  static void copyTorques(const Torques& torques,
+                          research_interface::robot::ControllerCommand* command) noexcept;
+
+  /**
+   * Low-pass filters the torques in command with respect to the last commanded torques.
+   *
+   * @param[in] gain Filter gain as returned by lowpassFilterGain.
+   */
+  static void filterTorques(double gain,
+                            const RobotState& robot_state,
+                            research_interface::robot::ControllerCommand* command) noexcept;
+
+  /**
+   * Limits the torques in command to the robot's torque rate limits.
+   */
+  static void limitTorques(const RobotState& robot_state,
+                           research_interface::robot::ControllerCommand* command);
+
+  /**
+   * Writes the fallback of the watchdog for a control callback into command.
+   *
+   * The fallback has to be limited with limitTorques afterwards, also if rate limiting is
+   * disabled.
+   */
+  void fallbackTorques(const RobotState& robot_state,
+                       research_interface::robot::ControllerCommand* command) const noexcept;
+
+  /**
+   * @throw std::invalid_argument if the torques in command contain NaN or infinite values.
+   */
+  static void checkTorques(const research_interface::robot::ControllerCommand& command);
+
+  /**
+   * @return Storage for the motion generator command of the current cycle.
+   */
+  auto motionCommand() noexcept -> research_interface::robot::MotionGeneratorCommand*;
+
+  /**
+   * @return Storage for the controller command of the current cycle.
+   */
+  auto controlCommand() noexcept -> research_interface::robot::ControllerCommand*;
+
+  /**
+   * @return Current time if the timing of the loop is recorded or the watchdog is enabled,
+   * otherwise a default time point without reading the clock.
+   */
+  auto timestamp() const noexcept -> std::chrono::steady_clock::time_point {
+    return timing_ != nullptr || watchdog_enabled_ ? std::chrono::steady_clock::now()
+                                                   : std::chrono::steady_clock::time_point();
+  }
+
+  /**
+   * Checks a callback invocation against the budget of the watchdog and counts it if it overran.
+   *
+   * @param[in] start Timestamp taken before the callback.
+   * @param[in] end Timestamp taken after the callback.
+   *
+   * @return True if the watchdog is enabled and the callback overran its budget.
+   */
+  auto missedDeadline(std::chrono::steady_clock::time_point start,
+                      std::chrono::steady_clock::time_point end) noexcept -> bool {
+    if (watchdog_enabled_ && end - start > watchdog_.budget) {
+      recordDeadlineMiss();
+      return true;
+    }
+    return false;
+  }
+
+  /**
+   * Records the duration of a phase if the timing of the loop is recorded.
+   *
+   * @param[in] phase Phase of the control loop.
+   * @param[in] start Timestamp taken at the start of the phase.
+   * @param[in] end Timestamp taken at the end of the phase.
+   */
+  void recordTiming(ControlLoopPhase phase,
+                    std::chrono::steady_clock::time_point start,
+                    std::chrono::steady_clock::time_point end) noexcept {
+    if (timing_ != nullptr) {
+      recordDuration(phase, end - start);
+    }
+  }
+
+ private:
+  struct Commands;
+
+  void recordDuration(ControlLoopPhase phase,
+                      std::chrono::steady_clock::duration duration) noexcept;
+  void recordDeadlineMiss() noexcept;
+
+  RobotControl& robot_;
+  ControlLoopTimingRecorder* const timing_;
+  const ControlLoopWatchdog watchdog_;
+  const bool watchdog_enabled_;
+  uint32_t motion_id_ = 0;
+  std::unique_ptr<Commands> commands_;
+};
+
+/**
+ * Runs a motion until one of the callbacks returns a command with `motion_finished` set.
+ *
+ * The loop is instantiated on the concrete types of the callbacks, so that callables given to the
+ * templated Robot::control overloads are invoked directly and can be inlined into the loop.
+ * Filtering and rate limiting are selected by policies. With NoFiltering and NoRateLimiting, the
+ * commands are only copied and checked, without any branches for the disabled steps.
+ *
+ * If enabled with Robot::setControlLoopTimingEnabled, the durations of the callbacks and of the
+ * command conversions are recorded in each cycle. If a ControlLoopWatchdog is set with
+ * Robot::setControlLoopWatchdog, results of callbacks which overran their budget are replaced by
+ * fallback commands.
+ *
+ * @tparam T Motion generator type.
+ * @tparam TMotionGeneratorCallback Type of the callable returning T.
+ * @tparam TControlCallback Type of the callable returning Torques.
+ * @tparam TRateLimiting RateLimiting, NoRateLimiting or ConfigurableRateLimiting.
+ * @tparam TFiltering LowpassFiltering, NoFiltering or ConfigurableFiltering.
+ */
+template <typename T,
+          typename TMotionGeneratorCallback = std::function<T(const RobotState&, franka::Duration)>,
+          typename TControlCallback = std::function<Torques(const RobotState&, franka::Duration)>,
+          typename TRateLimiting = ConfigurableRateLimiting,
+          typename TFiltering = ConfigurableFiltering>
+class ControlLoop : public ControlLoopBase<T> {
+ public:
+  using MotionGeneratorCallback = TMotionGeneratorCallback;
+  using ControlCallback = TControlCallback;
+
+  /**
+   * Starts a motion with an external controller.
+   *
+   * @throw std::invalid_argument if a callback is empty.
+   */
+  ControlLoop(RobotControl& robot,
+              ControlCallback control_callback,
+              MotionGeneratorCallback motion_callback,
+              TRateLimiting rate_limiting,
+              TFiltering filtering)
+      : ControlLoop(robot,
+                    std::move(motion_callback),
+                    std::move(control_callback),
+                    rate_limiting,
+                    filtering) {
+    if (!has_control_callback_) {
+      throw std::invalid_argument("libfranka: Invalid control callback given.");
+    }
+    if (isEmpty(motion_callback_)) {
+      throw std::invalid_argument("libfranka: Invalid motion callback given.");
+    }
+    this->startMotion();
+  }
+
+  /**
+   * Starts a motion with one of the robot's controllers.
+   *
+   * @throw std::invalid_argument if the callback is empty or the controller mode is invalid.
+   */
+  ControlLoop(RobotControl& robot,
+              ControllerMode controller_mode,
+              MotionGeneratorCallback motion_callback,
+              TRateLimiting rate_limiting,
+              TFiltering filtering)
+      : ControlLoop(robot, std::move(motion_callback), {}, rate_limiting, filtering) {
+    if (isEmpty(motion_callback_)) {
+      throw std::invalid_argument("libfranka: Invalid motion callback given.");
+    }
+    this->startMotion(controller_mode);
+  }
+
+  /**
+   * Runs the motion until it is finished.
+   */
+  void operator()();
+
+ protected:
+  ControlLoop(RobotControl& robot,
+              MotionGeneratorCallback motion_callback,
+              ControlCallback control_callback,
+              TRateLimiting rate_limiting,
+              TFiltering filtering)
+      : ControlLoopBase<T>(robot),
+        motion_callback_(std::move(motion_callback)),
+        control_callback_(std::move(control_callback)),
+        has_control_callback_(!isEmpty(control_callback_)),
+        rate_limiting_(rate_limiting),
+        filtering_(filtering) {}
+
+  auto spinControl(const RobotState& robot_state,
+                   franka::Duration time_step,
+                   research_interface::robot::ControllerCommand* command) -> bool;
+  auto spinMotion(const RobotState& robot_state,
+                  franka::Duration time_step,
+                  research_interface::robot::MotionGeneratorCommand* command) -> bool;
+
+ private:
+  static_assert(IsRateLimitingPolicy<TRateLimiting>::value &&
+                    !std::is_arithmetic<TRateLimiting>::value,
+                "TRateLimiting must be a rate limiting policy.");
+  static_assert(IsFilteringPolicy<TFiltering>::value && !std::is_arithmetic<TFiltering>::value,
+                "TFiltering must be a filtering policy.");
+
+  // Only std::function and function pointers can be empty.
+  template <typename Callback>
+  static auto isEmpty(const Callback& callback) -> bool {
+    if constexpr (std::is_constructible<bool, const Callback&>::value) {
+      return !static_cast<bool>(callback);
+    } else {
+      return false;
+    }
+  }
+
+  MotionGeneratorCallback motion_callback_;
+  ControlCallback control_callback_;
+  const bool has_control_callback_;
+  const TRateLimiting rate_limiting_;
+  const TFiltering filtering_;
+};
+
+template <typename T, typename TMotionGeneratorCallback, typename TControlCallback,
+          typename TRateLimiting, typename TFiltering>
+void ControlLoop<T, TMotionGeneratorCallback, TControlCallback, TRateLimiting, TFiltering>::
+operator()() try {
+  RobotState robot_state = this->update(nullptr, nullptr);
+
+  Duration previous_time = robot_state.time;
+
+  research_interface::robot::MotionGeneratorCommand* motion_command = this->motionCommand();
+  if (has_control_callback_) {
+    research_interface::robot::ControllerCommand* control_command = this->controlCommand();
+    while (spinMotion(robot_state, robot_state.time - previous_time, motion_command) &&
+           spinControl(robot_state, robot_state.time - previous_time, control_command)) {
+      previous_time = robot_state.time;
+      robot_state = this->update(motion_command, control_command);
+    }
+    this->finishMotion(motion_command, control_command);
+  } else {
+    while (spinMotion(robot_state, robot_state.time - previous_time, motion_command)) {
+      previous_time = robot_state.time;
+      robot_state = this->update(motion_command, nullptr);
+    }
+    this->finishMotion(motion_command, nullptr);
+  }
+} catch (...) {
+  this->cancelMotion();
+  throw;
+}
+
+template <typename T, typename TMotionGeneratorCallback, typename TControlCallback,
+          typename TRateLimiting, typename TFiltering>
+auto ControlLoop<T, TMotionGeneratorCallback, TControlCallback, TRateLimiting, TFiltering>::
+    spinControl(const RobotState& robot_state,
+                franka::Duration time_step,
+                research_interface::robot::ControllerCommand* command) -> bool {
+  auto start = this->timestamp();
+  Torques control_output = control_callback_(robot_state, time_step);
+  auto callback_end = this->timestamp();
+  bool fallback = this->missedDeadline(start, callback_end) && !control_output.motion_finished;
+  if (fallback) {
+    this->fallbackTorques(robot_state, command);
+  } else {
+    this->copyTorques(control_output, command);
+  }
+  if constexpr (!std::is_same<TFiltering, NoFiltering>::value) {
+    if (filtering_.enabled()) {
+      this->filterTorques(filtering_.gain(), robot_state, command);
+    }
+  }
+  bool limit = fallback;
+  if constexpr (!std::is_same<TRateLimiting, NoRateLimiting>::value) {
+    limit = limit || rate_limiting_.enabled();
+  }
+  if (limit) {
+    this->limitTorques(robot_state, command);
+  }
+  this->checkTorques(*command);
+  this->recordTiming(ControlLoopPhase::kControlCallback, start, callback_end);
+  this->recordTiming(ControlLoopPhase::kControlConversion, callback_end, this->timestamp());
+  return !control_output.motion_finished;
+}
+
+template <typename T, typename TMotionGeneratorCallback, typename TControlCallback,
+          typename TRateLimiting, typename TFiltering>
+auto ControlLoop<T, TMotionGeneratorCallback, TControlCallback, TRateLimiting, TFiltering>::
+    spinMotion(const RobotState& robot_state,
+               franka::Duration time_step,
+               research_interface::robot::MotionGeneratorCommand* command) -> bool {
+  auto start = this->timestamp();
+  T motion_output = motion_callback_(robot_state, time_step);
+  auto callback_end = this->timestamp();
+  bool fallback = this->missedDeadline(start, callback_end) && !motion_output.motion_finished;
+  if (fallback) {
+    this->fallbackMotion(robot_state, command);
+  } else {
+    this->copyMotion(motion_output, command);
+  }
+  bool filter = false;
+  if constexpr (!std::is_same<TFiltering, NoFiltering>::value) {
+    filter = filtering_.enabled();
+  }
+  bool limit = fallback;
+  if constexpr (!std::is_same<TRateLimiting, NoRateLimiting>::value) {
+    limit = limit || rate_limiting_.enabled();
+  }
+  if (limit) {
+    this->filterAndLimitMotion(filter, filtering_.gain(), robot_state, command);
+  } else if (filter) {
+    this->filterMotion(filtering_.gain(), robot_state, command);
+  }
+  this->checkMotion(*command);
+  this->recordTiming(ControlLoopPhase::kMotionCallback, start, callback_end);
+  this->recordTiming(ControlLoopPhase::kMotionConversion, callback_end, this->timestamp());
+  return !motion_output.motion_finished;
+}
+
+}  // namespace franka
@@ -0,0 +1,115 @@
+// Copyright (c) 2017 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+/**
+ * @file control_loop_timing.h
+ * Contains the franka::ControlLoopTiming type.
+ */
+
+namespace franka {
+
+/**
+ * Phases of a control loop cycle whose durations are recorded in ControlLoopTiming.
+ */
+enum class ControlLoopPhase {
+  /// Sending the commands and waiting for the next robot state.
+  kUpdate,
+  /// Checking the robot state for errors of the running motion.
+  kErrorCheck,
+  /// Calling the motion generator callback.
+  kMotionCallback,
+  /// Filtering, limiting and checking the motion generator command.
+  kMotionConversion,
+  /// Calling the control callback.
+  kControlCallback,
+  /// Filtering, limiting and checking the controller command.
+  kControlConversion
+};
+
+/**
+ * Durations of one phase of the control loop.
+ */
+struct PhaseTiming {
+  /**
+   * Number of histogram buckets.
+   */
+  static constexpr size_t kBuckets = 16;
+
+  /**
+   * Number of recorded durations.
+   */
+  uint64_t count{};
+
+  /**
+   * Sum of all recorded durations.
+   */
+  std::chrono::nanoseconds total{};
+
+  /**
+   * Longest recorded duration.
+   */
+  std::chrono::nanoseconds max{};
+
+  /**
+   * Histogram of the recorded durations on a logarithmic scale. Bucket 0 counts durations below
+   * 1 µs, bucket `i` durations in \f$[2^{i-1}, 2^i)\f$ µs. The last bucket also counts all longer
+   * durations.
+   */
+  std::array<uint64_t, kBuckets> histogram{};
+};
+
+/**
+ * Durations of the phases of all control loop cycles since recording has been enabled.
+ *
+ * @see Robot::setControlLoopTimingEnabled
+ * @see Robot::controlLoopTiming
+ */
+struct ControlLoopTiming {
+  /**
+   * @see ControlLoopPhase::kUpdate
+   */
+  PhaseTiming update;
+
+  /**
+   * @see ControlLoopPhase::kErrorCheck
+   */
+  PhaseTiming error_check;
+
+  /**
+   * @see ControlLoopPhase::kMotionCallback
+   */
+  PhaseTiming motion_callback;
+
+  /**
+   * @see ControlLoopPhase::kMotionConversion
+   */
+  PhaseTiming motion_conversion;
+
+  /**
+   * @see ControlLoopPhase::kControlCallback
+   */
+  PhaseTiming control_callback;
+
+  /**
+   * @see ControlLoopPhase::kControlConversion
+   */
+  PhaseTiming control_conversion;
+};
+
+/**
+ * Streams the control loop timing as JSON object.
+ *
+ * @param[in] ostream Ostream instance
+ * @param[in] timing ControlLoopTiming to stream.
+ *
+ * @return Ostream instance
+ */
+auto operator<<(std::ostream& ostream, const franka::ControlLoopTiming& timing) -> std::ostream&;
+
+}  // namespace franka
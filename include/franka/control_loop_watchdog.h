@@ -0,0 +1,77 @@
+// Copyright (c) 2017 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#pragma once
+
+#include <chrono>
+
+/**
+ * @file control_loop_watchdog.h
+ * Contains the franka::ControlLoopWatchdog type.
+ */
+
+namespace franka {
+
+/**
+ * Motion generator command sent instead of the result of a callback which overran its budget.
+ */
+enum class MotionFallback {
+  /**
+   * Stops at the last commanded position, i.e. commands the last desired joint positions or pose,
+   * or zero velocity for velocity motion generators. The motion decelerates within the rate
+   * limits, so it can take several overruns in a row to come to a stop.
+   */
+  kHoldPosition,
+  /**
+   * Continues with the last commanded velocity for one more cycle.
+   */
+  kExtrapolateVelocity
+};
+
+/**
+ * Controller command sent instead of the result of a control callback which overran its budget.
+ */
+enum class TorqueFallback {
+  /**
+   * Ramps the torques towards zero within the torque rate limits. The robot still compensates
+   * gravity on top of it.
+   */
+  kZeroTorque,
+  /**
+   * Repeats the last commanded torques.
+   */
+  kHoldTorque
+};
+
+/**
+ * Configuration of the deadline watchdog of control loops.
+ *
+ * The watchdog measures the duration of each callback invocation. If a callback takes longer than
+ * #budget, its result is computed from an outdated robot state. It is then replaced by a fallback
+ * command derived from the last desired values in the robot state. Callbacks cannot be
+ * interrupted, so the fallback is still sent late. Fallback commands are always limited to the
+ * robot's velocity, acceleration, jerk and torque rate limits, also if rate limiting is disabled
+ * for the loop, so that the motion stays continuous through overruns.
+ *
+ * Results which finish the motion are never replaced.
+ *
+ * @see Robot::setControlLoopWatchdog
+ * @see Robot::deadlineMisses
+ */
+struct ControlLoopWatchdog {
+  /**
+   * Maximum duration of a single callback invocation. Zero disables the watchdog.
+   */
+  std::chrono::microseconds budget{0};
+
+  /**
+   * Fallback for motion generator callbacks.
+   */
+  MotionFallback motion_fallback{MotionFallback::kHoldPosition};
+
+  /**
+   * Fallback for control callbacks.
+   */
+  TorqueFallback torque_fallback{TorqueFallback::kZeroTorque};
+};
+
+}  // namespace franka
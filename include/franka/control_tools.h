@@ -4,7 +4,11 @@
 
 #include <array>
 #include <cmath>
- #include <string>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <franka/realtime_config.h>
 
 /**
  * @file control_tools.h
@@ -74,4 +78,86 @@ auto hasRealtimeKernel() -> bool;
  */
 auto setCurrentThreadToHighestSchedulerPriority(std::string* error_message) -> bool;
 
+/**
+ * Sets the current thread to the given realtime scheduler priority.
+ *
+ * @param[in] priority `SCHED_FIFO` priority. Zero selects the highest possible priority.
+ * On Windows, the priority is ignored and the highest priority is always set.
+ * @param[out] error_message Contains an error message if the scheduler priority
+ * cannot be set successfully.
+ *
+ * @return True if successful, false otherwise.
+ */
+auto setCurrentThreadSchedulerPriority(int priority, std::string* error_message) -> bool;
+
+/**
+ * Restricts the current thread to the given CPUs. Only supported on Linux.
+ *
+ * @param[in] cpus CPUs the thread is allowed to run on.
+ * @param[out] error_message Contains an error message if the affinity cannot be set successfully.
+ *
+ * @return True if successful, false otherwise.
+ */
+auto setCurrentThreadAffinity(const std::vector<int>& cpus, std::string* error_message) -> bool;
+
+/**
+ * Parses a CPU list in the format of the Linux kernel, e.g. `0-2,5`.
+ *
+ * @param[in] cpu_list CPU list.
+ *
+ * @return CPUs in the list, in the given order.
+ *
+ * @throw std::invalid_argument if the list is malformed.
+ */
+auto parseCpuList(const std::string& cpu_list) -> std::vector<int>;
+
+/**
+ * Determines which CPUs are isolated from the scheduler, as listed in
+ * `/sys/devices/system/cpu/isolated`. Only supported on Linux.
+ *
+ * @return Isolated CPUs, or an empty list if there are none or they cannot be determined.
+ */
+auto isolatedCpus() -> std::vector<int>;
+
+/**
+ * Locks all current and future pages of the process in memory. Only supported on Linux.
+ *
+ * @param[out] error_message Contains an error message if the memory cannot be locked.
+ *
+ * @return True if successful, false otherwise.
+ */
+auto lockMemory(std::string* error_message) -> bool;
+
+/**
+ * Touches the given number of bytes of the current thread's stack, so that the loop running on it
+ * does not page fault. Does nothing on platforms other than Linux.
+ *
+ * @param[in] size Number of bytes. Must be smaller than the stack size of the thread.
+ */
+void prefaultStack(size_t size) noexcept;
+
+/**
+ * Touches the given number of bytes of heap and keeps them with the allocator after freeing them,
+ * so that later allocations do not page fault. Only supported on Linux.
+ *
+ * @param[in] size Number of bytes.
+ * @param[out] error_message Contains an error message if the heap cannot be prefaulted.
+ *
+ * @return True if successful, false otherwise.
+ */
+auto prefaultHeap(size_t size, std::string* error_message) -> bool;
+
+/**
+ * Applies the given realtime settings to the current thread and process.
+ *
+ * This is done by Robot::control before a control loop starts, and can be used to set up
+ * other threads in the same way.
+ *
+ * @param[in] config Realtime settings.
+ *
+ * @throw RealtimeException if RealtimeConfig::enforce is set and a setting cannot be applied or
+ * the kernel does not have realtime capabilities.
+ */
+void applyRealtimeConfig(const RealtimeConfig& config);
+
 }  // namespace franka
@@ -6,6 +6,8 @@
 #include <cmath>
 #include <initializer_list>
 
+#include <franka/realtime_config.h>
+
 /**
  * @file control_types.h
  * Contains helper types for returning motion generation and joint-level torque commands.
@@ -18,13 +20,6 @@ namespace franka {
  */
 enum class ControllerMode { kJointImpedance, kCartesianImpedance };
 
-/**
- * Used to decide whether to enforce realtime mode for a control loop thread.
- *
- * @see Robot::Robot
- */
-enum class RealtimeConfig { kEnforce, kIgnore };
-
 /**
  * Helper type for control and motion generation loops.
  *
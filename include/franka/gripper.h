@@ -3,10 +3,12 @@
 #pragma once
 
 #include <cstdint>
+#include <future>
 #include <memory>
 #include <string>
 
 #include <franka/gripper_state.h>
+#include <franka/network_config.h>
 #include <utility>
 
 /**
@@ -36,11 +38,14 @@ class Gripper {
    * Establishes a connection with a gripper connected to a robot.
    *
    * @param[in] franka_address IP/hostname of the robot the gripper is connected to.
+   * @param[in] network_config Socket settings for the connection.
    *
-   * @throw NetworkException if the connection is unsuccessful.
+   * @throw NetworkException if the connection is unsuccessful or the socket settings cannot be
+   * applied.
    * @throw IncompatibleVersionException if this version of `libfranka` is not supported.
    */
-  explicit Gripper(const std::string& franka_address);
+  explicit Gripper(const std::string& franka_address,
+                 const NetworkConfig& network_config = NetworkConfig());
 
   /**
    * Move-constructs a new Gripper instance.
@@ -78,6 +83,16 @@ class Gripper {
    */
   [[nodiscard]] auto homing() const -> bool;
 
+  /**
+   * Starts homing of the gripper without waiting for it to finish.
+   *
+   * @return Future which becomes ready once the gripper has answered. It holds true if the command
+   * was successful and false otherwise, or throws the exceptions listed for Gripper::homing.
+   *
+   * @see Gripper::homing
+   */
+  [[nodiscard]] auto homingAsync() const -> std::future<bool>;
+
   /**
    * Grasps an object.
    *
@@ -103,6 +118,28 @@ class Gripper {
              double epsilon_inner = 0.005,
              double epsilon_outer = 0.005) const -> bool;
 
+  /**
+   * Starts grasping an object without waiting for it to finish.
+   *
+   * @param[in] width Size of the object to grasp. [m]
+   * @param[in] speed Closing speed. [m/s]
+   * @param[in] force Grasping force. [N]
+   * @param[in] epsilon_inner Maximum tolerated deviation when the actual grasped width is smaller
+   * than the commanded grasp width.
+   * @param[in] epsilon_outer Maximum tolerated deviation when the actual grasped width is larger
+   * than the commanded grasp width.
+   *
+   * @return Future which becomes ready once the gripper has answered. It holds true if an object
+   * has been grasped and false otherwise, or throws the exceptions listed for Gripper::grasp.
+   *
+   * @see Gripper::grasp
+   */
+  [[nodiscard]] auto graspAsync(double width,
+                                double speed,
+                                double force,
+                                double epsilon_inner = 0.005,
+                                double epsilon_outer = 0.005) const -> std::future<bool>;
+
   /**
    * Moves the gripper fingers to a specified width.
    *
@@ -116,6 +153,19 @@ class Gripper {
    */
   [[nodiscard]] auto move(double width, double speed) const -> bool;
 
+  /**
+   * Starts moving the gripper fingers to a specified width without waiting for it to finish.
+   *
+   * @param[in] width Intended opening width. [m]
+   * @param[in] speed Closing speed. [m/s]
+   *
+   * @return Future which becomes ready once the gripper has answered. It holds true if the command
+   * was successful and false otherwise, or throws the exceptions listed for Gripper::move.
+   *
+   * @see Gripper::move
+   */
+  [[nodiscard]] auto moveAsync(double width, double speed) const -> std::future<bool>;
+
   /**
    * Stops a currently running gripper move or grasp.
    *
@@ -126,6 +176,16 @@ class Gripper {
    */
   [[nodiscard]] auto stop() const -> bool;
 
+  /**
+   * Requests stopping a currently running gripper move or grasp without waiting for the answer.
+   *
+   * @return Future which becomes ready once the gripper has answered. It holds true if the command
+   * was successful and false otherwise, or throws the exceptions listed for Gripper::stop.
+   *
+   * @see Gripper::stop
+   */
+  [[nodiscard]] auto stopAsync() const -> std::future<bool>;
+
   /**
    * Waits for a gripper state update and returns it.
    *
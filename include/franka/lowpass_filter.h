@@ -36,6 +36,34 @@ constexpr double kDefaultCutoffFrequency = 100.0;
  */
 auto lowpassFilter(double sample_time, double y, double y_last, double cutoff_frequency) -> double;
 
+/**
+ * Computes the gain of a first-order low-pass filter.
+ *
+ * @param[in] sample_time Sample time constant
+ * @param[in] cutoff_frequency Cutoff frequency of the low-pass filter
+ *
+ * @throw std::invalid_argument if cutoff_frequency is zero, negative, infinite or NaN.
+ * @throw std::invalid_argument if sample_time is negative, infinite or NaN.
+ *
+ * @return Filter gain, to be used with lowpassFilter(double, double, double).
+ */
+auto lowpassFilterGain(double sample_time, double cutoff_frequency) -> double;
+
+/**
+ * Applies a first-order low-pass filter with a precomputed gain.
+ *
+ * In contrast to lowpassFilter(double, double, double, double), the inputs are not validated.
+ *
+ * @param[in] gain Filter gain as returned by lowpassFilterGain
+ * @param[in] y Current value of the signal to be filtered
+ * @param[in] y_last Value of the signal to be filtered in the previous time step
+ *
+ * @return Filtered value.
+ */
+inline auto lowpassFilter(double gain, double y, double y_last) noexcept -> double {
+  return gain * y + (1.0 - gain) * y_last;
+}
+
 /**
  * Applies a first-order low-pass filter to the translation and spherical linear interpolation
  * to the rotation of a transformation matrix which represents a Cartesian Motion.
@@ -57,4 +85,21 @@ auto cartesianLowpassFilter(double sample_time,
                                               std::array<double, 16> y,
                                               std::array<double, 16> y_last,
                                               double cutoff_frequency) -> std::array<double, 16>;
+
+/**
+ * Applies a first-order low-pass filter with a precomputed gain to a transformation matrix which
+ * represents a Cartesian Motion.
+ *
+ * In contrast to cartesianLowpassFilter(double, std::array<double, 16>, std::array<double, 16>,
+ * double), the inputs are not validated.
+ *
+ * @param[in] gain Filter gain as returned by lowpassFilterGain
+ * @param[in] y Current Cartesian transformation matrix to be filtered
+ * @param[in] y_last Cartesian transformation matrix from the previous time step
+ *
+ * @return Filtered Cartesian transformation matrix.
+ */
+auto cartesianLowpassFilter(double gain,
+                            const std::array<double, 16>& y,
+                            const std::array<double, 16>& y_last) -> std::array<double, 16>;
 }  // namespace franka
@@ -0,0 +1,206 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+#include <franka/lowpass_filter.h>
+
+/**
+ * @file lowpass_filter_bank.h
+ * Contains the franka::LowpassFilterBank type.
+ */
+
+namespace franka {
+
+/**
+ * Stateful low-pass filter for N channels, e.g. the joints of `dq` or `tau_ext_hat_filtered`.
+ *
+ * The filter is a cascade of first-order and second-order (biquad) sections, whose coefficients
+ * are computed once on construction. All channels share the coefficients and are filtered together
+ * in each step, with the state of each section stored contiguously per channel, so the loops over
+ * the channels can be vectorized by the compiler. Unlike lowpassFilter, the inputs are not
+ * validated: a NaN or infinite input spreads to all later outputs of its channel until reset is
+ * called.
+ *
+ * Create one filter per signal before starting a control loop and call filter once per cycle, e.g.
+ * in the callback of Robot::control:
+ *
+ * @code{.cpp}
+ * auto dq_filter = franka::LowpassFilterBank<7>::butterworth(2, franka::kDeltaT, 30.0);
+ * robot.control([&](const franka::RobotState& state, franka::Duration) -> franka::Torques {
+ *   std::array<double, 7> dq = dq_filter.filter(state.dq);
+ *   ...
+ * });
+ * @endcode
+ *
+ * The first input after construction or reset is taken as steady state, i.e. the filter starts
+ * without a transient.
+ *
+ * @tparam N Number of channels.
+ */
+template <size_t N>
+class LowpassFilterBank {
+ public:
+  /**
+   * Maximum order of a Butterworth filter.
+   */
+  static constexpr size_t kMaxOrder = 8;
+
+  /**
+   * Creates a first-order low-pass filter, which filters like lowpassFilter with the same
+   * parameters.
+   *
+   * @param[in] sample_time Sample time constant.
+   * @param[in] cutoff_frequency Cutoff frequency of the low-pass filter.
+   *
+   * @throw std::invalid_argument if cutoff_frequency is zero, negative, infinite or NaN.
+   * @throw std::invalid_argument if sample_time is negative, infinite or NaN.
+   *
+   * @return Filter.
+   */
+  static auto firstOrder(double sample_time, double cutoff_frequency) -> LowpassFilterBank {
+    double gain = lowpassFilterGain(sample_time, cutoff_frequency);
+    LowpassFilterBank filter;
+    filter.addSection({gain, 0.0, 0.0, -(1.0 - gain), 0.0});
+    return filter;
+  }
+
+  /**
+   * Creates a Butterworth low-pass filter, discretized with the bilinear transform.
+   *
+   * The filter consists of order / 2 biquad sections, and a first-order section for odd orders.
+   *
+   * @param[in] order Order of the filter, from 1 to kMaxOrder.
+   * @param[in] sample_time Sample time constant.
+   * @param[in] cutoff_frequency Cutoff frequency of the low-pass filter, below half the sampling
+   * frequency.
+   *
+   * @throw std::invalid_argument if order is zero or greater than kMaxOrder.
+   * @throw std::invalid_argument if sample_time is zero, negative, infinite or NaN.
+   * @throw std::invalid_argument if cutoff_frequency is zero, negative, infinite, NaN or not below
+   * half the sampling frequency.
+   *
+   * @return Filter.
+   */
+  static auto butterworth(size_t order, double sample_time, double cutoff_frequency)
+      -> LowpassFilterBank {
+    if (order == 0 || order > kMaxOrder) {
+      throw std::invalid_argument("lowpass-filter: order must be between 1 and " +
+                                  std::to_string(kMaxOrder) + ".");
+    }
+    if (sample_time <= 0 || !std::isfinite(sample_time)) {
+      throw std::invalid_argument(
+          "lowpass-filter: sample_time is zero, negative, infinite or NaN.");
+    }
+    if (cutoff_frequency <= 0 || !std::isfinite(cutoff_frequency) ||
+        cutoff_frequency >= 0.5 / sample_time) {
+      throw std::invalid_argument(
+          "lowpass-filter: cutoff_frequency is zero, negative, infinite, NaN or not below half the "
+          "sampling frequency.");
+    }
+
+    // Prewarped cutoff frequency of the analog prototype.
+    double k = std::tan(M_PI * cutoff_frequency * sample_time);
+    LowpassFilterBank filter;
+    for (size_t i = 0; i < order / 2; i++) {
+      double q = 1.0 / (2.0 * std::sin(M_PI * static_cast<double>(2 * i + 1) /
+                                       static_cast<double>(2 * order)));
+      double norm = 1.0 / (1.0 + k / q + k * k);
+      double b0 = k * k * norm;
+      double a1 = 2.0 * (k * k - 1.0) * norm;
+      double a2 = (1.0 - k / q + k * k) * norm;
+      filter.addSection({b0, 2.0 * b0, b0, a1, a2});
+    }
+    if (order % 2 == 1) {
+      double b0 = k / (1.0 + k);
+      filter.addSection({b0, b0, 0.0, (k - 1.0) / (k + 1.0), 0.0});
+    }
+    return filter;
+  }
+
+  /**
+   * Filters one sample of all channels.
+   *
+   * @param[in] input Current values of the signals to be filtered.
+   *
+   * @return Filtered values.
+   */
+  auto filter(const std::array<double, N>& input) noexcept -> std::array<double, N> {
+    if (!initialized_) {
+      reset(input);
+    }
+    std::array<double, N> values = input;
+    for (size_t s = 0; s < section_count_; s++) {
+      const Section& section = sections_[s];
+      std::array<double, N>& z1 = z1_[s];
+      std::array<double, N>& z2 = z2_[s];
+      for (size_t i = 0; i < N; i++) {
+        double output = section.b0 * values[i] + z1[i];
+        z1[i] = section.b1 * values[i] - section.a1 * output + z2[i];
+        z2[i] = section.b2 * values[i] - section.a2 * output;
+        values[i] = output;
+      }
+    }
+    return values;
+  }
+
+  /**
+   * Sets the state as if all channels had been at the given values for a long time.
+   *
+   * @param[in] values Steady-state values.
+   */
+  void reset(const std::array<double, N>& values) noexcept {
+    for (size_t s = 0; s < section_count_; s++) {
+      const Section& section = sections_[s];
+      for (size_t i = 0; i < N; i++) {
+        z1_[s][i] = (1.0 - section.b0) * values[i];
+        z2_[s][i] = (section.b2 - section.a2) * values[i];
+      }
+    }
+    initialized_ = true;
+  }
+
+  /**
+   * Resets the state, so that the next input is taken as steady state.
+   */
+  void reset() noexcept { initialized_ = false; }
+
+  /// @return Order of the filter.
+  auto order() const noexcept -> size_t { return order_; }
+
+ private:
+  // Coefficients of y[n] = b0 x[n] + b1 x[n-1] + b2 x[n-2] - a1 y[n-1] - a2 y[n-2], with a unity
+  // gain at zero frequency.
+  struct Section {
+    double b0;
+    double b1;
+    double b2;
+    double a1;
+    double a2;
+  };
+
+  static constexpr size_t kMaxSections = (kMaxOrder + 1) / 2;
+
+  LowpassFilterBank() noexcept = default;
+
+  void addSection(const Section& section) noexcept {
+    sections_[section_count_++] = section;
+    order_ += section.a2 == 0.0 ? 1 : 2;
+  }
+
+  std::array<Section, kMaxSections> sections_{};
+  size_t section_count_{0};
+  size_t order_{0};
+
+  // State of the sections in transposed direct form II.
+  std::array<std::array<double, N>, kMaxSections> z1_{};
+  std::array<std::array<double, N>, kMaxSections> z2_{};
+  bool initialized_{false};
+};
+
+}  // namespace franka
@@ -0,0 +1,160 @@
+// Copyright (c) 2017 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <franka/control_types.h>
+#include <franka/duration.h>
+#include <franka/rate_limiting.h>
+#include <franka/robot_state.h>
+#include <franka/trajectory.h>
+
+/**
+ * @file motion_chain.h
+ * Contains the franka::MotionChain type.
+ */
+
+namespace franka {
+
+/**
+ * Sequence of motion segments which are executed as a single motion.
+ *
+ * Running motions one after another with separate calls to Robot::control finishes and starts a
+ * motion on the robot in between, which leaves the robot idle for many cycles. A chain instead
+ * runs all segments within one motion: when a segment returns a command with `motion_finished`
+ * set and another segment is queued, the command is sent without the flag and the next segment
+ * takes over in the following cycle. Only the last segment finishes the motion.
+ *
+ * Each segment is called like a callback of Robot::control, with a time step of zero in its first
+ * cycle. The first command of every segment after the first one is checked for continuity with the
+ * desired state of the robot, i.e. with `q_d`, `dq_d` and `ddq_d`: the velocity, acceleration and
+ * jerk implied by the transition must be within the limits in rate_limiting.h. The check is done
+ * before rate limiting and filtering.
+ *
+ * All segments share the controller mode and motion generator type of the motion. Segments can
+ * be queued while the chain is running, but only from the control thread, e.g. from within a
+ * segment.
+ *
+ * @tparam T JointPositions or JointVelocities.
+ *
+ * @see Robot::execute(MotionChain<T>&, ControllerMode, TRateLimiting, TFiltering)
+ */
+template <typename T>
+class MotionChain {
+ public:
+  static_assert(std::is_same<T, JointPositions>::value || std::is_same<T, JointVelocities>::value,
+                "T must be JointPositions or JointVelocities.");
+
+  /**
+   * Callback type of a segment.
+   */
+  using Callback = std::function<T(const RobotState&, Duration)>;
+
+  /**
+   * Appends a segment.
+   *
+   * @param[in] callback Callback of the segment.
+   *
+   * @return This chain.
+   *
+   * @throw std::invalid_argument if the callback is empty.
+   */
+  auto then(Callback callback) -> MotionChain& {
+    if (!callback) {
+      throw std::invalid_argument("libfranka: Invalid motion callback given.");
+    }
+    segments_.push_back(std::move(callback));
+    return *this;
+  }
+
+  /**
+   * Appends a segment which plays the given trajectory.
+   *
+   * @param[in] trajectory Trajectory of the segment. Has to outlive the chain.
+   *
+   * @return This chain.
+   *
+   * @throw std::invalid_argument if the trajectory is empty.
+   */
+  auto then(const Trajectory<T>& trajectory) -> MotionChain& {
+    if (trajectory.empty()) {
+      throw std::invalid_argument("libfranka: Empty trajectory given.");
+    }
+    return then(Callback(TrajectoryPlayer<T>(trajectory)));
+  }
+
+  /// @return Number of queued segments, including finished ones.
+  auto size() const noexcept -> size_t { return segments_.size(); }
+
+  /// @return True if no segment has been queued.
+  auto empty() const noexcept -> bool { return segments_.empty(); }
+
+  /// @return Index of the running segment.
+  auto currentSegment() const noexcept -> size_t { return current_; }
+
+  /**
+   * Calls the running segment and switches to the next segment if it has finished.
+   *
+   * @param[in] robot_state Current robot state.
+   * @param[in] time_step Time since the previous call.
+   *
+   * @return Command to send.
+   *
+   * @throw std::invalid_argument if the chain is empty or a transition between segments is not
+   * continuous.
+   */
+  auto operator()(const RobotState& robot_state, Duration time_step) -> T {
+    if (segments_.empty()) {
+      throw std::invalid_argument("libfranka: Empty motion chain given.");
+    }
+    bool first_cycle = switched_;
+    T command = segments_[current_](robot_state, first_cycle ? Duration() : time_step);
+    if (first_cycle) {
+      checkContinuity(command, robot_state);
+      switched_ = false;
+    }
+    if (command.motion_finished && current_ + 1 < segments_.size()) {
+      command.motion_finished = false;
+      current_++;
+      switched_ = true;
+    }
+    return command;
+  }
+
+ private:
+  static void checkContinuity(const T& command, const RobotState& robot_state) {
+    for (size_t i = 0; i < 7; i++) {
+      double velocity = 0.0;
+      if constexpr (std::is_same<T, JointPositions>::value) {
+        velocity = (command.q[i] - robot_state.q_d[i]) / kDeltaT;
+      } else {
+        velocity = command.dq[i];
+      }
+      double acceleration = (velocity - robot_state.dq_d[i]) / kDeltaT;
+      double jerk = (acceleration - robot_state.ddq_d[i]) / kDeltaT;
+      if (!(std::abs(velocity) <= kMaxJointVelocity[i] &&
+            std::abs(acceleration) <= kMaxJointAcceleration[i] &&
+            std::abs(jerk) <= kMaxJointJerk[i])) {
+        throw std::invalid_argument(
+            "libfranka: Discontinuous transition between chained motions in joint " +
+            std::to_string(i + 1) + ".");
+      }
+    }
+  }
+
+  // Segments are only appended, which keeps the running one in place.
+  std::deque<Callback> segments_;
+  size_t current_{0};
+  bool switched_{false};
+};
+
+}  // namespace franka
@@ -0,0 +1,307 @@
+// Copyright (c) 2017 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+
+#include <franka/control_loop.h>
+#include <franka/control_types.h>
+#include <franka/exception.h>
+#include <franka/robot_state.h>
+
+/**
+ * @file motion_session.h
+ * Contains the franka::MotionSession type.
+ */
+
+namespace franka {
+
+/**
+ * Motion which is stepped by the caller instead of running in a loop of its own.
+ *
+ * A session allows to integrate a robot into an external real-time executor, e.g. one which also
+ * services other devices. In each cycle, the executor calls waitForState to get the next robot
+ * state and then answers it with sendCommand, which sends the command without waiting for the
+ * next state. Both are called from the executor's thread, so no additional thread or context
+ * switch is involved. The motion ends with a command with `motion_finished` set.
+ *
+ * Commands are filtered, rate limited and checked like in Robot::control. The time between
+ * waitForState and sendCommand takes the role of the callbacks: it is recorded as
+ * ControlLoopPhase::kMotionCallback if timing is enabled, and is checked against the budget of
+ * the ControlLoopWatchdog.
+ *
+ * The session holds the robot's control lock, so no other control or read operation can run until
+ * it is destroyed. Destroying a session whose motion has not finished cancels the motion.
+ *
+ * @tparam T Motion generator type.
+ * @tparam TRateLimiting RateLimiting, NoRateLimiting or ConfigurableRateLimiting.
+ * @tparam TFiltering LowpassFiltering, NoFiltering or ConfigurableFiltering.
+ *
+ * @see Robot::startMotion
+ * @see Robot::startTorqueControl
+ */
+template <typename T,
+          typename TRateLimiting = ConfigurableRateLimiting,
+          typename TFiltering = ConfigurableFiltering>
+class MotionSession : public ControlLoopBase<T> {
+ public:
+  /**
+   * Starts a motion with one of the robot's controllers.
+   *
+   * @throw std::invalid_argument if the controller mode is invalid.
+   */
+  MotionSession(RobotControl& robot,
+                std::unique_lock<std::mutex> lock,
+                ControllerMode controller_mode,
+                TRateLimiting rate_limiting,
+                TFiltering filtering)
+      : MotionSession(robot, std::move(lock), false, rate_limiting, filtering) {
+    this->startMotion(controller_mode);
+  }
+
+  /**
+   * Starts a motion with an external controller, i.e. with joint-level torque commands.
+   */
+  MotionSession(RobotControl& robot,
+                std::unique_lock<std::mutex> lock,
+                TRateLimiting rate_limiting,
+                TFiltering filtering)
+      : MotionSession(robot, std::move(lock), true, rate_limiting, filtering) {
+    this->startMotion();
+  }
+
+  /**
+   * Cancels the motion if it has not finished.
+   */
+  ~MotionSession() noexcept {
+    if (!finished_) {
+      this->cancelMotion();
+    }
+  }
+
+  /**
+   * Waits for the next robot state, which has to be answered with sendCommand.
+   *
+   * @return Robot state. Stays valid until the next call to waitForState.
+   *
+   * @throw ControlException if the robot reports an error for the running motion. The motion is
+   * canceled.
+   * @throw InvalidOperationException if the motion has finished or the previous state has not
+   * been answered.
+   * @throw NetworkException if the connection is lost, e.g. after a timeout.
+   */
+  auto waitForState() -> const RobotState& {
+    if (finished_) {
+      throw InvalidOperationException("libfranka: Motion session has already finished.");
+    }
+    if (has_state_) {
+      throw InvalidOperationException(
+          "libfranka: Previous robot state has not been answered with a command.");
+    }
+    try {
+      robot_state_ = this->receive();
+    } catch (...) {
+      abort();
+      throw;
+    }
+    has_state_ = true;
+    state_time_ = this->timestamp();
+    return robot_state_;
+  }
+
+  /**
+   * Answers the last robot state with a motion generator command. Only for sessions with one of
+   * the robot's controllers.
+   *
+   * Returns right after sending, unless the command finishes the motion. Then, waits until the
+   * robot has stopped.
+   *
+   * @param[in] motion Motion generator command.
+   *
+   * @throw ControlException if an error occurred while finishing the motion.
+   * @throw InvalidOperationException if there is no state to answer or the session has an
+   * external controller.
+   * @throw std::invalid_argument if the command contains NaN or infinite values. The motion is
+   * canceled.
+   */
+  void sendCommand(const T& motion) {
+    checkCanSend(false);
+    step([&](std::chrono::steady_clock::time_point end) {
+      convertMotion(motion, this->missedDeadline(state_time_, end) && !motion.motion_finished);
+      return motion.motion_finished;
+    });
+  }
+
+  /**
+   * Answers the last robot state with a motion generator command and joint-level torques. Only for
+   * sessions with an external controller.
+   *
+   * Returns right after sending, unless one of the commands finishes the motion. Then, waits until
+   * the robot has stopped.
+   *
+   * @param[in] motion Motion generator command.
+   * @param[in] torques Joint-level torque command.
+   *
+   * @throw ControlException if an error occurred while finishing the motion.
+   * @throw InvalidOperationException if there is no state to answer or the session has no
+   * external controller.
+   * @throw std::invalid_argument if a command contains NaN or infinite values. The motion is
+   * canceled.
+   */
+  void sendCommand(const T& motion, const Torques& torques) {
+    checkCanSend(true);
+    step([&](std::chrono::steady_clock::time_point end) {
+      bool finished = motion.motion_finished || torques.motion_finished;
+      bool missed_deadline = this->missedDeadline(state_time_, end) && !finished;
+      convertMotion(motion, missed_deadline);
+      convertTorques(torques, missed_deadline);
+      return finished;
+    });
+  }
+
+  /**
+   * Answers the last robot state with joint-level torques, while commanding zero joint velocities.
+   * Only for sessions created by Robot::startTorqueControl.
+   *
+   * @param[in] torques Joint-level torque command.
+   *
+   * @throw ControlException if an error occurred while finishing the motion.
+   * @throw InvalidOperationException if there is no state to answer.
+   * @throw std::invalid_argument if the torques contain NaN or infinite values. The motion is
+   * canceled.
+   */
+  template <typename U = T, typename = std::enable_if_t<std::is_same<U, JointVelocities>::value>>
+  void sendCommand(const Torques& torques) {
+    sendCommand(JointVelocities(std::array<double, 7>{}), torques);
+  }
+
+  /**
+   * @return True if the motion has finished or has been canceled after an error.
+   */
+  auto finished() const noexcept -> bool { return finished_; }
+
+ private:
+  static_assert(IsRateLimitingPolicy<TRateLimiting>::value &&
+                    !std::is_arithmetic<TRateLimiting>::value,
+                "TRateLimiting must be a rate limiting policy.");
+  static_assert(IsFilteringPolicy<TFiltering>::value && !std::is_arithmetic<TFiltering>::value,
+                "TFiltering must be a filtering policy.");
+
+  MotionSession(RobotControl& robot,
+                std::unique_lock<std::mutex> lock,
+                bool has_control,
+                TRateLimiting rate_limiting,
+                TFiltering filtering)
+      : ControlLoopBase<T>(robot),
+        lock_(std::move(lock)),
+        has_control_(has_control),
+        rate_limiting_(rate_limiting),
+        filtering_(filtering) {}
+
+  void checkCanSend(bool with_torques) const {
+    if (finished_) {
+      throw InvalidOperationException("libfranka: Motion session has already finished.");
+    }
+    if (!has_state_) {
+      throw InvalidOperationException("libfranka: No robot state to answer, call waitForState.");
+    }
+    if (with_torques != has_control_) {
+      throw InvalidOperationException(
+          has_control_ ? "libfranka: Motion session requires torque commands."
+                       : "libfranka: Motion session does not accept torque commands.");
+    }
+  }
+
+  // Converts the commands with convert, which returns whether the motion is finished, and sends
+  // them.
+  template <typename Convert>
+  void step(Convert&& convert) {
+    has_state_ = false;
+    try {
+      auto end = this->timestamp();
+      bool finished = convert(end);
+      this->recordTiming(ControlLoopPhase::kMotionCallback, state_time_, end);
+      this->recordTiming(ControlLoopPhase::kMotionConversion, end, this->timestamp());
+
+      research_interface::robot::ControllerCommand* control_command =
+          has_control_ ? this->controlCommand() : nullptr;
+      if (finished) {
+        this->finishMotion(this->motionCommand(), control_command);
+        finished_ = true;
+      } else {
+        this->send(this->motionCommand(), control_command);
+      }
+    } catch (...) {
+      abort();
+      throw;
+    }
+  }
+
+  void convertMotion(const T& motion, bool missed_deadline) {
+    research_interface::robot::MotionGeneratorCommand* command = this->motionCommand();
+    if (missed_deadline) {
+      this->fallbackMotion(robot_state_, command);
+    } else {
+      this->copyMotion(motion, command);
+    }
+    bool filter = false;
+    if constexpr (!std::is_same<TFiltering, NoFiltering>::value) {
+      filter = filtering_.enabled();
+    }
+    bool limit = missed_deadline;
+    if constexpr (!std::is_same<TRateLimiting, NoRateLimiting>::value) {
+      limit = limit || rate_limiting_.enabled();
+    }
+    if (limit) {
+      this->filterAndLimitMotion(filter, filtering_.gain(), robot_state_, command);
+    } else if (filter) {
+      this->filterMotion(filtering_.gain(), robot_state_, command);
+    }
+    this->checkMotion(*command);
+  }
+
+  void convertTorques(const Torques& torques, bool missed_deadline) {
+    research_interface::robot::ControllerCommand* command = this->controlCommand();
+    if (missed_deadline) {
+      this->fallbackTorques(robot_state_, command);
+    } else {
+      this->copyTorques(torques, command);
+    }
+    if constexpr (!std::is_same<TFiltering, NoFiltering>::value) {
+      if (filtering_.enabled()) {
+        this->filterTorques(filtering_.gain(), robot_state_, command);
+      }
+    }
+    bool limit = missed_deadline;
+    if constexpr (!std::is_same<TRateLimiting, NoRateLimiting>::value) {
+      limit = limit || rate_limiting_.enabled();
+    }
+    if (limit) {
+      this->limitTorques(robot_state_, command);
+    }
+    this->checkTorques(*command);
+  }
+
+  void abort() noexcept {
+    if (!finished_) {
+      finished_ = true;
+      this->cancelMotion();
+    }
+  }
+
+  std::unique_lock<std::mutex> lock_;
+  const bool has_control_;
+  const TRateLimiting rate_limiting_;
+  const TFiltering filtering_;
+
+  RobotState robot_state_{};
+  std::chrono::steady_clock::time_point state_time_{};
+  bool has_state_{false};
+  bool finished_{false};
+};
+
+}  // namespace franka
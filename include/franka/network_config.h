@@ -0,0 +1,107 @@
+// Copyright (c) 2017 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include <franka/realtime_config.h>
+
+/**
+ * @file network_config.h
+ * Contains the franka::NetworkConfig type.
+ */
+
+namespace franka {
+
+/**
+ * Socket settings for the connection to the robot, gripper or vacuum gripper.
+ *
+ * The defaults match the behavior of libfranka without an explicit configuration. Settings which
+ * are left at zero or empty keep the operating system defaults.
+ *
+ * @see Robot::Robot
+ * @see Gripper::Gripper
+ * @see VacuumGripper::VacuumGripper
+ */
+struct NetworkConfig {
+  /**
+   * Timeout for establishing the connection and for TCP operations.
+   */
+  std::chrono::milliseconds tcp_timeout{std::chrono::seconds(60)};
+
+  /**
+   * Timeout for receiving a state over UDP.
+   */
+  std::chrono::milliseconds udp_timeout{std::chrono::seconds(1)};
+
+  /**
+   * Enables TCP keepalive probes on the command connection.
+   */
+  bool tcp_keepalive{true};
+
+  /**
+   * Idle time before the first TCP keepalive probe is sent, in \f$[s]\f$.
+   */
+  int tcp_keepalive_idle{1};
+
+  /**
+   * Number of unanswered TCP keepalive probes before the connection is considered lost.
+   */
+  int tcp_keepalive_count{3};
+
+  /**
+   * Interval between TCP keepalive probes, in \f$[s]\f$.
+   */
+  int tcp_keepalive_interval{1};
+
+  /**
+   * Time the kernel busy-polls the network device for new states before sleeping (`SO_BUSY_POLL`).
+   * Zero disables busy polling. Linux only.
+   */
+  std::chrono::microseconds udp_busy_poll{0};
+
+  /**
+   * Size of the UDP receive buffer in bytes (`SO_RCVBUF`). Zero keeps the system default.
+   */
+  int udp_receive_buffer_size{0};
+
+  /**
+   * Size of the UDP send buffer in bytes (`SO_SNDBUF`). Zero keeps the system default.
+   */
+  int udp_send_buffer_size{0};
+
+  /**
+   * Differentiated services code point (0 to 63) for outgoing packets (`IP_TOS`). Zero keeps the
+   * default priority.
+   */
+  uint8_t dscp{0};
+
+  /**
+   * Name of the network interface to send and receive states on (`SO_BINDTODEVICE`), e.g. a NIC
+   * dedicated to the robot. Empty for any interface. Linux only.
+   */
+  std::string network_interface{};
+
+  /**
+   * Local port for receiving states over UDP. Zero picks a free port.
+   */
+  uint16_t udp_port{0};
+
+  /**
+   * Sends and receives states and real-time commands on a dedicated I/O thread instead of the
+   * control thread. States and commands are handed over through lock-free queues, so that the
+   * control thread does not perform socket system calls and controllers can use more of the cycle.
+   * Costs one additional CPU, which should not be shared with the control thread.
+   */
+  bool udp_io_thread{false};
+
+  /**
+   * Realtime settings of the I/O thread, e.g. CPUs close to the interrupts of the network
+   * interface. Only used if #udp_io_thread is set.
+   */
+  RealtimeConfig udp_io_thread_realtime_config{};
+};
+
+}  // namespace franka
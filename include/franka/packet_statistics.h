@@ -0,0 +1,86 @@
+// Copyright (c) 2017 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+/**
+ * @file packet_statistics.h
+ * Contains the franka::PacketStatistics type.
+ */
+
+namespace franka {
+
+/**
+ * Statistics about the robot states received over UDP since the connection has been established.
+ *
+ * @see Robot::packetStatistics
+ */
+struct PacketStatistics {
+  /**
+   * Number of inter-arrival time histogram buckets.
+   */
+  static constexpr size_t kInterArrivalBuckets = 16;
+
+  /**
+   * Width of each inter-arrival time histogram bucket.
+   */
+  static constexpr std::chrono::microseconds kInterArrivalBucketWidth{250};
+
+  /**
+   * Total number of received states.
+   */
+  uint64_t received{};
+
+  /**
+   * Number of message IDs skipped when a state with a newer ID than any before arrived. States
+   * which arrive late are not subtracted, but counted in #out_of_order.
+   */
+  uint64_t message_id_gaps{};
+
+  /**
+   * Number of states which arrived after a state with a newer message ID.
+   */
+  uint64_t out_of_order{};
+
+  /**
+   * Number of states with a message ID which has already been received.
+   */
+  uint64_t duplicates{};
+
+  /**
+   * Number of states which have been drained from the socket without being used, because a newer
+   * state was queued behind them.
+   */
+  uint64_t stale{};
+
+  /**
+   * Largest number of stale states drained while reading a single state.
+   */
+  uint64_t max_stale_per_read{};
+
+  /**
+   * Histogram of the times between the arrival of consecutive states. Bucket `i` counts
+   * inter-arrival times in \f$[i, i + 1) \cdot\f$ #kInterArrivalBucketWidth, the last bucket also
+   * counts all longer times.
+   *
+   * Arrival times are taken by the kernel if supported, otherwise when a state is read.
+   */
+  std::array<uint64_t, kInterArrivalBuckets> inter_arrival_histogram{};
+};
+
+/**
+ * Streams the packet statistics as JSON object.
+ *
+ * @param[in] ostream Ostream instance
+ * @param[in] statistics PacketStatistics to stream.
+ *
+ * @return Ostream instance
+ */
+auto operator<<(std::ostream& ostream, const franka::PacketStatistics& statistics)
+    -> std::ostream&;
+
+}  // namespace franka
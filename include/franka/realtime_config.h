@@ -0,0 +1,76 @@
+// Copyright (c) 2017 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @file realtime_config.h
+ * Contains the franka::RealtimeConfig type.
+ */
+
+namespace franka {
+
+/**
+ * Realtime settings applied to the thread running a control loop before the loop starts.
+ *
+ * The defaults match the behavior of libfranka without an explicit configuration: the thread is
+ * scheduled with the highest `SCHED_FIFO` priority and nothing else is changed.
+ *
+ * @see Robot::Robot
+ * @see applyRealtimeConfig
+ */
+struct RealtimeConfig {
+  /**
+   * Throws if a setting cannot be applied or the kernel does not have realtime capabilities.
+   */
+  static const RealtimeConfig kEnforce;
+
+  /**
+   * Applies the default settings as far as possible, but never throws.
+   */
+  static const RealtimeConfig kIgnore;
+
+  /**
+   * If true, a RealtimeException is thrown if a setting cannot be applied or the kernel does not
+   * have realtime capabilities. Otherwise, failures are ignored.
+   */
+  bool enforce{true};
+
+  /**
+   * `SCHED_FIFO` priority of the control thread. Zero selects the highest possible priority.
+   */
+  int priority{0};
+
+  /**
+   * CPUs the control thread is allowed to run on. Empty keeps the current affinity. Linux only.
+   */
+  std::vector<int> cpus;
+
+  /**
+   * If true, all CPUs in #cpus have to be isolated from the scheduler, e.g. with the `isolcpus`
+   * kernel parameter. Linux only.
+   */
+  bool require_isolated_cpus{false};
+
+  /**
+   * Locks all current and future pages of the process in memory (`mlockall`), so that the control
+   * loop never waits for a page fault. Linux only.
+   */
+  bool lock_memory{false};
+
+  /**
+   * Number of bytes of the control thread's stack to touch before the loop starts. Must be smaller
+   * than the stack size of the thread. Linux only.
+   */
+  size_t prefault_stack_size{0};
+
+  /**
+   * Number of bytes of heap to touch before the loop starts. Freed heap memory is then kept by the
+   * allocator instead of being returned to the system. Linux only.
+   */
+  size_t prefault_heap_size{0};
+};
+
+}  // namespace franka
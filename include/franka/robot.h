@@ -3,15 +3,30 @@
 #pragma once
 
 #include <functional>
+#include <future>
 #include <memory>
 #include <mutex>
+#include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <utility>
 
 #include <franka/command_types.h>
+#include <franka/control_loop.h>
+#include <franka/control_loop_timing.h>
+#include <franka/control_loop_watchdog.h>
 #include <franka/control_types.h>
 #include <franka/duration.h>
 #include <franka/lowpass_filter.h>
+#include <franka/motion_chain.h>
+#include <franka/motion_session.h>
+#include <franka/network_config.h>
+#include <franka/packet_statistics.h>
+#include <franka/realtime_config.h>
 #include <franka/robot_state.h>
+#include <franka/shared_memory_channel.h>
+#include <franka/telemetry.h>
+#include <franka/trajectory.h>
 
 /**
  * @file robot.h
@@ -50,17 +65,45 @@ class Robot {
    * Establishes a connection with the robot.
    *
    * @param[in] franka_address IP/hostname of the robot.
-   * @param[in] realtime_config if set to Enforce, an exception will be thrown if realtime priority
-   * cannot be set when required. Setting realtime_config to Ignore disables this behavior.
+   * @param[in] realtime_config Realtime settings for the threads running control loops. With
+   * RealtimeConfig::kEnforce, an exception will be thrown if realtime priority cannot be set when
+   * required. RealtimeConfig::kIgnore disables this behavior.
    * @param[in] log_size sets how many last states should be kept for logging purposes.
    * The log is provided when a ControlException is thrown.
+   * @param[in] network_config Socket settings for the connection.
    *
-   * @throw NetworkException if the connection is unsuccessful.
+   * @throw NetworkException if the connection is unsuccessful or the socket settings cannot be
+   * applied.
    * @throw IncompatibleVersionException if this version of `libfranka` is not supported.
    */
   explicit Robot(const std::string& franka_address,
-                 RealtimeConfig realtime_config = RealtimeConfig::kEnforce,
-                 size_t log_size = 50);
+                 const RealtimeConfig& realtime_config = RealtimeConfig::kEnforce,
+                 size_t log_size = 50,
+                 const NetworkConfig& network_config = NetworkConfig());
+
+  /**
+   * Establishes a connection with a simulator or hardware-in-the-loop bridge over an in-process
+   * channel instead of the network.
+   *
+   * @param[in] channel Channel the simulator is serving the robot protocol on.
+   * @param[in] realtime_config Realtime settings for the threads running control loops. With
+   * RealtimeConfig::kEnforce, an exception will be thrown if realtime priority cannot be set when
+   * required. RealtimeConfig::kIgnore disables this behavior.
+   * @param[in] log_size sets how many last states should be kept for logging purposes.
+   * The log is provided when a ControlException is thrown.
+   * @param[in] network_config Timeouts for the connection. Only NetworkConfig::tcp_timeout,
+   * NetworkConfig::udp_timeout and the I/O thread settings apply to the channel, all socket
+   * settings are ignored.
+   *
+   * @throw NetworkException if the simulator does not answer the connection request within
+   * NetworkConfig::tcp_timeout or does not send a state within NetworkConfig::udp_timeout.
+   * @throw RealtimeException if the realtime settings cannot be applied to the I/O thread.
+   * @throw IncompatibleVersionException if this version of `libfranka` is not supported.
+   */
+  explicit Robot(SharedMemoryChannel& channel,
+                 const RealtimeConfig& realtime_config = RealtimeConfig::kEnforce,
+                 size_t log_size = 50,
+                 const NetworkConfig& network_config = NetworkConfig());
 
   /**
    * Move-constructs a new Robot instance.
@@ -380,10 +423,319 @@ class Robot {
                bool limit_rate = true,
                double cutoff_frequency = kDefaultCutoffFrequency);
 
+  /**
+   * Starts a control loop for sending joint-level torque commands.
+   *
+   * Takes any callable, e.g. a lambda, and runs it in a loop instantiated on its type. The callable
+   * is invoked directly instead of through a std::function, so it can be inlined and never
+   * allocates. Otherwise identical to control(std::function<Torques(const RobotState&,
+   * franka::Duration)>, bool, double).
+   *
+   * @param[in] control_callback Callable providing joint-level torque commands.
+   * @param[in] limit_rate True if rate limiting should be activated. True by default.
+   * This could distort your motion! Alternatively a rate limiting policy, e.g.
+   * franka::NoRateLimiting, to decide at compile time.
+   * @param[in] cutoff_frequency Cutoff frequency for a first order low-pass filter applied on
+   * the user commanded signal. Set to franka::kMaxCutoffFrequency to disable. Alternatively a
+   * filtering policy, e.g. franka::NoFiltering, to decide at compile time.
+   */
+  template <typename ControlCallback,
+            typename TRateLimiting = bool,
+            typename TFiltering = double,
+            typename = std::enable_if_t<
+                IsCallbackFor<ControlCallback, Torques(const RobotState&, Duration)>::value &&
+                IsRateLimitingPolicy<TRateLimiting>::value && IsFilteringPolicy<TFiltering>::value>>
+  void control(ControlCallback control_callback,
+               TRateLimiting limit_rate = true,
+               TFiltering cutoff_frequency = kDefaultCutoffFrequency) {
+    auto motion_generator_callback = [](const RobotState&, Duration) -> JointVelocities {
+      return {{0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0}};
+    };
+    std::unique_lock<std::mutex> l = lockForControl();
+    ControlLoop<JointVelocities, decltype(motion_generator_callback), ControlCallback,
+                RateLimitingPolicy<TRateLimiting>, FilteringPolicy<TFiltering>>
+        loop(robotControl(), std::move(control_callback), motion_generator_callback, limit_rate,
+             cutoff_frequency);
+    loop();
+  }
+
+  /**
+   * Starts a control loop for sending joint-level torque commands and motion generator commands.
+   *
+   * Takes any callables, e.g. lambdas, and runs them in a loop instantiated on their types.
+   * Otherwise identical to the corresponding overloads taking std::function.
+   *
+   * @param[in] control_callback Callable providing joint-level torque commands.
+   * @param[in] motion_generator_callback Callable returning JointPositions, JointVelocities,
+   * CartesianPose or CartesianVelocities.
+   * @param[in] limit_rate True if rate limiting should be activated. True by default.
+   * This could distort your motion! Alternatively a rate limiting policy, e.g.
+   * franka::NoRateLimiting, to decide at compile time.
+   * @param[in] cutoff_frequency Cutoff frequency for a first order low-pass filter applied on
+   * the user commanded signal. Set to franka::kMaxCutoffFrequency to disable. Alternatively a
+   * filtering policy, e.g. franka::NoFiltering, to decide at compile time.
+   */
+  template <
+      typename ControlCallback,
+      typename MotionGeneratorCallback,
+      typename TRateLimiting = bool,
+      typename TFiltering = double,
+      typename T = std::invoke_result_t<MotionGeneratorCallback&, const RobotState&, Duration>,
+      typename = std::enable_if_t<
+          IsCallbackFor<ControlCallback, Torques(const RobotState&, Duration)>::value &&
+          IsMotionGeneratorOutput<T>::value && IsRateLimitingPolicy<TRateLimiting>::value &&
+          IsFilteringPolicy<TFiltering>::value>>
+  void control(ControlCallback control_callback,
+               MotionGeneratorCallback motion_generator_callback,
+               TRateLimiting limit_rate = true,
+               TFiltering cutoff_frequency = kDefaultCutoffFrequency) {
+    std::unique_lock<std::mutex> l = lockForControl();
+    ControlLoop<T, MotionGeneratorCallback, ControlCallback, RateLimitingPolicy<TRateLimiting>,
+                FilteringPolicy<TFiltering>>
+        loop(robotControl(), std::move(control_callback), std::move(motion_generator_callback),
+             limit_rate, cutoff_frequency);
+    loop();
+  }
+
+  /**
+   * Starts a control loop for a motion generator with a given controller mode.
+   *
+   * Takes any callable, e.g. a lambda, and runs it in a loop instantiated on its type. Otherwise
+   * identical to the corresponding overloads taking std::function.
+   *
+   * @param[in] motion_generator_callback Callable returning JointPositions, JointVelocities,
+   * CartesianPose or CartesianVelocities.
+   * @param[in] controller_mode Controller to use to execute the motion.
+   * @param[in] limit_rate True if rate limiting should be activated. True by default.
+   * This could distort your motion! Alternatively a rate limiting policy, e.g.
+   * franka::NoRateLimiting, to decide at compile time.
+   * @param[in] cutoff_frequency Cutoff frequency for a first order low-pass filter applied on
+   * the user commanded signal. Set to franka::kMaxCutoffFrequency to disable. Alternatively a
+   * filtering policy, e.g. franka::NoFiltering, to decide at compile time.
+   */
+  template <
+      typename MotionGeneratorCallback,
+      typename TRateLimiting = bool,
+      typename TFiltering = double,
+      typename T = std::invoke_result_t<MotionGeneratorCallback&, const RobotState&, Duration>,
+      typename = std::enable_if_t<IsMotionGeneratorOutput<T>::value &&
+                                  IsRateLimitingPolicy<TRateLimiting>::value &&
+                                  IsFilteringPolicy<TFiltering>::value>>
+  void control(MotionGeneratorCallback motion_generator_callback,
+               ControllerMode controller_mode = ControllerMode::kJointImpedance,
+               TRateLimiting limit_rate = true,
+               TFiltering cutoff_frequency = kDefaultCutoffFrequency) {
+    std::unique_lock<std::mutex> l = lockForControl();
+    ControlLoop<T, MotionGeneratorCallback, std::function<Torques(const RobotState&, Duration)>,
+                RateLimitingPolicy<TRateLimiting>, FilteringPolicy<TFiltering>>
+        loop(robotControl(), controller_mode, std::move(motion_generator_callback), limit_rate,
+             cutoff_frequency);
+    loop();
+  }
+
   /**
    * @}
    */
 
+  /**
+   * Starts a motion generator with a given controller mode, which is stepped by the caller.
+   *
+   * Unlike control, returns as soon as the motion has started. The caller then alternates
+   * MotionSession::waitForState and MotionSession::sendCommand, e.g. from a real-time executor
+   * which also services other devices.
+   *
+   * Sets realtime priority for the current thread.
+   * Cannot be executed while another control or motion generator loop is active.
+   *
+   * @tparam T JointPositions, JointVelocities, CartesianPose or CartesianVelocities.
+   *
+   * @param[in] controller_mode Controller to use to execute the motion.
+   * @param[in] limit_rate True if rate limiting should be activated. True by default.
+   * This could distort your motion! Alternatively a rate limiting policy, e.g.
+   * franka::NoRateLimiting, to decide at compile time.
+   * @param[in] cutoff_frequency Cutoff frequency for a first order low-pass filter applied on
+   * the user commanded signal. Set to franka::kMaxCutoffFrequency to disable. Alternatively a
+   * filtering policy, e.g. franka::NoFiltering, to decide at compile time.
+   *
+   * @return Session of the running motion, which holds the control lock until it is destroyed.
+   *
+   * @throw ControlException if an error related to motion generation occurred.
+   * @throw InvalidOperationException if a conflicting operation is already running.
+   * @throw NetworkException if the connection is lost, e.g. after a timeout.
+   * @throw RealtimeException if realtime priority cannot be set for the current thread.
+   * @throw std::invalid_argument if the controller mode is invalid.
+   *
+   * @see Robot::Robot to change behavior if realtime priority cannot be set.
+   */
+  template <typename T,
+            typename TRateLimiting = bool,
+            typename TFiltering = double,
+            typename = std::enable_if_t<IsMotionGeneratorOutput<T>::value &&
+                                        IsRateLimitingPolicy<TRateLimiting>::value &&
+                                        IsFilteringPolicy<TFiltering>::value>>
+  auto startMotion(ControllerMode controller_mode = ControllerMode::kJointImpedance,
+                   TRateLimiting limit_rate = true,
+                   TFiltering cutoff_frequency = kDefaultCutoffFrequency)
+      -> MotionSession<T, RateLimitingPolicy<TRateLimiting>, FilteringPolicy<TFiltering>> {
+    return MotionSession<T, RateLimitingPolicy<TRateLimiting>, FilteringPolicy<TFiltering>>(
+        robotControl(), lockForControl(), controller_mode, limit_rate, cutoff_frequency);
+  }
+
+  /**
+   * Starts a motion with joint-level torque commands, which is stepped by the caller.
+   *
+   * Otherwise identical to startMotion. With the default motion generator type JointVelocities,
+   * the session accepts torques only and commands zero joint velocities.
+   *
+   * @tparam T JointPositions, JointVelocities, CartesianPose or CartesianVelocities.
+   *
+   * @param[in] limit_rate True if rate limiting should be activated. True by default.
+   * This could distort your motion! Alternatively a rate limiting policy, e.g.
+   * franka::NoRateLimiting, to decide at compile time.
+   * @param[in] cutoff_frequency Cutoff frequency for a first order low-pass filter applied on
+   * the user commanded signal. Set to franka::kMaxCutoffFrequency to disable. Alternatively a
+   * filtering policy, e.g. franka::NoFiltering, to decide at compile time.
+   *
+   * @return Session of the running motion, which holds the control lock until it is destroyed.
+   *
+   * @throw ControlException if an error related to torque control or motion generation occurred.
+   * @throw InvalidOperationException if a conflicting operation is already running.
+   * @throw NetworkException if the connection is lost, e.g. after a timeout.
+   * @throw RealtimeException if realtime priority cannot be set for the current thread.
+   *
+   * @see Robot::Robot to change behavior if realtime priority cannot be set.
+   */
+  template <typename T = JointVelocities,
+            typename TRateLimiting = bool,
+            typename TFiltering = double,
+            typename = std::enable_if_t<IsMotionGeneratorOutput<T>::value &&
+                                        IsRateLimitingPolicy<TRateLimiting>::value &&
+                                        IsFilteringPolicy<TFiltering>::value>>
+  auto startTorqueControl(TRateLimiting limit_rate = true,
+                          TFiltering cutoff_frequency = kDefaultCutoffFrequency)
+      -> MotionSession<T, RateLimitingPolicy<TRateLimiting>, FilteringPolicy<TFiltering>> {
+    return MotionSession<T, RateLimitingPolicy<TRateLimiting>, FilteringPolicy<TFiltering>>(
+        robotControl(), lockForControl(), limit_rate, cutoff_frequency);
+  }
+
+  /**
+   * Executes a preplanned motion with a given controller mode.
+   *
+   * Streams the samples of the trajectory to the robot in a control loop, without calling any user
+   * code per cycle. Otherwise identical to control(MotionGeneratorCallback, ControllerMode,
+   * TRateLimiting, TFiltering).
+   *
+   * @param[in] trajectory Samples of JointPositions, JointVelocities, CartesianPose or
+   * CartesianVelocities. Has to stay unchanged until the motion has finished.
+   * @param[in] controller_mode Controller to use to execute the motion.
+   * @param[in] limit_rate True if rate limiting should be activated. True by default.
+   * This could distort your motion! Alternatively a rate limiting policy, e.g.
+   * franka::NoRateLimiting, to decide at compile time.
+   * @param[in] cutoff_frequency Cutoff frequency for a first order low-pass filter applied on
+   * the samples. Set to franka::kMaxCutoffFrequency to disable. Alternatively a filtering policy,
+   * e.g. franka::NoFiltering, to decide at compile time.
+   *
+   * @throw ControlException if an error related to motion generation occurred.
+   * @throw InvalidOperationException if a conflicting operation is already running.
+   * @throw NetworkException if the connection is lost, e.g. after a timeout.
+   * @throw RealtimeException if realtime priority cannot be set for the current thread.
+   * @throw std::invalid_argument if the trajectory is empty or contains NaN or infinite values.
+   *
+   * @see Robot::Robot to change behavior if realtime priority cannot be set.
+   */
+  template <typename T,
+            typename TRateLimiting = bool,
+            typename TFiltering = double,
+            typename = std::enable_if_t<IsMotionGeneratorOutput<T>::value &&
+                                        IsRateLimitingPolicy<TRateLimiting>::value &&
+                                        IsFilteringPolicy<TFiltering>::value>>
+  void execute(const Trajectory<T>& trajectory,
+               ControllerMode controller_mode = ControllerMode::kJointImpedance,
+               TRateLimiting limit_rate = true,
+               TFiltering cutoff_frequency = kDefaultCutoffFrequency) {
+    if (trajectory.empty()) {
+      throw std::invalid_argument("libfranka: Empty trajectory given.");
+    }
+    control(TrajectoryPlayer<T>(trajectory), controller_mode, limit_rate, cutoff_frequency);
+  }
+
+  /**
+   * Executes preplanned joint-level torque commands.
+   *
+   * Streams the samples of the trajectory to the robot in a control loop, without calling any user
+   * code per cycle. Otherwise identical to control(ControlCallback, TRateLimiting, TFiltering).
+   *
+   * @param[in] trajectory Samples of joint-level torque commands. Has to stay unchanged until the
+   * motion has finished.
+   * @param[in] limit_rate True if rate limiting should be activated. True by default.
+   * This could distort your motion! Alternatively a rate limiting policy, e.g.
+   * franka::NoRateLimiting, to decide at compile time.
+   * @param[in] cutoff_frequency Cutoff frequency for a first order low-pass filter applied on
+   * the samples. Set to franka::kMaxCutoffFrequency to disable. Alternatively a filtering policy,
+   * e.g. franka::NoFiltering, to decide at compile time.
+   *
+   * @throw ControlException if an error related to torque control occurred.
+   * @throw InvalidOperationException if a conflicting operation is already running.
+   * @throw NetworkException if the connection is lost, e.g. after a timeout.
+   * @throw RealtimeException if realtime priority cannot be set for the current thread.
+   * @throw std::invalid_argument if the trajectory is empty or contains NaN or infinite values.
+   *
+   * @see Robot::Robot to change behavior if realtime priority cannot be set.
+   */
+  template <typename TRateLimiting = bool,
+            typename TFiltering = double,
+            typename = std::enable_if_t<IsRateLimitingPolicy<TRateLimiting>::value &&
+                                        IsFilteringPolicy<TFiltering>::value>>
+  void execute(const Trajectory<Torques>& trajectory,
+               TRateLimiting limit_rate = true,
+               TFiltering cutoff_frequency = kDefaultCutoffFrequency) {
+    if (trajectory.empty()) {
+      throw std::invalid_argument("libfranka: Empty trajectory given.");
+    }
+    control(TrajectoryPlayer<Torques>(trajectory), limit_rate, cutoff_frequency);
+  }
+
+  /**
+   * Executes a chain of motion segments as a single motion with a given controller mode.
+   *
+   * Switches from one segment to the next without finishing the motion in between, so the robot
+   * does not stop between the segments. Otherwise identical to control(MotionGeneratorCallback,
+   * ControllerMode, TRateLimiting, TFiltering).
+   *
+   * @param[in] chain Segments of JointPositions or JointVelocities. Segments can be appended from
+   * within the running segments.
+   * @param[in] controller_mode Controller to use to execute the motion.
+   * @param[in] limit_rate True if rate limiting should be activated. True by default.
+   * This could distort your motion! Alternatively a rate limiting policy, e.g.
+   * franka::NoRateLimiting, to decide at compile time.
+   * @param[in] cutoff_frequency Cutoff frequency for a first order low-pass filter applied on
+   * the user commanded signal. Set to franka::kMaxCutoffFrequency to disable. Alternatively a
+   * filtering policy, e.g. franka::NoFiltering, to decide at compile time.
+   *
+   * @throw ControlException if an error related to motion generation occurred.
+   * @throw InvalidOperationException if a conflicting operation is already running.
+   * @throw NetworkException if the connection is lost, e.g. after a timeout.
+   * @throw RealtimeException if realtime priority cannot be set for the current thread.
+   * @throw std::invalid_argument if the chain is empty, a transition between segments is not
+   * continuous or a command contains NaN or infinite values.
+   *
+   * @see Robot::Robot to change behavior if realtime priority cannot be set.
+   */
+  template <typename T,
+            typename TRateLimiting = bool,
+            typename TFiltering = double,
+            typename = std::enable_if_t<IsRateLimitingPolicy<TRateLimiting>::value &&
+                                        IsFilteringPolicy<TFiltering>::value>>
+  void execute(MotionChain<T>& chain,
+               ControllerMode controller_mode = ControllerMode::kJointImpedance,
+               TRateLimiting limit_rate = true,
+               TFiltering cutoff_frequency = kDefaultCutoffFrequency) {
+    if (chain.empty()) {
+      throw std::invalid_argument("libfranka: Empty motion chain given.");
+    }
+    control(std::ref(chain), controller_mode, limit_rate, cutoff_frequency);
+  }
+
   /**
    * Starts a loop for reading the current robot state.
    *
@@ -635,6 +987,40 @@ class Robot {
       double cartesian_position_filter_frequency,
       double cartesian_velocity_filter_frequency,
       double controller_filter_frequency);
+
+  /**
+   * Applies several configuration commands at once.
+   *
+   * All requests are sent back-to-back before any response is awaited, so that the whole set
+   * costs about one network round trip instead of one per command. Every response is collected,
+   * even if some commands fail.
+   *
+   * @param[in] configuration Parameters to change. Parameters which are not given are left
+   * unchanged.
+   *
+   * @throw CommandException if the Control reports an error for one or more commands. The message
+   * lists the error of each failed command.
+   * @throw NetworkException if the connection is lost, e.g. after a timeout.
+   *
+   * @see RobotConfiguration
+   */
+  void configure(const RobotConfiguration& configuration);
+
+  /**
+   * Applies several configuration commands at once without waiting for the responses.
+   *
+   * @param[in] configuration Parameters to change. Parameters which are not given are left
+   * unchanged.
+   *
+   * @return Future which becomes ready once every command has been answered. It throws the
+   * exceptions listed for Robot::configure.
+   *
+   * @throw NetworkException if the requests could not be sent.
+   *
+   * @see Robot::configure
+   */
+  auto configureAsync(const RobotConfiguration& configuration) -> std::future<void>;
+
   /**
    * Runs automatic error recovery on the robot.
    *
@@ -645,6 +1031,16 @@ class Robot {
    */
   void automaticErrorRecovery();
 
+  /**
+   * Starts automatic error recovery on the robot without waiting for it to finish.
+   *
+   * @return Future which becomes ready once the Control has answered. It throws the exceptions
+   * listed for Robot::automaticErrorRecovery.
+   *
+   * @throw NetworkException if the request could not be sent.
+   */
+  auto automaticErrorRecoveryAsync() -> std::future<void>;
+
   /**
    * Stops all currently running motions.
    *
@@ -656,6 +1052,16 @@ class Robot {
    */
   void stop();
 
+  /**
+   * Requests stopping all currently running motions without waiting for the answer.
+   *
+   * @return Future which becomes ready once the Control has answered. It throws the exceptions
+   * listed for Robot::stop.
+   *
+   * @throw NetworkException if the request could not be sent.
+   */
+  auto stopAsync() -> std::future<void>;
+
   /**
    * @}
    */
@@ -677,6 +1083,97 @@ class Robot {
    */
   [[nodiscard]] auto serverVersion() const noexcept -> ServerVersion;
 
+  /**
+   * Returns statistics about the robot states received since the connection has been established.
+   *
+   * Unlike the other members, this method does not block and can be called from another thread
+   * while a control loop is running, e.g. for continuous monitoring.
+   *
+   * @return Current packet statistics.
+   */
+  [[nodiscard]] auto packetStatistics() const noexcept -> PacketStatistics;
+
+  /**
+   * Enables or disables recording the durations of the phases of each control loop cycle.
+   *
+   * Takes effect for control loops started afterwards. Disabled by default, in which case the
+   * clock is not read in the loop.
+   *
+   * @param[in] enabled True to record ControlLoopTiming.
+   *
+   * @see controlLoopTiming
+   */
+  void setControlLoopTimingEnabled(bool enabled) noexcept;
+
+  /**
+   * Returns the durations of the phases of all control loop cycles recorded so far.
+   *
+   * Like packetStatistics, this method does not block and can be called from another thread
+   * while a control loop is running.
+   *
+   * @return Current control loop timing.
+   *
+   * @see setControlLoopTimingEnabled
+   */
+  [[nodiscard]] auto controlLoopTiming() const noexcept -> ControlLoopTiming;
+
+  /**
+   * Sets the deadline watchdog for control loops started afterwards.
+   *
+   * Results of callbacks which take longer than the budget are replaced by a fallback command, see
+   * ControlLoopWatchdog. Disabled by default.
+   *
+   * @param[in] watchdog Watchdog configuration. A budget of zero disables the watchdog.
+   *
+   * @throw InvalidOperationException if a control or read operation is running.
+   * @throw std::invalid_argument if the budget is negative.
+   *
+   * @see deadlineMisses
+   */
+  void setControlLoopWatchdog(const ControlLoopWatchdog& watchdog);
+
+  /**
+   * Returns the number of callback invocations which overran the budget of the watchdog since the
+   * connection has been established.
+   *
+   * This method does not block and can be called from another thread while a control loop is
+   * running.
+   *
+   * @return Number of deadline misses.
+   */
+  [[nodiscard]] auto deadlineMisses() const noexcept -> uint64_t;
+
+  /**
+   * Starts streaming every received robot state, together with the command sent before it, into a
+   * binary file, e.g. for recording whole sessions.
+   *
+   * States received in control and read loops are queued without blocking and written to the file
+   * by a background thread, so recording does not lengthen the control loop cycle. States are
+   * dropped if the background thread falls behind by several seconds. Unlike the log of a
+   * ControlException, the recording is not limited in length. Use TelemetryReader to read the
+   * file.
+   *
+   * @param[in] path Path of the file, which is overwritten if it exists.
+   *
+   * @throw Exception if the file cannot be created.
+   * @throw InvalidOperationException if a control or read operation is running, or if a recording
+   * has already been started.
+   *
+   * @see stopTelemetryRecording
+   */
+  void startTelemetryRecording(const std::string& path);
+
+  /**
+   * Stops the recording started with startTelemetryRecording, after writing all remaining states.
+   *
+   * @return Numbers of recorded and dropped states.
+   *
+   * @throw Exception if writing the file failed.
+   * @throw InvalidOperationException if a control or read operation is running, or if no
+   * recording has been started.
+   */
+  auto stopTelemetryRecording() -> TelemetryStatistics;
+
   /// @cond DO_NOT_DOCUMENT
   Robot(const Robot&) = delete;
   auto operator=(const Robot&) -> Robot& = delete;
@@ -685,6 +1182,13 @@ class Robot {
   class Impl;
 
  private:
+  /**
+   * @throw InvalidOperationException if a conflicting operation is already running.
+   */
+  auto lockForControl() -> std::unique_lock<std::mutex>;
+
+  auto robotControl() noexcept -> RobotControl&;
+
   std::unique_ptr<Impl> impl_;
   std::mutex control_mutex_;
 };
@@ -6,6 +6,7 @@
 #include <franka/errors.h>
 
 #include <array>
+#include <chrono>
 #include <ostream>
 
 /**
@@ -340,6 +341,36 @@ struct RobotState {
    * instead.
    */
   Duration time{};
+
+  /**
+   * Host time at which the packet carrying this state has been received.
+   *
+   * On Linux, this is the kernel receive timestamp of the packet; elsewhere, the time at which
+   * libfranka read it from the socket.
+   */
+  std::chrono::system_clock::time_point host_receive_time{};
+
+  /**
+   * Time the packet carrying this state spent on the host before libfranka picked it up, i.e.
+   * from RobotState::host_receive_time until it was handed out.
+   */
+  std::chrono::nanoseconds host_receive_latency{};
+
+  /**
+   * Host time at which the command computed from the previous state has been sent.
+   *
+   * Zero if no command has been sent, e.g. outside of control loops.
+   */
+  std::chrono::system_clock::time_point host_command_send_time{};
+
+  /**
+   * Time from receiving the previous state until sending the command computed from it, i.e.
+   * RobotState::host_command_send_time minus the RobotState::host_receive_time of the previous
+   * state. Covers the time spent in libfranka and in the user's control callback.
+   *
+   * Zero if no command has been sent.
+   */
+  std::chrono::nanoseconds host_command_turnaround{};
 };
 
 /**
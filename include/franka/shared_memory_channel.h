@@ -0,0 +1,112 @@
+// Copyright (c) 2017 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+
+/**
+ * @file shared_memory_channel.h
+ * Contains the franka::SharedMemoryChannel type.
+ */
+
+namespace franka {
+
+class Robot;
+
+/**
+ * In-process connection between a Robot and a local simulator or hardware-in-the-loop bridge,
+ * which bypasses the network stack.
+ *
+ * The channel replaces the TCP connection for commands and the UDP connection for states and
+ * real-time commands with queues in shared memory. The simulator speaks the same protocol as the
+ * robot, using the methods of this class to exchange raw messages. States and real-time commands
+ * are passed through lock-free queues, so that a state sent by the simulator can be picked up by
+ * the control loop within microseconds.
+ *
+ * As with UDP, states and real-time commands are dropped if the receiving side does not keep up.
+ *
+ * @note
+ * sendState and receiveCommand must only be called from one simulator thread each.
+ *
+ * @see Robot::Robot(SharedMemoryChannel&, RealtimeConfig, size_t, const NetworkConfig&)
+ */
+class SharedMemoryChannel {
+ public:
+  /**
+   * Maximum size of a state or real-time command in bytes.
+   */
+  static constexpr size_t kMaxDatagramSize = 8192;
+
+  /**
+   * Number of states or real-time commands which can be queued in each direction.
+   */
+  static constexpr size_t kDatagramQueueCapacity = 64;
+
+  /**
+   * Creates a new channel.
+   */
+  SharedMemoryChannel();
+  ~SharedMemoryChannel() noexcept;
+
+  /**
+   * Sends a state to the robot side.
+   *
+   * @param[in] data State message.
+   * @param[in] size Size of the state message in bytes, at most #kMaxDatagramSize.
+   *
+   * @return False if the state has been dropped because the queue is full.
+   */
+  auto sendState(const void* data, size_t size) -> bool;
+
+  /**
+   * Waits for a real-time command from the robot side.
+   *
+   * @param[out] data Storage for the command message.
+   * @param[in] size Size of data in bytes.
+   * @param[in] timeout Maximum time to wait.
+   *
+   * @return Size of the received command message, or zero after the timeout.
+   */
+  auto receiveCommand(void* data, size_t size, std::chrono::microseconds timeout) -> size_t;
+
+  /**
+   * Waits until the given number of bytes has been sent on the command connection by the robot
+   * side, e.g. a request header.
+   *
+   * @param[out] data Storage for the bytes.
+   * @param[in] size Number of bytes to receive.
+   * @param[in] timeout Maximum time to wait.
+   *
+   * @return False after the timeout or if the robot side has closed the connection.
+   */
+  auto receiveRequest(void* data, size_t size, std::chrono::microseconds timeout) -> bool;
+
+  /**
+   * Sends bytes on the command connection to the robot side, e.g. a response message.
+   *
+   * @param[in] data Bytes to send.
+   * @param[in] size Number of bytes to send.
+   */
+  void sendResponse(const void* data, size_t size);
+
+  /**
+   * Closes the command connection, as if the robot had closed its TCP connection.
+   */
+  void close();
+
+  /// @cond DO_NOT_DOCUMENT
+  SharedMemoryChannel(const SharedMemoryChannel&) = delete;
+  auto operator=(const SharedMemoryChannel&) -> SharedMemoryChannel& = delete;
+  /// @endcond
+
+  class Impl;
+
+ private:
+  friend class Robot;
+
+  std::shared_ptr<Impl> impl_;
+};
+
+}  // namespace franka
@@ -0,0 +1,78 @@
+// Copyright (c) 2017 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <franka/log.h>
+
+/**
+ * @file telemetry.h
+ * Contains types for reading telemetry recorded with Robot::startTelemetryRecording.
+ */
+
+namespace franka {
+
+/**
+ * Numbers of robot states handed to a telemetry recording.
+ */
+struct TelemetryStatistics {
+  /**
+   * Number of states written to the file, each with the command answering the previous state.
+   */
+  uint64_t recorded{0};
+
+  /**
+   * Number of states which have not been written, because the writer thread fell behind.
+   */
+  uint64_t dropped{0};
+};
+
+/**
+ * Reads a file written by Robot::startTelemetryRecording record by record.
+ *
+ * The file starts with a header holding a magic number, the research interface version and the
+ * sizes of the recorded robot states and commands. Every record holds the host timestamps of a
+ * state followed by the state and the command as exchanged with the robot, in the byte order of
+ * the recording host. Files can therefore only be read by a library using the same research
+ * interface version.
+ */
+class TelemetryReader {
+ public:
+  /**
+   * Opens a telemetry file and reads its header.
+   *
+   * @param[in] path Path of the file.
+   *
+   * @throw Exception if the file cannot be opened or is not a telemetry file.
+   * @throw IncompatibleVersionException if the file has been recorded with a different research
+   * interface version.
+   */
+  explicit TelemetryReader(const std::string& path);
+  ~TelemetryReader() noexcept;
+
+  /**
+   * Reads the next record.
+   *
+   * @param[out] record Robot state and the command sent before it, like in the log of a
+   * ControlException.
+   *
+   * @return False at the end of the file.
+   *
+   * @throw Exception if the file ends within a record or cannot be read.
+   */
+  auto read(Record* record) -> bool;
+
+  /// @cond DO_NOT_DOCUMENT
+  TelemetryReader(const TelemetryReader&) = delete;
+  auto operator=(const TelemetryReader&) -> TelemetryReader& = delete;
+  /// @endcond
+
+ private:
+  class Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace franka
@@ -0,0 +1,122 @@
+// Copyright (c) 2017 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <franka/control_loop.h>
+#include <franka/control_types.h>
+#include <franka/duration.h>
+#include <franka/robot_state.h>
+
+/**
+ * @file trajectory.h
+ * Contains the franka::Trajectory type for preplanned motions.
+ */
+
+namespace franka {
+
+/**
+ * Preplanned motion, stored as contiguous samples with a spacing of one control cycle (1 ms).
+ *
+ * Executed with Robot::execute, which streams the samples to the robot without any user code
+ * running in the control loop. Sample `i` is commanded at \f$i\f$ ms after the motion started. The
+ * motion finishes with the last sample, or with the first sample which has `motion_finished` set.
+ *
+ * @tparam T JointPositions, JointVelocities, CartesianPose, CartesianVelocities or Torques.
+ */
+template <typename T>
+class Trajectory {
+ public:
+  static_assert(IsMotionGeneratorOutput<T>::value || std::is_same<T, Torques>::value,
+                "T must be a motion generator type or Torques.");
+
+  /**
+   * Creates an empty trajectory.
+   */
+  Trajectory() = default;
+
+  /**
+   * Creates a trajectory from the given samples.
+   *
+   * @param[in] samples Samples with a spacing of 1 ms.
+   */
+  explicit Trajectory(std::vector<T> samples) noexcept : samples_(std::move(samples)) {}
+
+  /**
+   * Preallocates storage for the given number of samples.
+   */
+  void reserve(size_t count) { samples_.reserve(count); }
+
+  /**
+   * Appends a sample, 1 ms after the previous one.
+   */
+  void add(const T& sample) { samples_.push_back(sample); }
+
+  /// @return Number of samples.
+  auto size() const noexcept -> size_t { return samples_.size(); }
+
+  /// @return True if the trajectory has no samples.
+  auto empty() const noexcept -> bool { return samples_.empty(); }
+
+  /// @return Sample at the given index.
+  auto operator[](size_t index) const noexcept -> const T& { return samples_[index]; }
+
+  /// @return Pointer to the contiguous samples.
+  auto data() const noexcept -> const T* { return samples_.data(); }
+
+  /// @return Time from the first to the last sample.
+  auto duration() const noexcept -> Duration {
+    return Duration(samples_.empty() ? 0 : samples_.size() - 1);
+  }
+
+ private:
+  std::vector<T> samples_;
+};
+
+/**
+ * Callback for a ControlLoop which returns the samples of a Trajectory.
+ *
+ * The sample is selected by the time since the motion started, so that a lost robot state skips
+ * the samples which were due in the meantime instead of delaying the rest of the trajectory. The
+ * last sample is returned with `motion_finished` set.
+ *
+ * The trajectory has to outlive the player and must not be empty.
+ *
+ * @tparam T JointPositions, JointVelocities, CartesianPose, CartesianVelocities or Torques.
+ */
+template <typename T>
+class TrajectoryPlayer {
+ public:
+  /**
+   * @param[in] trajectory Trajectory to play. Must not be empty.
+   */
+  explicit TrajectoryPlayer(const Trajectory<T>& trajectory) noexcept
+      : samples_(trajectory.data()), last_(trajectory.size() - 1) {}
+
+  /**
+   * @param[in] time_step Time since the previous call.
+   *
+   * @return Sample which is due.
+   */
+  auto operator()(const RobotState& /* robot_state */, Duration time_step) noexcept -> T {
+    index_ = std::min<size_t>(index_ + time_step.toMSec(), last_);
+    T sample = samples_[index_];
+    if (index_ == last_) {
+      sample.motion_finished = true;
+    }
+    return sample;
+  }
+
+ private:
+  const T* samples_;
+  size_t last_;
+  size_t index_{0};
+};
+
+}  // namespace franka
@@ -0,0 +1,122 @@
+// Copyright (c) 2017 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <franka/control_types.h>
+#include <franka/trajectory.h>
+
+/**
+ * @file trajectory_validation.h
+ * Contains functions for checking preplanned motions offline, before sending them to the robot.
+ */
+
+namespace franka {
+
+/**
+ * Reasons why a sample of a trajectory would be rejected or changed by a control loop.
+ */
+enum class TrajectoryViolationType {
+  /// The sample contains NaN or infinite values.
+  kNotFinite,
+  /// The pose of the sample is not a homogeneous transformation.
+  kInvalidTransformation,
+  /// The elbow of the sample has an invalid sign for the 4th joint.
+  kInvalidElbow,
+  /// Rate limiting changes the sample, as its velocity exceeds the limit.
+  kVelocityLimit,
+  /// Rate limiting changes the sample, as its acceleration exceeds the limit.
+  kAccelerationLimit,
+  /// Rate limiting changes the sample, as its jerk exceeds the limit.
+  kJerkLimit,
+  /// Rate limiting changes the sample without a limit being exceeded, e.g. to keep enough margin
+  /// for braking before the velocity limit.
+  kRateLimited
+};
+
+/**
+ * Violation found in a trajectory.
+ */
+struct TrajectoryViolation {
+  /// Index of the sample.
+  size_t sample{0};
+  /**
+   * Part of the sample. The joint for joint motions. For Cartesian motions, 0 for the translation
+   * or an invalid pose, 1 for the rotation and 2 for the elbow.
+   */
+  size_t component{0};
+  /// Kind of violation.
+  TrajectoryViolationType type{TrajectoryViolationType::kNotFinite};
+  /// Largest absolute change of an element of the component by rate limiting, 0 for invalid
+  /// samples.
+  double deviation{0.0};
+};
+
+/**
+ * Result of validating a trajectory.
+ */
+struct TrajectoryValidationReport {
+  /// Number of checked samples.
+  size_t samples{0};
+  /// Violations, ordered by sample and component.
+  std::vector<TrajectoryViolation> violations;
+
+  /// @return True if no violation was found.
+  auto valid() const noexcept -> bool { return violations.empty(); }
+};
+
+/**
+ * Settings for validateTrajectory and validateTrajectories.
+ */
+struct TrajectoryValidationOptions {
+  /// Changes by rate limiting up to this value are considered rounding errors.
+  double tolerance{1e-9};
+  /// Number of samples checked as one unit of work. Trajectories are split into chunks of this
+  /// size, which are distributed over the threads.
+  size_t chunk_size{8192};
+  /// Number of threads to use, including the calling one. 0 to use one thread per core.
+  size_t threads{0};
+};
+
+/**
+ * Checks a trajectory like Robot::execute with rate limiting and without filtering would, without a
+ * robot.
+ *
+ * Each sample is checked with the same validity checks and the same rate limiter as in the control
+ * loop. The robot is assumed to be at rest at the first sample and to follow the samples
+ * exactly, so the desired velocities and accelerations are differentiated from the previous
+ * samples. A sample is reported if it is invalid or if rate limiting would change it by more than
+ * TrajectoryValidationOptions::tolerance; the latter is classified by the derivative which exceeds
+ * its limit in rate_limiting.h.
+ *
+ * @tparam T JointPositions, JointVelocities, CartesianPose or CartesianVelocities.
+ *
+ * @param[in] trajectory Trajectory to check.
+ * @param[in] options Validation settings.
+ *
+ * @return Violations found in the trajectory.
+ */
+template <typename T>
+auto validateTrajectory(const Trajectory<T>& trajectory,
+                        const TrajectoryValidationOptions& options = TrajectoryValidationOptions())
+    -> TrajectoryValidationReport;
+
+/**
+ * Checks several trajectories like validateTrajectory, sharing the threads between them.
+ *
+ * @tparam T JointPositions, JointVelocities, CartesianPose or CartesianVelocities.
+ *
+ * @param[in] trajectories Trajectories to check.
+ * @param[in] options Validation settings.
+ *
+ * @return One report per trajectory, in the same order.
+ */
+template <typename T>
+auto validateTrajectories(
+    const std::vector<Trajectory<T>>& trajectories,
+    const TrajectoryValidationOptions& options = TrajectoryValidationOptions())
+    -> std::vector<TrajectoryValidationReport>;
+
+}  // namespace franka
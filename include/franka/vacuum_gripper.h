@@ -4,9 +4,11 @@
 
 #include <chrono>
 #include <cstdint>
+#include <future>
 #include <memory>
 #include <string>
 
+#include <franka/network_config.h>
 #include <franka/vacuum_gripper_state.h>
 
 /**
@@ -41,11 +43,14 @@ class VacuumGripper {
    * Establishes a connection with a vacuum gripper connected to a robot.
    *
    * @param[in] franka_address IP/hostname of the robot the vacuum gripper is connected to.
+   * @param[in] network_config Socket settings for the connection.
    *
-   * @throw NetworkException if the connection is unsuccessful.
+   * @throw NetworkException if the connection is unsuccessful or the socket settings cannot be
+   * applied.
    * @throw IncompatibleVersionException if this version of `libfranka` is not supported.
    */
-  explicit VacuumGripper(const std::string& franka_address);
+  explicit VacuumGripper(const std::string& franka_address,
+                         const NetworkConfig& network_config = NetworkConfig());
 
   /**
    * Move-constructs a new VacuumGripper instance.
@@ -84,6 +89,24 @@ class VacuumGripper {
               std::chrono::milliseconds timeout,
               ProductionSetupProfile profile = ProductionSetupProfile::kP0) const -> bool;
 
+  /**
+   * Starts vacuuming an object without waiting for it to finish.
+   *
+   * @param[in] vacuum Setpoint for control mode. Unit: \f$[10*mbar]\f$.
+   * @param[in] timeout Vacuum timeout. Unit: \f$[ms]\f$.
+   * @param[in] profile Production setup profile P0 to P3. Default: P0.
+   *
+   * @return Future which becomes ready once the vacuum gripper has answered. It holds true if the
+   * vacuum has been established and false otherwise, or throws the exceptions listed for
+   * VacuumGripper::vacuum.
+   *
+   * @see VacuumGripper::vacuum
+   */
+  [[nodiscard]] auto vacuumAsync(
+      uint8_t vacuum,
+      std::chrono::milliseconds timeout,
+      ProductionSetupProfile profile = ProductionSetupProfile::kP0) const -> std::future<bool>;
+
   /**
    * Drops the grasped object off.
    *
@@ -96,6 +119,19 @@ class VacuumGripper {
    */
   [[nodiscard]] auto dropOff(std::chrono::milliseconds timeout) const -> bool;
 
+  /**
+   * Starts dropping the grasped object off without waiting for it to finish.
+   *
+   * @param[in] timeout Dropoff timeout. Unit: \f$[ms]\f$.
+   *
+   * @return Future which becomes ready once the vacuum gripper has answered. It holds true if the
+   * command was successful and false otherwise, or throws the exceptions listed for
+   * VacuumGripper::dropOff.
+   *
+   * @see VacuumGripper::dropOff
+   */
+  [[nodiscard]] auto dropOffAsync(std::chrono::milliseconds timeout) const -> std::future<bool>;
+
   /**
    * Stops a currently running vacuum gripper vacuum or drop off operation.
    *
@@ -106,6 +142,18 @@ class VacuumGripper {
    */
   [[nodiscard]] auto stop() const -> bool;
 
+  /**
+   * Requests stopping a currently running vacuum or drop off operation without waiting for the
+   * answer.
+   *
+   * @return Future which becomes ready once the vacuum gripper has answered. It holds true if the
+   * command was successful and false otherwise, or throws the exceptions listed for
+   * VacuumGripper::stop.
+   *
+   * @see VacuumGripper::stop
+   */
+  [[nodiscard]] auto stopAsync() const -> std::future<bool>;
+
   /**
    * Waits for a vacuum gripper state update and returns it.
    *
@@ -0,0 +1,87 @@
+// Copyright (c) 2017 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include "cartesian_pose_conditioner.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include <Eigen/Geometry>
+
+#include <franka/control_tools.h>
+#include <franka/rate_limiting.h>
+
+namespace franka {
+
+auto CartesianPoseConditioner::condition(bool filter,
+                                         double gain,
+                                         const std::array<double, 16>& O_T_EE_c,
+                                         const RobotState& robot_state) -> std::array<double, 16> {
+  if (!std::all_of(O_T_EE_c.begin(), O_T_EE_c.end(), [](double d) { return std::isfinite(d); })) {
+    throw std::invalid_argument("O_T_EE_c is infinite or NaN.");
+  }
+  // The filter re-normalizes the orientation, so only the last row of a filtered pose can be
+  // invalid.
+  bool valid = filter ? O_T_EE_c[3] == 0.0 && O_T_EE_c[7] == 0.0 && O_T_EE_c[11] == 0.0 &&
+                            O_T_EE_c[15] == 1.0
+                      : isHomogeneousTransformation(O_T_EE_c);
+  if (!valid) {
+    throw std::invalid_argument(
+        "O_T_EE_c is invalid transformation matrix. Has to be column major!");
+  }
+
+  Eigen::Map<const Eigen::Matrix4d> commanded_pose(O_T_EE_c.data());
+  Eigen::Map<const Eigen::Matrix4d> last_pose(robot_state.O_T_EE_c.data());
+  Eigen::Quaterniond last_orientation;
+  if (has_last_pose_ && robot_state.O_T_EE_c == last_pose_) {
+    last_orientation = Eigen::Map<const Eigen::Quaterniond>(last_orientation_.data());
+  } else {
+    last_orientation = Eigen::Quaterniond(Eigen::Matrix3d(last_pose.topLeftCorner<3, 3>()));
+  }
+  Eigen::Vector3d last_translation = last_pose.block<3, 1>(0, 3);
+
+  Eigen::Vector3d translation = commanded_pose.block<3, 1>(0, 3);
+  Eigen::Quaterniond orientation(Eigen::Matrix3d(commanded_pose.topLeftCorner<3, 3>()));
+  if (filter) {
+    translation = gain * translation + (1.0 - gain) * last_translation;
+    orientation = last_orientation.slerp(gain, orientation).normalized();
+  }
+
+  // Twist from the last to the commanded pose. The angle of the rotation difference does not
+  // depend on the signs of the quaternions.
+  Eigen::Matrix<double, 6, 1> dx;
+  Eigen::AngleAxisd rot_difference(orientation * last_orientation.conjugate());
+  dx.head(3) << (translation - last_translation) / kDeltaT;
+  dx.tail(3) << rot_difference.axis() * rot_difference.angle() / kDeltaT;
+
+  std::array<double, 6> O_dP_EE_c{};
+  Eigen::Map<Eigen::Matrix<double, 6, 1>>(O_dP_EE_c.data()) = dx;
+  O_dP_EE_c = limitRate(kMaxTranslationalVelocity, kMaxTranslationalAcceleration,
+                        kMaxTranslationalJerk,
+                        kFactorCartesianRotationPoseInterface * kMaxRotationalVelocity,
+                        kFactorCartesianRotationPoseInterface * kMaxRotationalAcceleration,
+                        kFactorCartesianRotationPoseInterface * kMaxRotationalJerk, O_dP_EE_c,
+                        robot_state.O_dP_EE_c, robot_state.O_ddP_EE_c);
+  dx = Eigen::Matrix<double, 6, 1>(O_dP_EE_c.data());
+
+  // Integrate the limited twist.
+  Eigen::Matrix4d limited_pose = Eigen::Matrix4d::Identity();
+  limited_pose.block<3, 1>(0, 3) = last_translation + dx.head(3) * kDeltaT;
+  Eigen::Quaterniond limited_orientation = last_orientation;
+  double rotational_velocity = dx.tail(3).norm();
+  if (rotational_velocity > kNormEps) {
+    Eigen::AngleAxisd rotation(kDeltaT * rotational_velocity, dx.tail(3) / rotational_velocity);
+    limited_orientation = (Eigen::Quaterniond(rotation) * last_orientation).normalized();
+    limited_pose.topLeftCorner<3, 3>() = limited_orientation.toRotationMatrix();
+  } else {
+    limited_pose.topLeftCorner<3, 3>() = last_pose.topLeftCorner<3, 3>();
+  }
+
+  Eigen::Map<Eigen::Matrix4d>(last_pose_.data()) = limited_pose;
+  std::copy(limited_orientation.coeffs().data(), limited_orientation.coeffs().data() + 4,
+            last_orientation_.begin());
+  has_last_pose_ = true;
+  return last_pose_;
+}
+
+}  // namespace franka
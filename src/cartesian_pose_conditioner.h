@@ -0,0 +1,46 @@
+// Copyright (c) 2017 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#pragma once
+
+#include <array>
+
+#include <franka/robot_state.h>
+
+namespace franka {
+
+/**
+ * Low-pass filters and rate limits commanded Cartesian poses in one step.
+ *
+ * Gives the same results as cartesianLowpassFilter followed by the Cartesian pose limitRate, up to
+ * rounding, but works on quaternions throughout. The orientation of the last conditioned pose is
+ * kept, and reused as long as the robot reports this pose back as the last commanded pose, so only
+ * the orientation of the new command has to be converted from a rotation matrix in each cycle.
+ */
+class CartesianPoseConditioner {
+ public:
+  /**
+   * Conditions a commanded pose.
+   *
+   * @param[in] filter True if the pose is low-pass filtered before rate limiting.
+   * @param[in] gain Filter gain as returned by lowpassFilterGain.
+   * @param[in] O_T_EE_c Commanded pose.
+   * @param[in] robot_state Current robot state, containing the last commanded pose and its
+   * derivatives.
+   *
+   * @throw std::invalid_argument if O_T_EE_c is infinite, NaN or not a valid transformation.
+   *
+   * @return Filtered and rate-limited pose.
+   */
+  auto condition(bool filter,
+                 double gain,
+                 const std::array<double, 16>& O_T_EE_c,
+                 const RobotState& robot_state) -> std::array<double, 16>;
+
+ private:
+  std::array<double, 16> last_pose_{};
+  // Quaternion of the last pose, stored as x, y, z, w.
+  std::array<double, 4> last_orientation_{};
+  bool has_last_pose_ = false;
+};
+
+}  // namespace franka
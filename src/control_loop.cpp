@@ -6,15 +6,20 @@
 #include <franka/lowpass_filter.h>
 #include <franka/rate_limiting.h>
 
+#include <Eigen/Geometry>
+
 #include <algorithm>
 #include <cerrno>
 #include <cstring>
 #include <exception>
 #include <fstream>
+#include <memory>
 #include <string>
 #include <utility>
 
+#include "cartesian_pose_conditioner.h"
 #include "control_loop.h"
+#include "control_loop_timing.h"
 #include "motion_generator_traits.h"
 
 // `using std::string_literals::operator""s` produces a GCC warning that cannot be disabled, so we
@@ -53,65 +58,96 @@ inline void checkMatrix(const std::array<double, 16>& transform) {
   }
 }
 
+template <typename T>
+inline void setElbow(const T& motion,
+                     research_interface::robot::MotionGeneratorCommand* command) noexcept {
+  if (motion.hasElbow()) {
+    command->valid_elbow = true;
+    command->elbow_c = motion.elbow;
+  } else {
+    command->valid_elbow = false;
+    command->elbow_c = {};
+  }
+}
+
+inline void filterElbow(double gain,
+                        const RobotState& robot_state,
+                        research_interface::robot::MotionGeneratorCommand* command) noexcept {
+  if (command->valid_elbow) {
+    command->elbow_c[0] = lowpassFilter(gain, command->elbow_c[0], robot_state.elbow_c[0]);
+  }
+}
+
+inline void limitElbow(const RobotState& robot_state,
+                       research_interface::robot::MotionGeneratorCommand* command) {
+  if (command->valid_elbow) {
+    command->elbow_c[0] =
+        limitRate(kMaxElbowVelocity, kMaxElbowAcceleration, kMaxElbowJerk, command->elbow_c[0],
+                  robot_state.elbow_c[0], robot_state.delbow_c[0], robot_state.ddelbow_c[0]);
+  }
+}
+
+// Keeps the elbow setting of the previous command, as the elbow is a position for all Cartesian
+// motion generators.
+inline void fallbackElbow(MotionFallback fallback,
+                          const RobotState& robot_state,
+                          research_interface::robot::MotionGeneratorCommand* command) noexcept {
+  if (command->valid_elbow) {
+    command->elbow_c = robot_state.elbow_c;
+    if (fallback == MotionFallback::kExtrapolateVelocity) {
+      command->elbow_c[0] += robot_state.delbow_c[0] * kDeltaT;
+    }
+  }
+}
+
+// Moves the pose with the given Cartesian velocity for one cycle.
+auto extrapolatePose(const std::array<double, 16>& pose,
+                     const std::array<double, 6>& velocity) noexcept -> std::array<double, 16> {
+  Eigen::Affine3d transform(Eigen::Matrix4d::Map(pose.data()));
+  Eigen::Map<const Eigen::Matrix<double, 6, 1>> twist(velocity.data());
+  transform.translation() += twist.head<3>() * kDeltaT;
+  Eigen::Vector3d rotation = twist.tail<3>() * kDeltaT;
+  if (rotation.norm() > 0.0) {
+    transform.linear() =
+        Eigen::AngleAxisd(rotation.norm(), rotation.normalized()).toRotationMatrix() *
+        transform.linear();
+  }
+  std::array<double, 16> extrapolated{};
+  Eigen::Map<Eigen::Matrix4d>(extrapolated.data()) = transform.matrix();
+  return extrapolated;
+}
+
 }  // anonymous namespace
 
-//template <typename T>
-//constexpr research_interface::robot::Move::Deviation ControlLoop<T>::kDefaultDeviation;
+template <typename T>
+struct ControlLoopBase<T>::Commands {
+  research_interface::robot::MotionGeneratorCommand motion{};
+  research_interface::robot::ControllerCommand control{};
+  CartesianPoseConditioner cartesian_pose;
+};
 
 template <typename T>
-ControlLoop<T>::ControlLoop(RobotControl& robot,
-                            MotionGeneratorCallback motion_callback,
-                            ControlCallback control_callback,
-                            bool limit_rate,
-                            double cutoff_frequency)
+ControlLoopBase<T>::ControlLoopBase(RobotControl& robot)
     : robot_(robot),
-      motion_callback_(std::move(motion_callback)),
-      control_callback_(std::move(control_callback)),
-      limit_rate_(limit_rate),
-      cutoff_frequency_(cutoff_frequency) {
-  bool throw_on_error = robot_.realtimeConfig() == RealtimeConfig::kEnforce;
-  std::string error_message;
-  if (!setCurrentThreadToHighestSchedulerPriority(&error_message) && throw_on_error) {
-    throw RealtimeException(error_message);
-  }
-  if (throw_on_error && !hasRealtimeKernel()) {
-    throw RealtimeException("libfranka: Running kernel does not have realtime capabilities.");
-  }
+      timing_(robot.controlLoopTimingRecorder()),
+      watchdog_(robot.controlLoopWatchdog()),
+      watchdog_enabled_(watchdog_.budget > std::chrono::microseconds::zero()),
+      commands_(std::make_unique<Commands>()) {
+  applyRealtimeConfig(robot_.realtimeConfig());
 }
 
 template <typename T>
-ControlLoop<T>::ControlLoop(RobotControl& robot,
-                            ControlCallback control_callback,
-                            MotionGeneratorCallback motion_callback,
-                            bool limit_rate,
-                            double cutoff_frequency)
-    : ControlLoop(robot,
-                  std::move(motion_callback),
-                  std::move(control_callback),
-                  limit_rate,
-                  cutoff_frequency) {
-  if (!control_callback_) {
-    throw std::invalid_argument("libfranka: Invalid control callback given.");
-  }
-  if (!motion_callback_) {
-    throw std::invalid_argument("libfranka: Invalid motion callback given.");
-  }
+ControlLoopBase<T>::~ControlLoopBase() noexcept = default;
 
-  motion_id_ = robot.startMotion(
+template <typename T>
+void ControlLoopBase<T>::startMotion() {
+  motion_id_ = robot_.startMotion(
       research_interface::robot::Move::ControllerMode::kExternalController,
       MotionGeneratorTraits<T>::kMotionGeneratorMode, kDefaultDeviation, kDefaultDeviation);
 }
 
 template <typename T>
-ControlLoop<T>::ControlLoop(RobotControl& robot,
-                            ControllerMode controller_mode,
-                            MotionGeneratorCallback motion_callback,
-                            bool limit_rate,
-                            double cutoff_frequency)
-    : ControlLoop(robot, std::move(motion_callback), {}, limit_rate, cutoff_frequency) {
-  if (!motion_callback_) {
-    throw std::invalid_argument("libfranka: Invalid motion callback given.");
-  }
+void ControlLoopBase<T>::startMotion(ControllerMode controller_mode) {
   research_interface::robot::Move::ControllerMode mode;
   switch (controller_mode) {
     case ControllerMode::kJointImpedance:
@@ -123,189 +159,336 @@ ControlLoop<T>::ControlLoop(RobotControl& robot,
     default:
       throw std::invalid_argument("libfranka: Invalid controller mode given.");
   }
-  motion_id_ = robot.startMotion(mode, MotionGeneratorTraits<T>::kMotionGeneratorMode,
-                                 kDefaultDeviation, kDefaultDeviation);
+  motion_id_ = robot_.startMotion(mode, MotionGeneratorTraits<T>::kMotionGeneratorMode,
+                                  kDefaultDeviation, kDefaultDeviation);
 }
 
 template <typename T>
-void ControlLoop<T>::operator()() try {
-  RobotState robot_state = robot_.update(nullptr, nullptr);
+auto ControlLoopBase<T>::update(
+    const research_interface::robot::MotionGeneratorCommand* motion_command,
+    const research_interface::robot::ControllerCommand* control_command) -> RobotState {
+  auto start = timestamp();
+  RobotState robot_state = robot_.update(motion_command, control_command);
+  auto update_end = timestamp();
   robot_.throwOnMotionError(robot_state, motion_id_);
+  recordTiming(ControlLoopPhase::kUpdate, start, update_end);
+  recordTiming(ControlLoopPhase::kErrorCheck, update_end, timestamp());
+  return robot_state;
+}
+
+template <typename T>
+void ControlLoopBase<T>::send(
+    const research_interface::robot::MotionGeneratorCommand* motion_command,
+    const research_interface::robot::ControllerCommand* control_command) {
+  robot_.send(motion_command, control_command);
+}
 
-  Duration previous_time = robot_state.time;
+template <typename T>
+auto ControlLoopBase<T>::receive() -> RobotState {
+  auto start = timestamp();
+  RobotState robot_state = robot_.receive();
+  auto receive_end = timestamp();
+  robot_.throwOnMotionError(robot_state, motion_id_);
+  recordTiming(ControlLoopPhase::kUpdate, start, receive_end);
+  recordTiming(ControlLoopPhase::kErrorCheck, receive_end, timestamp());
+  return robot_state;
+}
 
-  research_interface::robot::MotionGeneratorCommand motion_command{};
-  if (control_callback_) {
-    research_interface::robot::ControllerCommand control_command{};
-    while (spinMotion(robot_state, robot_state.time - previous_time, &motion_command) &&
-           spinControl(robot_state, robot_state.time - previous_time, &control_command)) {
-      previous_time = robot_state.time;
-      robot_state = robot_.update(&motion_command, &control_command);
-      robot_.throwOnMotionError(robot_state, motion_id_);
-    }
-    robot_.finishMotion(motion_id_, &motion_command, &control_command);
-  } else {
-    while (spinMotion(robot_state, robot_state.time - previous_time, &motion_command)) {
-      previous_time = robot_state.time;
-      robot_state = robot_.update(&motion_command, nullptr);
-      robot_.throwOnMotionError(robot_state, motion_id_);
-    }
-    robot_.finishMotion(motion_id_, &motion_command, nullptr);
-  }
-} catch (...) {
+template <typename T>
+void ControlLoopBase<T>::finishMotion(
+    const research_interface::robot::MotionGeneratorCommand* motion_command,
+    const research_interface::robot::ControllerCommand* control_command) {
+  robot_.finishMotion(motion_id_, motion_command, control_command);
+}
+
+template <typename T>
+void ControlLoopBase<T>::cancelMotion() noexcept {
   try {
     robot_.cancelMotion(motion_id_);
   } catch (...) {
   }
-  throw;
 }
 
 template <typename T>
-auto ControlLoop<T>::spinControl(const RobotState& robot_state,
-                                 franka::Duration time_step,
-                                 research_interface::robot::ControllerCommand* command) -> bool {
-  Torques control_output = control_callback_(robot_state, time_step);
-  if (cutoff_frequency_ < kMaxCutoffFrequency) {
-    for (size_t i = 0; i < 7; i++) {
-      control_output.tau_J[i] = lowpassFilter(kDeltaT, control_output.tau_J[i],
-                                              robot_state.tau_J_d[i], cutoff_frequency_);
-    }
+auto ControlLoopBase<T>::motionCommand() noexcept
+    -> research_interface::robot::MotionGeneratorCommand* {
+  return &commands_->motion;
+}
+
+template <typename T>
+auto ControlLoopBase<T>::controlCommand() noexcept
+    -> research_interface::robot::ControllerCommand* {
+  return &commands_->control;
+}
+
+template <typename T>
+void ControlLoopBase<T>::recordDuration(ControlLoopPhase phase,
+                                        std::chrono::steady_clock::duration duration) noexcept {
+  timing_->record(phase, duration);
+}
+
+template <typename T>
+void ControlLoopBase<T>::recordDeadlineMiss() noexcept {
+  robot_.recordDeadlineMiss();
+}
+
+template <typename T>
+void ControlLoopBase<T>::fallbackTorques(
+    const RobotState& robot_state,
+    research_interface::robot::ControllerCommand* command) const noexcept {
+  switch (watchdog_.torque_fallback) {
+    case TorqueFallback::kHoldTorque:
+      command->tau_J_d = robot_state.tau_J_d;
+      break;
+    case TorqueFallback::kZeroTorque:
+    default:
+      command->tau_J_d = {};
+      break;
   }
-  if (limit_rate_) {
-    control_output.tau_J = limitRate(kMaxTorqueRate, control_output.tau_J, robot_state.tau_J_d);
+}
+
+template <typename T>
+void ControlLoopBase<T>::copyTorques(
+    const Torques& torques,
+    research_interface::robot::ControllerCommand* command) noexcept {
+  command->tau_J_d = torques.tau_J;
+}
+
+template <typename T>
+void ControlLoopBase<T>::filterTorques(
+    double gain,
+    const RobotState& robot_state,
+    research_interface::robot::ControllerCommand* command) noexcept {
+  for (size_t i = 0; i < 7; i++) {
+    command->tau_J_d[i] = lowpassFilter(gain, command->tau_J_d[i], robot_state.tau_J_d[i]);
+  }
+}
+
+template <typename T>
+void ControlLoopBase<T>::filterAndLimitMotion(
+    bool filter,
+    double gain,
+    const RobotState& robot_state,
+    research_interface::robot::MotionGeneratorCommand* command) {
+  if (filter) {
+    filterMotion(gain, robot_state, command);
   }
-  command->tau_J_d = control_output.tau_J;
-  checkFinite(command->tau_J_d);
-  return !control_output.motion_finished;
+  limitMotion(robot_state, command);
 }
 
 template <typename T>
-auto ControlLoop<T>::spinMotion(const RobotState& robot_state,
-                                franka::Duration time_step,
-                                research_interface::robot::MotionGeneratorCommand* command) -> bool {
-  T motion_output = motion_callback_(robot_state, time_step);
-  convertMotion(motion_output, robot_state, command);
-  return !motion_output.motion_finished;
+void ControlLoopBase<T>::limitTorques(const RobotState& robot_state,
+                                      research_interface::robot::ControllerCommand* command) {
+  command->tau_J_d = limitRate(kMaxTorqueRate, command->tau_J_d, robot_state.tau_J_d);
+}
+
+template <typename T>
+void ControlLoopBase<T>::checkTorques(const research_interface::robot::ControllerCommand& command) {
+  checkFinite(command.tau_J_d);
 }
 
 template <>
-void ControlLoop<JointPositions>::convertMotion(
+void ControlLoopBase<JointPositions>::copyMotion(
     const JointPositions& motion,
+    research_interface::robot::MotionGeneratorCommand* command) noexcept {
+  command->q_c = motion.q;
+}
+
+template <>
+void ControlLoopBase<JointPositions>::filterMotion(
+    double gain,
     const RobotState& robot_state,
     research_interface::robot::MotionGeneratorCommand* command) {
-  command->q_c = motion.q;
-  if (cutoff_frequency_ < kMaxCutoffFrequency) {
+  for (size_t i = 0; i < 7; i++) {
+    command->q_c[i] = lowpassFilter(gain, command->q_c[i], robot_state.q_d[i]);
+  }
+}
+
+template <>
+void ControlLoopBase<JointPositions>::limitMotion(
+    const RobotState& robot_state,
+    research_interface::robot::MotionGeneratorCommand* command) {
+  command->q_c = limitRate(kMaxJointVelocity, kMaxJointAcceleration, kMaxJointJerk, command->q_c,
+                           robot_state.q_d, robot_state.dq_d, robot_state.ddq_d);
+}
+
+template <>
+void ControlLoopBase<JointPositions>::fallbackMotion(
+    const RobotState& robot_state,
+    research_interface::robot::MotionGeneratorCommand* command) const noexcept {
+  command->q_c = robot_state.q_d;
+  if (watchdog_.motion_fallback == MotionFallback::kExtrapolateVelocity) {
     for (size_t i = 0; i < 7; i++) {
-      command->q_c[i] =
-          lowpassFilter(kDeltaT, command->q_c[i], robot_state.q_d[i], cutoff_frequency_);
+      command->q_c[i] += robot_state.dq_d[i] * kDeltaT;
     }
   }
-  if (limit_rate_) {
-    command->q_c = limitRate(kMaxJointVelocity, kMaxJointAcceleration, kMaxJointJerk, command->q_c,
-                             robot_state.q_d, robot_state.dq_d, robot_state.ddq_d);
-  }
-  checkFinite(command->q_c);
 }
 
 template <>
-void ControlLoop<JointVelocities>::convertMotion(
+void ControlLoopBase<JointPositions>::checkMotion(
+    const research_interface::robot::MotionGeneratorCommand& command) {
+  checkFinite(command.q_c);
+}
+
+template <>
+void ControlLoopBase<JointVelocities>::copyMotion(
     const JointVelocities& motion,
+    research_interface::robot::MotionGeneratorCommand* command) noexcept {
+  command->dq_c = motion.dq;
+}
+
+template <>
+void ControlLoopBase<JointVelocities>::filterMotion(
+    double gain,
     const RobotState& robot_state,
     research_interface::robot::MotionGeneratorCommand* command) {
-  command->dq_c = motion.dq;
-  if (cutoff_frequency_ < kMaxCutoffFrequency) {
-    for (size_t i = 0; i < 7; i++) {
-      command->dq_c[i] =
-          lowpassFilter(kDeltaT, command->dq_c[i], robot_state.dq_d[i], cutoff_frequency_);
-    }
+  for (size_t i = 0; i < 7; i++) {
+    command->dq_c[i] = lowpassFilter(gain, command->dq_c[i], robot_state.dq_d[i]);
   }
-  if (limit_rate_) {
-    command->dq_c = limitRate(kMaxJointVelocity, kMaxJointAcceleration, kMaxJointJerk,
-                              command->dq_c, robot_state.dq_d, robot_state.ddq_d);
+}
+
+template <>
+void ControlLoopBase<JointVelocities>::limitMotion(
+    const RobotState& robot_state,
+    research_interface::robot::MotionGeneratorCommand* command) {
+  command->dq_c = limitRate(kMaxJointVelocity, kMaxJointAcceleration, kMaxJointJerk, command->dq_c,
+                            robot_state.dq_d, robot_state.ddq_d);
+}
+
+template <>
+void ControlLoopBase<JointVelocities>::fallbackMotion(
+    const RobotState& robot_state,
+    research_interface::robot::MotionGeneratorCommand* command) const noexcept {
+  if (watchdog_.motion_fallback == MotionFallback::kExtrapolateVelocity) {
+    command->dq_c = robot_state.dq_d;
+  } else {
+    command->dq_c = {};
   }
-  checkFinite(command->dq_c);
 }
 
 template <>
-void ControlLoop<CartesianPose>::convertMotion(
+void ControlLoopBase<JointVelocities>::checkMotion(
+    const research_interface::robot::MotionGeneratorCommand& command) {
+  checkFinite(command.dq_c);
+}
+
+template <>
+void ControlLoopBase<CartesianPose>::copyMotion(
     const CartesianPose& motion,
+    research_interface::robot::MotionGeneratorCommand* command) noexcept {
+  command->O_T_EE_c = motion.O_T_EE;
+  setElbow(motion, command);
+}
+
+template <>
+void ControlLoopBase<CartesianPose>::filterMotion(
+    double gain,
     const RobotState& robot_state,
     research_interface::robot::MotionGeneratorCommand* command) {
-  command->O_T_EE_c = motion.O_T_EE;
-  if (cutoff_frequency_ < kMaxCutoffFrequency) {
-    command->O_T_EE_c =
-        cartesianLowpassFilter(kDeltaT, command->O_T_EE_c, robot_state.O_T_EE_c, cutoff_frequency_);
-  }
+  command->O_T_EE_c = cartesianLowpassFilter(gain, command->O_T_EE_c, robot_state.O_T_EE_c);
+  filterElbow(gain, robot_state, command);
+}
+
+template <>
+void ControlLoopBase<CartesianPose>::limitMotion(
+    const RobotState& robot_state,
+    research_interface::robot::MotionGeneratorCommand* command) {
+  command->O_T_EE_c = limitRate(
+      kMaxTranslationalVelocity, kMaxTranslationalAcceleration, kMaxTranslationalJerk,
+      kMaxRotationalVelocity, kMaxRotationalAcceleration, kMaxRotationalJerk, command->O_T_EE_c,
+      robot_state.O_T_EE_c, robot_state.O_dP_EE_c, robot_state.O_ddP_EE_c);
+  limitElbow(robot_state, command);
+}
 
-  if (limit_rate_) {
-    command->O_T_EE_c = limitRate(
-        kMaxTranslationalVelocity, kMaxTranslationalAcceleration, kMaxTranslationalJerk,
-        kMaxRotationalVelocity, kMaxRotationalAcceleration, kMaxRotationalJerk, command->O_T_EE_c,
-        robot_state.O_T_EE_c, robot_state.O_dP_EE_c, robot_state.O_ddP_EE_c);
+template <>
+void ControlLoopBase<CartesianPose>::filterAndLimitMotion(
+    bool filter,
+    double gain,
+    const RobotState& robot_state,
+    research_interface::robot::MotionGeneratorCommand* command) {
+  command->O_T_EE_c =
+      commands_->cartesian_pose.condition(filter, gain, command->O_T_EE_c, robot_state);
+  if (filter) {
+    filterElbow(gain, robot_state, command);
   }
-  checkMatrix(command->O_T_EE_c);
+  limitElbow(robot_state, command);
+}
 
-  if (motion.hasElbow()) {
-    command->valid_elbow = true;
-    command->elbow_c = motion.elbow;
-    if (cutoff_frequency_ < kMaxCutoffFrequency) {
-      command->elbow_c[0] =
-          lowpassFilter(kDeltaT, command->elbow_c[0], robot_state.elbow_c[0], cutoff_frequency_);
-    }
-    if (limit_rate_) {
-      command->elbow_c[0] =
-          limitRate(kMaxElbowVelocity, kMaxElbowAcceleration, kMaxElbowJerk, command->elbow_c[0],
-                    robot_state.elbow_c[0], robot_state.delbow_c[0], robot_state.ddelbow_c[0]);
-    }
-    checkElbow(command->elbow_c);
+template <>
+void ControlLoopBase<CartesianPose>::fallbackMotion(
+    const RobotState& robot_state,
+    research_interface::robot::MotionGeneratorCommand* command) const noexcept {
+  if (watchdog_.motion_fallback == MotionFallback::kExtrapolateVelocity) {
+    command->O_T_EE_c = extrapolatePose(robot_state.O_T_EE_c, robot_state.O_dP_EE_c);
   } else {
-    command->valid_elbow = false;
-    command->elbow_c = {};
+    command->O_T_EE_c = robot_state.O_T_EE_c;
+  }
+  fallbackElbow(watchdog_.motion_fallback, robot_state, command);
+}
+
+template <>
+void ControlLoopBase<CartesianPose>::checkMotion(
+    const research_interface::robot::MotionGeneratorCommand& command) {
+  checkMatrix(command.O_T_EE_c);
+  if (command.valid_elbow) {
+    checkElbow(command.elbow_c);
   }
 }
 
 template <>
-void ControlLoop<CartesianVelocities>::convertMotion(
+void ControlLoopBase<CartesianVelocities>::copyMotion(
     const CartesianVelocities& motion,
+    research_interface::robot::MotionGeneratorCommand* command) noexcept {
+  command->O_dP_EE_c = motion.O_dP_EE;
+  setElbow(motion, command);
+}
+
+template <>
+void ControlLoopBase<CartesianVelocities>::filterMotion(
+    double gain,
     const RobotState& robot_state,
     research_interface::robot::MotionGeneratorCommand* command) {
-  command->O_dP_EE_c = motion.O_dP_EE;
-  if (cutoff_frequency_ < kMaxCutoffFrequency) {
-    for (size_t i = 0; i < 6; i++) {
-      command->O_dP_EE_c[i] = lowpassFilter(kDeltaT, command->O_dP_EE_c[i],
-                                            robot_state.O_dP_EE_c[i], cutoff_frequency_);
-    }
-  }
-  if (limit_rate_) {
-    command->O_dP_EE_c =
-        limitRate(kMaxTranslationalVelocity, kMaxTranslationalAcceleration, kMaxTranslationalJerk,
-                  kMaxRotationalVelocity, kMaxRotationalAcceleration, kMaxRotationalJerk,
-                  command->O_dP_EE_c, robot_state.O_dP_EE_c, robot_state.O_ddP_EE_c);
+  for (size_t i = 0; i < 6; i++) {
+    command->O_dP_EE_c[i] = lowpassFilter(gain, command->O_dP_EE_c[i], robot_state.O_dP_EE_c[i]);
   }
-  checkFinite(command->O_dP_EE_c);
+  filterElbow(gain, robot_state, command);
+}
 
-  if (motion.hasElbow()) {
-    command->valid_elbow = true;
-    command->elbow_c = motion.elbow;
-    if (cutoff_frequency_ < kMaxCutoffFrequency) {
-      command->elbow_c[0] =
-          lowpassFilter(kDeltaT, command->elbow_c[0], robot_state.elbow_c[0], cutoff_frequency_);
-    }
-    if (limit_rate_) {
-      command->elbow_c[0] =
-          limitRate(kMaxElbowVelocity, kMaxElbowAcceleration, kMaxElbowJerk, command->elbow_c[0],
-                    robot_state.elbow_c[0], robot_state.delbow_c[0], robot_state.ddelbow_c[0]);
-    }
-    checkElbow(command->elbow_c);
+template <>
+void ControlLoopBase<CartesianVelocities>::limitMotion(
+    const RobotState& robot_state,
+    research_interface::robot::MotionGeneratorCommand* command) {
+  command->O_dP_EE_c =
+      limitRate(kMaxTranslationalVelocity, kMaxTranslationalAcceleration, kMaxTranslationalJerk,
+                kMaxRotationalVelocity, kMaxRotationalAcceleration, kMaxRotationalJerk,
+                command->O_dP_EE_c, robot_state.O_dP_EE_c, robot_state.O_ddP_EE_c);
+  limitElbow(robot_state, command);
+}
+
+template <>
+void ControlLoopBase<CartesianVelocities>::fallbackMotion(
+    const RobotState& robot_state,
+    research_interface::robot::MotionGeneratorCommand* command) const noexcept {
+  if (watchdog_.motion_fallback == MotionFallback::kExtrapolateVelocity) {
+    command->O_dP_EE_c = robot_state.O_dP_EE_c;
   } else {
-    command->valid_elbow = false;
-    command->elbow_c = {};
+    command->O_dP_EE_c = {};
+  }
+  fallbackElbow(watchdog_.motion_fallback, robot_state, command);
+}
+
+template <>
+void ControlLoopBase<CartesianVelocities>::checkMotion(
+    const research_interface::robot::MotionGeneratorCommand& command) {
+  checkFinite(command.O_dP_EE_c);
+  if (command.valid_elbow) {
+    checkElbow(command.elbow_c);
   }
 }
 
-template class ControlLoop<JointPositions>;
-template class ControlLoop<JointVelocities>;
-template class ControlLoop<CartesianPose>;
-template class ControlLoop<CartesianVelocities>;
+template class ControlLoopBase<JointPositions>;
+template class ControlLoopBase<JointVelocities>;
+template class ControlLoopBase<CartesianPose>;
+template class ControlLoopBase<CartesianVelocities>;
 
 }  // namespace franka
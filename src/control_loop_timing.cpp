@@ -0,0 +1,90 @@
+// Copyright (c) 2017 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include "control_loop_timing.h"
+
+#include <algorithm>
+
+#include "relaxed_counter.h"
+
+namespace franka {
+
+namespace {
+
+auto bucket(std::chrono::steady_clock::duration duration) noexcept -> size_t {
+  auto microseconds = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+  size_t bucket = 0;
+  while (microseconds > 0 && bucket < PhaseTiming::kBuckets - 1) {
+    microseconds >>= 1;
+    bucket++;
+  }
+  return bucket;
+}
+
+void streamPhase(std::ostream& ostream, const char* name, const PhaseTiming& phase) {
+  ostream << '"' << name << "\": {\"count\": " << phase.count
+          << ", \"total_ns\": " << phase.total.count() << ", \"max_ns\": " << phase.max.count()
+          << ", \"histogram\": [";
+  for (size_t i = 0; i < phase.histogram.size(); i++) {
+    ostream << (i > 0 ? "," : "") << phase.histogram[i];
+  }
+  ostream << "]}";
+}
+
+}  // anonymous namespace
+
+void ControlLoopTimingRecorder::record(ControlLoopPhase phase,
+                                       std::chrono::steady_clock::duration duration) noexcept {
+  int64_t nanoseconds = std::max<int64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count(), 0);
+  Phase& recorded = phases_[static_cast<size_t>(phase)];
+  relaxedAdd(recorded.histogram[bucket(duration)], 1);
+  relaxedAdd(recorded.total_ns, nanoseconds);
+  if (nanoseconds > recorded.max_ns.load(std::memory_order_relaxed)) {
+    recorded.max_ns.store(nanoseconds, std::memory_order_relaxed);
+  }
+  relaxedAdd(recorded.count, 1);
+}
+
+auto ControlLoopTimingRecorder::Phase::snapshot() const noexcept -> PhaseTiming {
+  PhaseTiming timing;
+  timing.count = count.load(std::memory_order_relaxed);
+  timing.total = std::chrono::nanoseconds(total_ns.load(std::memory_order_relaxed));
+  timing.max = std::chrono::nanoseconds(max_ns.load(std::memory_order_relaxed));
+  for (size_t i = 0; i < timing.histogram.size(); i++) {
+    timing.histogram[i] = histogram[i].load(std::memory_order_relaxed);
+  }
+  return timing;
+}
+
+auto ControlLoopTimingRecorder::snapshot() const noexcept -> ControlLoopTiming {
+  auto phase = [this](ControlLoopPhase phase) {
+    return phases_[static_cast<size_t>(phase)].snapshot();
+  };
+  ControlLoopTiming timing;
+  timing.update = phase(ControlLoopPhase::kUpdate);
+  timing.error_check = phase(ControlLoopPhase::kErrorCheck);
+  timing.motion_callback = phase(ControlLoopPhase::kMotionCallback);
+  timing.motion_conversion = phase(ControlLoopPhase::kMotionConversion);
+  timing.control_callback = phase(ControlLoopPhase::kControlCallback);
+  timing.control_conversion = phase(ControlLoopPhase::kControlConversion);
+  return timing;
+}
+
+auto operator<<(std::ostream& ostream, const ControlLoopTiming& timing) -> std::ostream& {
+  ostream << "{";
+  streamPhase(ostream, "update", timing.update);
+  ostream << ", ";
+  streamPhase(ostream, "error_check", timing.error_check);
+  ostream << ", ";
+  streamPhase(ostream, "motion_callback", timing.motion_callback);
+  ostream << ", ";
+  streamPhase(ostream, "motion_conversion", timing.motion_conversion);
+  ostream << ", ";
+  streamPhase(ostream, "control_callback", timing.control_callback);
+  ostream << ", ";
+  streamPhase(ostream, "control_conversion", timing.control_conversion);
+  ostream << "}";
+  return ostream;
+}
+
+}  // namespace franka
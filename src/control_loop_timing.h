@@ -0,0 +1,47 @@
+// Copyright (c) 2017 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include <franka/control_loop_timing.h>
+
+namespace franka {
+
+/**
+ * Collects ControlLoopTiming.
+ *
+ * Only a single thread may record durations, while any number of threads may read a snapshot
+ * concurrently without blocking. The fields of a snapshot are read independently of each other.
+ */
+class ControlLoopTimingRecorder {
+ public:
+  /**
+   * Records the duration of a phase.
+   *
+   * @param[in] phase Phase of the control loop.
+   * @param[in] duration Duration of the phase.
+   */
+  void record(ControlLoopPhase phase, std::chrono::steady_clock::duration duration) noexcept;
+
+  auto snapshot() const noexcept -> ControlLoopTiming;
+
+ private:
+  struct Phase {
+    std::atomic<uint64_t> count{0};
+    std::atomic<int64_t> total_ns{0};
+    std::atomic<int64_t> max_ns{0};
+    std::array<std::atomic<uint64_t>, PhaseTiming::kBuckets> histogram{};
+
+    auto snapshot() const noexcept -> PhaseTiming;
+  };
+
+  static constexpr size_t kPhases = static_cast<size_t>(ControlLoopPhase::kControlConversion) + 1;
+
+  std::array<Phase, kPhases> phases_{};
+};
+
+}  // namespace franka
@@ -2,6 +2,8 @@
 // Use of this source code is governed by the Apache-2.0 license, see LICENSE
 #include <franka/control_tools.h>
 
+#include <franka/exception.h>
+
 #ifdef LIBFRANKA_WINDOWS
 #include <Windows.h>
 #else
@@ -9,8 +11,21 @@
 #include <sched.h>
 #endif
 
+#if defined(__linux__)
+#include <alloca.h>
+#include <malloc.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
 #include <cstring>
 #include <fstream>
+#include <sstream>
+#include <stdexcept>
 #include <string>
 
 #include "platform.h"
@@ -35,7 +50,24 @@ auto hasRealtimeKernel()  -> bool{
 #endif
 }
 
+namespace {
+
+auto makeIgnoringRealtimeConfig() -> RealtimeConfig {
+  RealtimeConfig config;
+  config.enforce = false;
+  return config;
+}
+
+}  // anonymous namespace
+
+const RealtimeConfig RealtimeConfig::kEnforce{};
+const RealtimeConfig RealtimeConfig::kIgnore = makeIgnoringRealtimeConfig();
+
 auto setCurrentThreadToHighestSchedulerPriority(std::string* error_message)  -> bool {
+  return setCurrentThreadSchedulerPriority(0, error_message);
+}
+
+auto setCurrentThreadSchedulerPriority(int priority, std::string* error_message) -> bool {
 #ifdef LIBFRANKA_WINDOWS
   auto get_last_windows_error = []() -> std::string {
     DWORD error_id = GetLastError();
@@ -64,14 +96,24 @@ auto setCurrentThreadToHighestSchedulerPriority(std::string* error_message)  ->
 
   return true;
 #else
-  const int thread_priority = sched_get_priority_max(SCHED_FIFO);
-  if (thread_priority == -1) {
+  const int max_priority = sched_get_priority_max(SCHED_FIFO);
+  if (max_priority == -1) {
     if (error_message != nullptr) {
       *error_message =
           "libfranka: unable to get maximum possible thread priority: "s + std::strerror(errno);
     }
     return false;
   }
+  const int min_priority = sched_get_priority_min(SCHED_FIFO);
+  if (priority != 0 && (priority < min_priority || priority > max_priority)) {
+    if (error_message != nullptr) {
+      *error_message = "libfranka: thread priority "s + std::to_string(priority) +
+                       " is outside of the allowed range [" + std::to_string(min_priority) +
+                       ", " + std::to_string(max_priority) + "].";
+    }
+    return false;
+  }
+  const int thread_priority = priority != 0 ? priority : max_priority;
 
   sched_param thread_param{};
   thread_param.sched_priority = thread_priority;
@@ -85,4 +127,182 @@ auto setCurrentThreadToHighestSchedulerPriority(std::string* error_message)  ->
 #endif
 }
 
+auto setCurrentThreadAffinity(const std::vector<int>& cpus, std::string* error_message) -> bool {
+#if defined(__linux__)
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (int cpu : cpus) {
+    if (cpu < 0 || cpu >= CPU_SETSIZE) {
+      if (error_message != nullptr) {
+        *error_message = "libfranka: invalid CPU "s + std::to_string(cpu) + ".";
+      }
+      return false;
+    }
+    CPU_SET(cpu, &cpu_set);
+  }
+  int error = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+  if (error != 0) {
+    if (error_message != nullptr) {
+      *error_message = "libfranka: unable to set CPU affinity: "s + std::strerror(error);
+    }
+    return false;
+  }
+  return true;
+#else
+  (void)cpus;
+  if (error_message != nullptr) {
+    *error_message = "libfranka: setting the CPU affinity is not supported on this platform.";
+  }
+  return false;
+#endif
+}
+
+auto parseCpuList(const std::string& cpu_list) -> std::vector<int> {
+  auto parse_cpu = [&](const std::string& cpu) {
+    if (cpu.empty() || !std::all_of(cpu.begin(), cpu.end(), ::isdigit)) {
+      throw std::invalid_argument("libfranka: invalid CPU list \""s + cpu_list + "\".");
+    }
+    return std::stoi(cpu);
+  };
+
+  std::vector<int> cpus;
+  std::istringstream stream(cpu_list);
+  std::string range;
+  while (std::getline(stream, range, ',')) {
+    range.erase(std::remove_if(range.begin(), range.end(), ::isspace), range.end());
+    if (range.empty()) {
+      continue;
+    }
+    size_t separator = range.find('-');
+    if (separator == std::string::npos) {
+      cpus.push_back(parse_cpu(range));
+      continue;
+    }
+    int first = parse_cpu(range.substr(0, separator));
+    int last = parse_cpu(range.substr(separator + 1));
+    if (last < first) {
+      throw std::invalid_argument("libfranka: invalid CPU list \""s + cpu_list + "\".");
+    }
+    for (int cpu = first; cpu <= last; cpu++) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+auto isolatedCpus() -> std::vector<int> {
+#if defined(__linux__)
+  std::ifstream isolated("/sys/devices/system/cpu/isolated", std::ios_base::in);
+  std::string cpu_list;
+  std::getline(isolated, cpu_list);
+  try {
+    return parseCpuList(cpu_list);
+  } catch (const std::invalid_argument&) {
+    return {};
+  }
+#else
+  return {};
+#endif
+}
+
+auto lockMemory(std::string* error_message) -> bool {
+#if defined(__linux__)
+  if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+    if (error_message != nullptr) {
+      *error_message = "libfranka: unable to lock memory: "s + std::strerror(errno);
+    }
+    return false;
+  }
+  return true;
+#else
+  if (error_message != nullptr) {
+    *error_message = "libfranka: locking memory is not supported on this platform.";
+  }
+  return false;
+#endif
+}
+
+void prefaultStack(size_t size) noexcept {
+#if defined(__linux__)
+  if (size == 0) {
+    return;
+  }
+  // Released again when returning. Functions calling alloca are never inlined by the compiler.
+  const auto page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  auto* stack = static_cast<volatile uint8_t*>(alloca(size));
+  for (size_t i = 0; i < size; i += page_size) {
+    stack[i] = 0;
+  }
+#else
+  (void)size;
+#endif
+}
+
+auto prefaultHeap(size_t size, std::string* error_message) -> bool {
+#if defined(__linux__)
+  if (size == 0) {
+    return true;
+  }
+  // Keep freed memory with the allocator and serve large allocations from the heap as well.
+  if (mallopt(M_TRIM_THRESHOLD, -1) == 0 || mallopt(M_MMAP_MAX, 0) == 0) {
+    if (error_message != nullptr) {
+      *error_message = "libfranka: unable to configure the allocator for prefaulting.";
+    }
+    return false;
+  }
+  auto* heap = static_cast<volatile uint8_t*>(std::malloc(size));
+  if (heap == nullptr) {
+    if (error_message != nullptr) {
+      *error_message = "libfranka: unable to allocate "s + std::to_string(size) +
+                       " bytes for prefaulting the heap.";
+    }
+    return false;
+  }
+  const auto page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  for (size_t i = 0; i < size; i += page_size) {
+    heap[i] = 0;
+  }
+  std::free(const_cast<uint8_t*>(heap));
+  return true;
+#else
+  (void)size;
+  if (error_message != nullptr) {
+    *error_message = "libfranka: prefaulting the heap is not supported on this platform.";
+  }
+  return false;
+#endif
+}
+
+void applyRealtimeConfig(const RealtimeConfig& config) {
+  std::string error_message;
+  auto check = [&](bool success) {
+    if (!success && config.enforce) {
+      throw RealtimeException(error_message);
+    }
+  };
+
+  if (!config.cpus.empty()) {
+    if (config.require_isolated_cpus) {
+      std::vector<int> isolated = isolatedCpus();
+      for (int cpu : config.cpus) {
+        if (std::find(isolated.begin(), isolated.end(), cpu) == isolated.end()) {
+          error_message = "libfranka: CPU "s + std::to_string(cpu) + " is not isolated.";
+          check(false);
+        }
+      }
+    }
+    check(setCurrentThreadAffinity(config.cpus, &error_message));
+  }
+  check(setCurrentThreadSchedulerPriority(config.priority, &error_message));
+  if (config.lock_memory) {
+    check(lockMemory(&error_message));
+  }
+  check(prefaultHeap(config.prefault_heap_size, &error_message));
+  prefaultStack(config.prefault_stack_size);
+
+  if (config.enforce && !hasRealtimeKernel()) {
+    throw RealtimeException("libfranka: Running kernel does not have realtime capabilities.");
+  }
+}
+
 }  // namespace franka
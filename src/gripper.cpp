@@ -3,6 +3,8 @@
 #include <franka/gripper.h>
 #include <franka/exception.h>
 #include <research_interface/gripper/types.h>
+#include <future>
+#include <memory>
 #include <sstream>
 
 #include "network.h"
@@ -11,11 +13,8 @@ namespace franka {
 
 namespace {
 
-template <typename T, typename... TArgs>
-auto executeCommand(Network& network, TArgs&&... args) -> bool {
-  uint32_t command_id = network.tcpSendRequest<T>(std::forward<TArgs>(args)...);
-  typename T::Response response = network.tcpBlockingReceiveResponse<T>(command_id);
-
+template <typename T>
+auto handleCommandResponse(const typename T::Response& response) -> bool {
   switch (response.status) {
     case T::Status::kSuccess:
       return true;
@@ -30,6 +29,27 @@ auto executeCommand(Network& network, TArgs&&... args) -> bool {
   }
 }
 
+template <typename T, typename... TArgs>
+auto executeCommand(Network& network, TArgs&&... args) -> bool {
+  uint32_t command_id = network.tcpSendRequest<T>(std::forward<TArgs>(args)...);
+  return handleCommandResponse<T>(network.tcpBlockingReceiveResponse<T>(command_id));
+}
+
+template <typename T, typename... TArgs>
+auto executeCommandAsync(Network& network, TArgs&&... args) -> std::future<bool> {
+  auto promise = std::make_shared<std::promise<bool>>();
+  std::future<bool> future = promise->get_future();
+
+  uint32_t command_id = network.tcpSendRequest<T>(std::forward<TArgs>(args)...);
+  network.tcpReceiveResponseAsync<T>(
+      command_id,
+      [promise](const typename T::Response& response) {
+        promise->set_value(handleCommandResponse<T>(response));
+      },
+      [promise](std::exception_ptr exception) { promise->set_exception(exception); });
+  return future;
+}
+
 auto convertGripperState(
     const research_interface::gripper::GripperState& gripper_state) noexcept -> GripperState {
   GripperState converted;
@@ -43,9 +63,10 @@ auto convertGripperState(
 
 }  // anonymous namespace
 
-Gripper::Gripper(const std::string& franka_address)
-    : network_{
-          std::make_unique<Network>(franka_address, research_interface::gripper::kCommandPort)} {
+Gripper::Gripper(const std::string& franka_address, const NetworkConfig& network_config)
+    : network_{std::make_unique<Network>(franka_address,
+                                         research_interface::gripper::kCommandPort,
+                                         network_config)} {
   connect<research_interface::gripper::Connect, research_interface::gripper::kVersion>(
       *network_, &ri_version_);
 }
@@ -62,6 +83,10 @@ auto Gripper::homing() const -> bool {
   return executeCommand<research_interface::gripper::Homing>(*network_);
 }
 
+auto Gripper::homingAsync() const -> std::future<bool> {
+  return executeCommandAsync<research_interface::gripper::Homing>(*network_);
+}
+
 auto Gripper::grasp(double width,
                     double speed,
                     double force,
@@ -72,21 +97,38 @@ auto Gripper::grasp(double width,
                                                             force);
 }
 
+auto Gripper::graspAsync(double width,
+                         double speed,
+                         double force,
+                         double epsilon_inner,
+                         double epsilon_outer) const -> std::future<bool> {
+  research_interface::gripper::Grasp::GraspEpsilon epsilon(epsilon_inner, epsilon_outer);
+  return executeCommandAsync<research_interface::gripper::Grasp>(*network_, width, epsilon, speed,
+                                                                 force);
+}
+
 auto Gripper::move(double width, double speed) const -> bool{
   return executeCommand<research_interface::gripper::Move>(*network_, width, speed);
 }
 
+auto Gripper::moveAsync(double width, double speed) const -> std::future<bool> {
+  return executeCommandAsync<research_interface::gripper::Move>(*network_, width, speed);
+}
+
 auto Gripper::stop() const -> bool {
   return executeCommand<research_interface::gripper::Stop>(*network_);
 }
 
+auto Gripper::stopAsync() const -> std::future<bool> {
+  return executeCommandAsync<research_interface::gripper::Stop>(*network_);
+}
+
 auto Gripper::readOnce() const -> GripperState {
-  research_interface::gripper::GripperState gripper_state;
+  research_interface::gripper::GripperState gripper_state{};
   // Delete old data from the UDP buffer.
-  while (network_->udpReceive<decltype(gripper_state)>(&gripper_state)) {
-  }
+  network_->udpReceiveLatest(&gripper_state);
 
-  gripper_state = network_->udpBlockingReceive<decltype(gripper_state)>();
+  network_->udpBlockingReceive(&gripper_state);
   return convertGripperState(gripper_state);
 }
 
@@ -0,0 +1,161 @@
+// Copyright (c) 2017 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include "io_thread_transport.h"
+
+#include <cstring>
+#include <utility>
+
+#include <franka/control_tools.h>
+#include <franka/exception.h>
+
+namespace franka {
+
+namespace {
+
+auto messageId(const uint8_t* datagram, size_t size) noexcept -> uint64_t {
+  uint64_t message_id = 0;
+  if (size >= sizeof(message_id)) {
+    std::memcpy(&message_id, datagram, sizeof(message_id));
+  }
+  return message_id;
+}
+
+}  // anonymous namespace
+
+IoThreadTransport::IoThreadTransport(std::unique_ptr<Transport> transport,
+                                     std::chrono::milliseconds udp_timeout,
+                                     const RealtimeConfig& realtime_config)
+    : transport_(std::move(transport)),
+      udp_timeout_(udp_timeout),
+      states_(kQueueCapacity, kMaxDatagramSize),
+      commands_(kQueueCapacity, kMaxDatagramSize),
+      buffer_(kMaxDatagramSize) {
+  std::promise<void> started;
+  std::future<void> start_result = started.get_future();
+  io_thread_ = std::thread([this, &realtime_config, &started] { run(realtime_config, &started); });
+  try {
+    start_result.get();
+  } catch (...) {
+    io_thread_.join();
+    throw;
+  }
+}
+
+IoThreadTransport::~IoThreadTransport() {
+  stopped_.store(true, std::memory_order_relaxed);
+  io_thread_.join();
+}
+
+void IoThreadTransport::run(const RealtimeConfig& realtime_config, std::promise<void>* started) {
+  try {
+    applyRealtimeConfig(realtime_config);
+  } catch (...) {
+    started->set_exception(std::current_exception());
+    return;
+  }
+  started->set_value();
+
+  try {
+    while (!stopped_.load(std::memory_order_relaxed)) {
+      std::chrono::system_clock::time_point receive_time{};
+      size_t size = 0;
+      try {
+        size = transport_->udpReceive(buffer_.data(), buffer_.size(), &receive_time);
+      } catch (const NetworkException&) {
+        // No state within the receive timeout. The caller reports this after its own timeout.
+        continue;
+      }
+      // Like the socket buffer, the queue drops states if the caller does not keep up.
+      states_.push(buffer_.data(), size, receive_time);
+      sendCommands(messageId(buffer_.data(), size));
+    }
+  } catch (...) {
+    exception_ = std::current_exception();
+    failed_.store(true, std::memory_order_release);
+  }
+}
+
+void IoThreadTransport::sendCommands(uint64_t state_message_id) {
+  const auto deadline = std::chrono::steady_clock::now() + kCommandWait;
+  size_t size = 0;
+  while (commands_.pop(buffer_.data(), buffer_.size(), &size, nullptr, deadline)) {
+    transport_->udpSend(buffer_.data(), size);
+    if (messageId(buffer_.data(), size) >= state_message_id) {
+      return;
+    }
+  }
+}
+
+void IoThreadTransport::throwIfFailed() {
+  if (failed_.load(std::memory_order_acquire)) {
+    std::rethrow_exception(exception_);
+  }
+}
+
+auto IoThreadTransport::udpPort() const noexcept -> uint16_t {
+  return transport_->udpPort();
+}
+
+auto IoThreadTransport::udpReceive(void* data,
+                                   size_t size,
+                                   std::chrono::system_clock::time_point* receive_time)
+    -> size_t {
+  throwIfFailed();
+  size_t datagram_size = 0;
+  if (!states_.pop(data, size, &datagram_size, receive_time,
+                   std::chrono::steady_clock::now() + udp_timeout_)) {
+    throwIfFailed();
+    throw NetworkException("libfranka: UDP receive: Timeout");
+  }
+  return datagram_size;
+}
+
+auto IoThreadTransport::udpReceiveBatch(uint8_t* buffer,
+                                        size_t datagram_size,
+                                        size_t max_count,
+                                        std::chrono::system_clock::time_point* receive_times)
+    -> size_t {
+  throwIfFailed();
+  size_t received = 0;
+  size_t size = 0;
+  while (received < max_count && states_.pop(&buffer[received * datagram_size], datagram_size,
+                                             &size, &receive_times[received])) {
+    if (size != datagram_size) {
+      throw ProtocolException("libfranka: incorrect object size");
+    }
+    received++;
+  }
+  return received;
+}
+
+void IoThreadTransport::udpSend(const void* data, size_t size) {
+  throwIfFailed();
+  commands_.push(data, size);
+}
+
+void IoThreadTransport::tcpSend(const void* data, size_t size) {
+  transport_->tcpSend(data, size);
+}
+
+auto IoThreadTransport::tcpPoll(std::chrono::microseconds timeout) -> bool {
+  return transport_->tcpPoll(timeout);
+}
+
+auto IoThreadTransport::tcpReceive(void* data, size_t size) -> size_t {
+  return transport_->tcpReceive(data, size);
+}
+
+void IoThreadTransport::tcpShutdown() noexcept {
+  transport_->tcpShutdown();
+}
+
+auto withUdpIoThread(std::unique_ptr<Transport> transport, const NetworkConfig& config)
+    -> std::unique_ptr<Transport> {
+  if (!config.udp_io_thread) {
+    return transport;
+  }
+  return std::make_unique<IoThreadTransport>(std::move(transport), config.udp_timeout,
+                                             config.udp_io_thread_realtime_config);
+}
+
+}  // namespace franka
@@ -0,0 +1,138 @@
+// Copyright (c) 2017 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#pragma once
+
+#include <franka/network_config.h>
+#include <franka/realtime_config.h>
+
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "shared_memory_channel.h"
+#include "transport.h"
+
+namespace franka {
+
+/**
+ * Transport which moves all datagram traffic of another transport to a dedicated I/O thread.
+ *
+ * The I/O thread blocks on receiving states and publishes them into a lock-free single-producer,
+ * single-consumer queue. Commands are published by the caller into a second queue, from which the
+ * I/O thread sends them. The thread calling udpReceive and udpSend therefore never performs a
+ * socket system call for datagrams, and only touches memory shared with the I/O thread.
+ *
+ * After publishing a state, the I/O thread waits up to #kCommandWait for the command answering
+ * it, i.e. a command whose message ID is at least the one of the state, before it receives the
+ * next state. Message IDs are read from the first 8 bytes of a datagram, as laid out by robot
+ * states and commands. Transports which never send commands, e.g. for a gripper, just pick up the
+ * next state after the wait.
+ *
+ * The command stream is passed through to the wrapped transport.
+ */
+class IoThreadTransport : public Transport {
+ public:
+  /**
+   * Maximum size of a state or command in bytes.
+   */
+  static constexpr size_t kMaxDatagramSize = SharedMemoryChannel::kMaxDatagramSize;
+
+  /**
+   * Number of states or commands which can be queued in each direction.
+   */
+  static constexpr size_t kQueueCapacity = SharedMemoryChannel::kDatagramQueueCapacity;
+
+  /**
+   * Maximum time the I/O thread waits for the command answering a state. Shorter than the
+   * 1 ms cycle of the robot, so that waiting never delays picking up the next state.
+   */
+  static constexpr std::chrono::microseconds kCommandWait{900};
+
+  /**
+   * Starts the I/O thread.
+   *
+   * @param[in] transport Transport whose datagrams are sent and received by the I/O thread.
+   * @param[in] udp_timeout Timeout for receiving a state with udpReceive.
+   * @param[in] realtime_config Realtime settings applied to the I/O thread.
+   *
+   * @throw RealtimeException if the realtime settings cannot be applied to the I/O thread.
+   */
+  IoThreadTransport(std::unique_ptr<Transport> transport,
+                    std::chrono::milliseconds udp_timeout,
+                    const RealtimeConfig& realtime_config);
+
+  /**
+   * Stops the I/O thread. Waits for at most the receive timeout of the wrapped transport.
+   */
+  ~IoThreadTransport() override;
+
+  [[nodiscard]] auto udpPort() const noexcept -> uint16_t override;
+
+  /**
+   * @throw NetworkException if no state arrived within the timeout, or if the I/O thread failed
+   * to send a command.
+   */
+  auto udpReceive(void* data, size_t size, std::chrono::system_clock::time_point* receive_time)
+      -> size_t override;
+  auto udpReceiveBatch(uint8_t* buffer,
+                       size_t datagram_size,
+                       size_t max_count,
+                       std::chrono::system_clock::time_point* receive_times) -> size_t override;
+
+  /**
+   * Like UDP, commands are dropped if the I/O thread does not keep up.
+   *
+   * @throw NetworkException if the I/O thread failed to send a previous command.
+   */
+  void udpSend(const void* data, size_t size) override;
+
+  void tcpSend(const void* data, size_t size) override;
+  auto tcpPoll(std::chrono::microseconds timeout) -> bool override;
+  auto tcpReceive(void* data, size_t size) -> size_t override;
+  void tcpShutdown() noexcept override;
+
+  IoThreadTransport(const IoThreadTransport&) = delete;
+  auto operator=(const IoThreadTransport&) -> IoThreadTransport& = delete;
+
+ private:
+  void run(const RealtimeConfig& realtime_config, std::promise<void>* started);
+  void sendCommands(uint64_t state_message_id);
+  void throwIfFailed();
+
+  std::unique_ptr<Transport> transport_;
+  const std::chrono::milliseconds udp_timeout_;
+
+  // Written by the I/O thread, read by the caller.
+  DatagramQueue states_;
+  // Written by the caller, read by the I/O thread.
+  DatagramQueue commands_;
+
+  std::atomic_bool stopped_{false};
+  std::atomic_bool failed_{false};
+  // Only written by the I/O thread before failed_ is set.
+  std::exception_ptr exception_;
+
+  // Used by the I/O thread only.
+  std::vector<uint8_t> buffer_;
+
+  std::thread io_thread_;
+};
+
+/**
+ * Wraps the given transport into an IoThreadTransport if NetworkConfig::udp_io_thread is set.
+ *
+ * @param[in] transport Transport to wrap.
+ * @param[in] config Network settings.
+ *
+ * @return The given or the wrapping transport.
+ *
+ * @throw RealtimeException if the realtime settings cannot be applied to the I/O thread.
+ */
+auto withUdpIoThread(std::unique_ptr<Transport> transport, const NetworkConfig& config)
+    -> std::unique_ptr<Transport>;
+
+}  // namespace franka
@@ -0,0 +1,181 @@
+// Copyright (c) 2017 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+
+#undef LIBFRANKA_AVX2
+#undef LIBFRANKA_NEON
+
+#if defined(__AVX2__)
+#define LIBFRANKA_AVX2
+#include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#define LIBFRANKA_NEON
+#include <arm_neon.h>
+#endif
+
+namespace franka {
+
+/**
+ * Values of the seven joints in eight lanes of doubles, the last lane being padding.
+ *
+ * Operations are done on two AVX2 or four NEON registers if the compiler targets these instruction
+ * sets, and lane by lane otherwise. Every operation is a single IEEE operation per lane, and min
+ * and max return the same operand as std::min and std::max, so results are bit-identical to the
+ * scalar code as long as the compiler does not contract multiplications and additions.
+ */
+class JointLanes {
+ public:
+  /**
+   * Sets all lanes to the given value.
+   */
+  explicit JointLanes(double value) noexcept {
+    for (Pack& pack : packs_) {
+      pack = broadcast(value);
+    }
+  }
+
+  /**
+   * Loads the joint values, setting the padding lane to the given value.
+   */
+  JointLanes(const std::array<double, 7>& values, double padding) noexcept {
+    std::array<double, kSize> lanes;
+    std::copy(values.begin(), values.end(), lanes.begin());
+    lanes[7] = padding;
+    for (size_t i = 0; i < kPacks; i++) {
+      packs_[i] = load(&lanes[i * kPackSize]);
+    }
+  }
+
+  /// @return Joint values, without the padding lane.
+  auto toArray() const noexcept -> std::array<double, 7> {
+    std::array<double, kSize> lanes;
+    for (size_t i = 0; i < kPacks; i++) {
+      store(&lanes[i * kPackSize], packs_[i]);
+    }
+    std::array<double, 7> values;
+    std::copy(lanes.begin(), lanes.begin() + 7, values.begin());
+    return values;
+  }
+
+  /// @return True if no lane is infinite or NaN.
+  auto allFinite() const noexcept -> bool {
+    bool finite = true;
+    for (const Pack& pack : packs_) {
+      finite &= isFinite(pack);
+    }
+    return finite;
+  }
+
+  friend auto operator+(const JointLanes& a, const JointLanes& b) noexcept -> JointLanes {
+    return apply(a, b, [](Pack x, Pack y) { return add(x, y); });
+  }
+
+  friend auto operator-(const JointLanes& a, const JointLanes& b) noexcept -> JointLanes {
+    return apply(a, b, [](Pack x, Pack y) { return subtract(x, y); });
+  }
+
+  friend auto operator*(const JointLanes& a, const JointLanes& b) noexcept -> JointLanes {
+    return apply(a, b, [](Pack x, Pack y) { return multiply(x, y); });
+  }
+
+  friend auto operator/(const JointLanes& a, const JointLanes& b) noexcept -> JointLanes {
+    return apply(a, b, [](Pack x, Pack y) { return divide(x, y); });
+  }
+
+  friend auto operator-(const JointLanes& a) noexcept -> JointLanes {
+    return apply(a, a, [](Pack x, Pack) { return negate(x); });
+  }
+
+  /// Lane-wise std::min(a, b).
+  friend auto min(const JointLanes& a, const JointLanes& b) noexcept -> JointLanes {
+    return apply(a, b, [](Pack x, Pack y) { return minimum(x, y); });
+  }
+
+  /// Lane-wise std::max(a, b).
+  friend auto max(const JointLanes& a, const JointLanes& b) noexcept -> JointLanes {
+    return apply(a, b, [](Pack x, Pack y) { return maximum(x, y); });
+  }
+
+ private:
+  static constexpr size_t kSize = 8;
+
+#if defined(LIBFRANKA_AVX2)
+  using Pack = __m256d;
+  static constexpr size_t kPackSize = 4;
+
+  static auto load(const double* data) noexcept -> Pack { return _mm256_loadu_pd(data); }
+  static void store(double* data, Pack x) noexcept { _mm256_storeu_pd(data, x); }
+  static auto broadcast(double value) noexcept -> Pack { return _mm256_set1_pd(value); }
+  static auto add(Pack x, Pack y) noexcept -> Pack { return _mm256_add_pd(x, y); }
+  static auto subtract(Pack x, Pack y) noexcept -> Pack { return _mm256_sub_pd(x, y); }
+  static auto multiply(Pack x, Pack y) noexcept -> Pack { return _mm256_mul_pd(x, y); }
+  static auto divide(Pack x, Pack y) noexcept -> Pack { return _mm256_div_pd(x, y); }
+  static auto negate(Pack x) noexcept -> Pack { return _mm256_xor_pd(x, _mm256_set1_pd(-0.0)); }
+  // _mm256_min_pd(a, b) is (a < b) ? a : b, while std::min(x, y) is (y < x) ? y : x.
+  static auto minimum(Pack x, Pack y) noexcept -> Pack { return _mm256_min_pd(y, x); }
+  static auto maximum(Pack x, Pack y) noexcept -> Pack { return _mm256_max_pd(y, x); }
+  // x - x is 0 for finite values and NaN otherwise.
+  static auto isFinite(Pack x) noexcept -> bool {
+    Pack difference = _mm256_sub_pd(x, x);
+    return _mm256_movemask_pd(_mm256_cmp_pd(difference, difference, _CMP_EQ_OQ)) == 0xF;
+  }
+#elif defined(LIBFRANKA_NEON)
+  using Pack = float64x2_t;
+  static constexpr size_t kPackSize = 2;
+
+  static auto load(const double* data) noexcept -> Pack { return vld1q_f64(data); }
+  static void store(double* data, Pack x) noexcept { vst1q_f64(data, x); }
+  static auto broadcast(double value) noexcept -> Pack { return vdupq_n_f64(value); }
+  static auto add(Pack x, Pack y) noexcept -> Pack { return vaddq_f64(x, y); }
+  static auto subtract(Pack x, Pack y) noexcept -> Pack { return vsubq_f64(x, y); }
+  static auto multiply(Pack x, Pack y) noexcept -> Pack { return vmulq_f64(x, y); }
+  static auto divide(Pack x, Pack y) noexcept -> Pack { return vdivq_f64(x, y); }
+  static auto negate(Pack x) noexcept -> Pack { return vnegq_f64(x); }
+  // vminq_f64 orders -0 before +0 and propagates NaN, unlike std::min, so compare and select.
+  static auto minimum(Pack x, Pack y) noexcept -> Pack { return vbslq_f64(vcltq_f64(y, x), y, x); }
+  static auto maximum(Pack x, Pack y) noexcept -> Pack { return vbslq_f64(vcltq_f64(x, y), y, x); }
+  // x - x is 0 for finite values and NaN otherwise.
+  static auto isFinite(Pack x) noexcept -> bool {
+    Pack difference = vsubq_f64(x, x);
+    return vminvq_u32(vreinterpretq_u32_u64(vceqq_f64(difference, difference))) == 0xFFFFFFFF;
+  }
+#else
+  using Pack = double;
+  static constexpr size_t kPackSize = 1;
+
+  static auto load(const double* data) noexcept -> Pack { return *data; }
+  static void store(double* data, Pack x) noexcept { *data = x; }
+  static auto broadcast(double value) noexcept -> Pack { return value; }
+  static auto add(Pack x, Pack y) noexcept -> Pack { return x + y; }
+  static auto subtract(Pack x, Pack y) noexcept -> Pack { return x - y; }
+  static auto multiply(Pack x, Pack y) noexcept -> Pack { return x * y; }
+  static auto divide(Pack x, Pack y) noexcept -> Pack { return x / y; }
+  static auto negate(Pack x) noexcept -> Pack { return -x; }
+  static auto minimum(Pack x, Pack y) noexcept -> Pack { return std::min(x, y); }
+  static auto maximum(Pack x, Pack y) noexcept -> Pack { return std::max(x, y); }
+  static auto isFinite(Pack x) noexcept -> bool { return std::isfinite(x); }
+#endif
+
+  static constexpr size_t kPacks = kSize / kPackSize;
+
+  JointLanes() noexcept = default;
+
+  template <typename Operation>
+  static auto apply(const JointLanes& a, const JointLanes& b, Operation operation) noexcept
+      -> JointLanes {
+    JointLanes result;
+    for (size_t i = 0; i < kPacks; i++) {
+      result.packs_[i] = operation(a.packs_[i], b.packs_[i]);
+    }
+    return result;
+  }
+
+  std::array<Pack, kPacks> packs_;
+};
+
+}  // namespace franka
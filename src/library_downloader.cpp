@@ -9,7 +9,6 @@
 #include <exception>
 #include <fstream>
 #include <string>
-#include <vector>
 
 #include "platform.h"
 #include "library_downloader.h"
@@ -45,18 +44,26 @@ LibraryDownloader::LibraryDownloader(Network& network)
   throw ModelException("libfranka: Unsupported operating system!");
 #endif
 
-  uint32_t command_id = network.tcpSendRequest<LoadModelLibrary>(architecture, operating_system);
-  std::vector<uint8_t> buffer;
+  // The library is written to the file while it is being received, so that it is never held in
+  // memory as a whole.
+  std::ofstream model_library_stream(path().c_str(), std::ios_base::out | std::ios_base::binary);
+  if (!model_library_stream) {
+    throw ModelException("libfranka: Cannot save model library.");
+  }
+  uint32_t command_id = network.tcpSendRequestStreaming<LoadModelLibrary>(
+      [&model_library_stream](const uint8_t* data, size_t size) {
+        model_library_stream.write(reinterpret_cast<const char*>(data),
+                                   static_cast<std::streamsize>(size));
+      },
+      architecture, operating_system);
   LoadModelLibrary::Response response =
-      network.tcpBlockingReceiveResponse<LoadModelLibrary>(command_id, &buffer);
+      network.tcpBlockingReceiveResponse<LoadModelLibrary>(command_id);
   if (response.status != LoadModelLibrary::Status::kSuccess) {
     throw ModelException("libfranka: Server reports error when loading model library.");
   }
 
-  try {
-    std::ofstream model_library_stream(path().c_str(), std::ios_base::out | std::ios_base::binary);
-    model_library_stream.write(reinterpret_cast<char*>(buffer.data()), buffer.size());
-  } catch (const std::exception& ex) {
+  model_library_stream.close();
+  if (!model_library_stream) {
     throw ModelException("libfranka: Cannot save model library.");
   }
 }
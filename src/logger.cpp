@@ -5,6 +5,17 @@
 
 namespace franka {
 
+auto convertRobotCommand(const research_interface::robot::RobotCommand& command) noexcept
+    -> RobotCommand {
+  RobotCommand converted;
+  converted.joint_positions.q = command.motion.q_c;
+  converted.joint_velocities.dq = command.motion.dq_c;
+  converted.cartesian_pose.O_T_EE = command.motion.O_T_EE_c;
+  converted.cartesian_velocities.O_dP_EE = command.motion.O_dP_EE_c;
+  converted.torques.tau_J = command.control.tau_J_d;
+  return converted;
+}
+
 Logger::Logger(size_t log_size) : log_size_(log_size) {
   states_.resize(log_size);
   commands_.resize(log_size);
@@ -28,16 +39,9 @@ auto Logger::flush() -> std::vector<Record>{
   for (size_t i = 0; i < ring_size_; i++) {
     size_t wrapped_index = (ring_front_ + i) % ring_size_;
 
-    RobotCommand command;
-    command.joint_positions.q = commands_[wrapped_index].motion.q_c;
-    command.joint_velocities.dq = commands_[wrapped_index].motion.dq_c;
-    command.cartesian_pose.O_T_EE = commands_[wrapped_index].motion.O_T_EE_c;
-    command.cartesian_velocities.O_dP_EE = commands_[wrapped_index].motion.O_dP_EE_c;
-    command.torques.tau_J = commands_[wrapped_index].control.tau_J_d;
-
     Record record;
     record.state = states_[wrapped_index];
-    record.command = command;
+    record.command = convertRobotCommand(commands_[wrapped_index]);
     log.push_back(record);
   }
 
@@ -11,6 +11,12 @@
 
 namespace franka {
 
+/**
+ * Converts a command as sent to the robot into the command type of a Record.
+ */
+auto convertRobotCommand(const research_interface::robot::RobotCommand& command) noexcept
+    -> RobotCommand;
+
 class Logger {
  public:
   explicit Logger(size_t log_size);
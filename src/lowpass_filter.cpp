@@ -9,6 +9,16 @@
 namespace franka {
 
 auto lowpassFilter(double sample_time, double y, double y_last, double cutoff_frequency) -> double {
+  double gain = lowpassFilterGain(sample_time, cutoff_frequency);
+  if (!std::isfinite(y) || !std::isfinite(y_last)) {
+    throw std::invalid_argument(
+        "lowpass-filter: current or past input value of the signal to be filtered is infinite or "
+        "NaN.");
+  }
+  return lowpassFilter(gain, y, y_last);
+}
+
+auto lowpassFilterGain(double sample_time, double cutoff_frequency) -> double {
   if (sample_time < 0 || !std::isfinite(sample_time)) {
     throw std::invalid_argument("lowpass-filter: sample_time is negative, infinite or NaN.");
   }
@@ -16,13 +26,7 @@ auto lowpassFilter(double sample_time, double y, double y_last, double cutoff_fr
     throw std::invalid_argument(
         "lowpass-filter: cutoff_frequency is zero, negative, infinite or NaN.");
   }
-  if (!std::isfinite(y) || !std::isfinite(y_last)) {
-    throw std::invalid_argument(
-        "lowpass-filter: current or past input value of the signal to be filtered is infinite or "
-        "NaN.");
-  }
-  double gain = sample_time / (sample_time + (1.0 / (2.0 * M_PI * cutoff_frequency)));
-  return gain * y + (1 - gain) * y_last;
+  return sample_time / (sample_time + (1.0 / (2.0 * M_PI * cutoff_frequency)));
 }
 
 auto cartesianLowpassFilter(double sample_time,
@@ -44,12 +48,18 @@ auto cartesianLowpassFilter(double sample_time,
           "infinite or NaN.");
     }
   }
+  return cartesianLowpassFilter(
+      sample_time / (sample_time + (1.0 / (2.0 * M_PI * cutoff_frequency))), y, y_last);
+}
+
+auto cartesianLowpassFilter(double gain,
+                            const std::array<double, 16>& y,
+                            const std::array<double, 16>& y_last) -> std::array<double, 16> {
   Eigen::Affine3d transform(Eigen::Matrix4d::Map(y.data()));
   Eigen::Affine3d transform_last(Eigen::Matrix4d::Map(y_last.data()));
   Eigen::Quaterniond orientation(transform.linear());
   Eigen::Quaterniond orientation_last(transform_last.linear());
 
-  double gain = sample_time / (sample_time + (1.0 / (2.0 * M_PI * cutoff_frequency)));
   transform.translation() =
       gain * transform.translation() + (1.0 - gain) * transform_last.translation();
   orientation = orientation_last.slerp(gain, orientation);
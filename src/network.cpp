@@ -1,12 +1,13 @@
 // Copyright (c) 2017 Franka Emika GmbH
 // Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include "network.h"
+
 #include <memory>
-#include <sstream>
 #include <string>
 #include <tuple>
-#include "network.h"
 
-using namespace std::string_literals;
+#include "io_thread_transport.h"
+#include "socket_transport.h"
 
 namespace franka {
 
@@ -14,70 +15,168 @@ Network::Network(const std::string& franka_address,
                  uint16_t franka_port,
                  std::chrono::milliseconds tcp_timeout,
                  std::chrono::milliseconds udp_timeout,
-                 std::tuple<bool, int, int, int> tcp_keepalive) {
-  try {
-    Poco::Timespan poco_timeout(1000l * tcp_timeout.count());
-    Poco::Net::SocketAddress address(franka_address, franka_port);
+                 std::tuple<bool, int, int, int> tcp_keepalive)
+    : Network(franka_address, franka_port, [&] {
+        NetworkConfig config;
+        config.tcp_timeout = tcp_timeout;
+        config.udp_timeout = udp_timeout;
+        std::tie(config.tcp_keepalive, config.tcp_keepalive_idle, config.tcp_keepalive_count,
+                 config.tcp_keepalive_interval) = tcp_keepalive;
+        return config;
+      }()) {}
 
-    tcp_socket_.connect(address, poco_timeout);
-    tcp_socket_.setBlocking(true);
-    tcp_socket_.setSendTimeout(poco_timeout);
-    tcp_socket_.setReceiveTimeout(poco_timeout);
+Network::Network(const std::string& franka_address,
+                 uint16_t franka_port,
+                 const NetworkConfig& config)
+    : Network(withUdpIoThread(
+                  std::make_unique<SocketTransport>(franka_address, franka_port, config), config),
+              config.tcp_timeout) {}
 
-    if (std::get<0>(tcp_keepalive)) {
-      tcp_socket_.setKeepAlive(true);
-      try {
-      //*----- fix for apple by g alexander 02/26/20----*//
-      //* add -DAPPLE to CXXFLAGS
-        #if defined (APPLE)
-          tcp_socket_.setOption(IPPROTO_TCP, TCP_KEEPALIVE, std::get<1>(tcp_keepalive));
-        #else
-          tcp_socket_.setOption(IPPROTO_TCP, TCP_KEEPIDLE, std::get<1>(tcp_keepalive));
-        #endif
-        tcp_socket_.setOption(IPPROTO_TCP, TCP_KEEPCNT, std::get<2>(tcp_keepalive));
-        tcp_socket_.setOption(IPPROTO_TCP, TCP_KEEPINTVL, std::get<3>(tcp_keepalive));
-      } catch (...) {
-      }
-    }
+Network::Network(std::unique_ptr<Transport> transport, std::chrono::milliseconds tcp_timeout)
+    : transport_(std::move(transport)), tcp_timeout_(tcp_timeout) {
+  pending_response_.reserve(kResponseBufferSize);
+}
 
-    udp_socket_.bind({"0.0.0.0", 0});
-    udp_socket_.setReceiveTimeout(Poco::Timespan{1000l * udp_timeout.count()});
-    udp_port_ = udp_socket_.address().port();
-  } catch (const Poco::Net::NetException& e) {
-    throw NetworkException("libfranka: Connection error: "s + e.what());
-  } catch (const Poco::TimeoutException& e) {
-    throw NetworkException("libfranka: Connection timeout"s);
-  } catch (const Poco::Exception& e) {
-    throw NetworkException("libfranka: "s + e.what());
+Network::~Network() {
+  tcp_reader_stopped_ = true;
+  transport_->tcpShutdown();
+  if (tcp_reader_.joinable()) {
+    tcp_reader_.join();
   }
 }
 
-Network::~Network() {
+auto Network::udpPort() const noexcept -> uint16_t {
+  return transport_->udpPort();
+}
+
+auto Network::tcpTimeout() const noexcept -> std::chrono::milliseconds {
+  return tcp_timeout_;
+}
+
+void Network::tcpThrowIfConnectionClosed() {
+  if (!tcp_reader_failed_) {
+    return;
+  }
+  std::lock_guard<std::mutex> _(tcp_response_mutex_);
+  std::rethrow_exception(tcp_reader_exception_);
+}
+
+void Network::tcpReaderLoop() {
+  std::exception_ptr exception;
   try {
-    tcp_socket_.shutdown();
+    while (!tcp_reader_stopped_) {
+      tcpReadFromBuffer(kTcpReaderPollTimeout);
+    }
+    exception = std::make_exception_ptr(NetworkException("libfranka: connection closed"));
   } catch (...) {
+    exception = std::current_exception();
+  }
+
+  decltype(response_callbacks_) response_callbacks;
+  {
+    std::lock_guard<std::mutex> _(tcp_response_mutex_);
+    tcp_reader_exception_ = exception;
+    response_callbacks.swap(response_callbacks_);
+  }
+  tcp_reader_failed_ = true;
+  tcp_response_received_.notify_all();
+
+  for (const auto& callbacks : response_callbacks) {
+    callbacks.second.on_error(exception);
   }
 }
 
-auto Network::udpPort() const noexcept -> uint16_t {
-  return udp_port_;
+void Network::invokeResponseCallbacks(const ResponseCallbacks& callbacks,
+                                      const std::vector<uint8_t>& buffer) {
+  try {
+    callbacks.on_response(buffer);
+  } catch (...) {
+    callbacks.on_error(std::current_exception());
+  }
 }
 
-void Network::tcpThrowIfConnectionClosed() try {
-  std::unique_lock<std::mutex> lock(tcp_mutex_, std::try_to_lock);
-  if (!lock.owns_lock()) {
+void Network::tcpReadFromBuffer(std::chrono::microseconds timeout) {
+  if (!transport_->tcpPoll(timeout)) {
     return;
   }
-  if (tcp_socket_.poll(0, Poco::Net::Socket::SELECT_READ)) {
-    std::array<uint8_t, 1> buffer;
-    int rv = tcp_socket_.receiveBytes(buffer.data(), static_cast<int>(buffer.size()), MSG_PEEK);
 
-    if (rv == 0) {
-      throw NetworkException("libfranka: server closed connection");
+  if (pending_stream_remaining_ > 0 && pending_response_offset_ == pending_response_.size()) {
+    // Variable-length data of a streamed response is passed on chunk by chunk.
+    stream_chunk_.resize(kStreamChunkSize);
+    size_t bytes_received = transport_->tcpReceive(
+        stream_chunk_.data(), std::min(pending_stream_remaining_, stream_chunk_.size()));
+    pending_stream_remaining_ -= bytes_received;
+    if (pending_stream_) {
+      try {
+        pending_stream_(stream_chunk_.data(), bytes_received);
+      } catch (...) {
+        // The remaining data still has to be read to reach the next message.
+        pending_stream_ = nullptr;
+        pending_stream_exception_ = std::current_exception();
+      }
+    }
+  } else {
+    // Reads at most up to the end of the current header or message, so that bytes of the
+    // following message stay in the socket buffer.
+    size_t expected_size = pending_response_offset_ < tcp_header_size_ ? tcp_header_size_
+                                                                        : pending_response_.size();
+    if (pending_response_.size() < expected_size) {
+      pending_response_.resize(expected_size);
+    }
+    pending_response_offset_ += transport_->tcpReceive(
+        &pending_response_[pending_response_offset_], expected_size - pending_response_offset_);
+
+    if (pending_response_offset_ == tcp_header_size_ && expected_size == tcp_header_size_) {
+      uint32_t size;
+      std::memcpy(&size, &pending_response_[tcp_size_offset_], sizeof(size));
+      if (size < tcp_header_size_) {
+        throw ProtocolException("libfranka: Incorrect TCP message size.");
+      }
+
+      uint32_t command_id;
+      std::memcpy(&command_id, &pending_response_[tcp_command_id_offset_], sizeof(command_id));
+      std::unique_lock<std::mutex> lock(tcp_response_mutex_);
+      auto stream = response_streams_.find(command_id);
+      if (stream != response_streams_.end() && size > stream->second.fixed_size) {
+        pending_response_.resize(stream->second.fixed_size);
+        pending_stream_ = std::move(stream->second.on_data);
+        pending_stream_remaining_ = size - stream->second.fixed_size;
+      } else {
+        pending_response_.resize(size);
+      }
+      if (stream != response_streams_.end()) {
+        response_streams_.erase(stream);
+      }
+    }
+  }
+
+  if (pending_response_offset_ == pending_response_.size() && pending_stream_remaining_ == 0) {
+    uint32_t command_id;
+    std::memcpy(&command_id, &pending_response_[tcp_command_id_offset_], sizeof(command_id));
+    std::unique_lock<std::mutex> lock(tcp_response_mutex_);
+    auto callbacks = response_callbacks_.find(command_id);
+    if (callbacks != response_callbacks_.end()) {
+      ResponseCallbacks response_callbacks = std::move(callbacks->second);
+      response_callbacks_.erase(callbacks);
+      lock.unlock();
+      if (pending_stream_exception_ != nullptr) {
+        response_callbacks.on_error(pending_stream_exception_);
+      } else {
+        invokeResponseCallbacks(response_callbacks, pending_response_);
+      }
+    } else {
+      if (pending_stream_exception_ != nullptr) {
+        stream_exceptions_[command_id] = pending_stream_exception_;
+      }
+      received_responses_.insert(command_id, &pending_response_);
+      lock.unlock();
+      tcp_response_received_.notify_all();
     }
+    pending_response_.clear();
+    pending_response_offset_ = 0;
+    pending_stream_ = nullptr;
+    pending_stream_exception_ = nullptr;
   }
-} catch (const Poco::Exception& e) {
-  throw NetworkException("libfranka: "s + e.what());
 }
 
 }  // namespace franka
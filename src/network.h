@@ -2,24 +2,32 @@
 // Use of this source code is governed by the Apache-2.0 license, see LICENSE
 #pragma once
 #include <franka/exception.h>
-#include <Poco/Net/DatagramSocket.h>
-#include <Poco/Net/NetException.h>
-#include <Poco/Net/StreamSocket.h>
+#include <franka/network_config.h>
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <chrono>
 #include <cmath>
+#include <condition_variable>
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
+#include <exception>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <thread>
 #include <tuple>
+#include <type_traits>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "response_table.h"
+#include "transport.h"
+
 namespace franka {
 
 class Network {
@@ -29,24 +37,99 @@ class Network {
           std::chrono::milliseconds tcp_timeout = std::chrono::seconds(60),
           std::chrono::milliseconds udp_timeout = std::chrono::seconds(1),
           std::tuple<bool, int, int, int> tcp_keepalive = std::make_tuple(true, 1, 3, 1));
+  Network(const std::string& franka_address, uint16_t franka_port, const NetworkConfig& config);
+
+  /**
+   * Speaks the protocol over the given transport, e.g. an in-process channel to a simulator.
+   *
+   * @param[in] transport Connected transport.
+   * @param[in] tcp_timeout Maximum time to wait for the response to the connection request.
+   */
+  explicit Network(std::unique_ptr<Transport> transport,
+                   std::chrono::milliseconds tcp_timeout = std::chrono::seconds(60));
   ~Network();
 
   [[nodiscard]] auto udpPort() const noexcept -> uint16_t;
 
+  /**
+   * @return Maximum time to wait for the response to the connection request.
+   */
+  [[nodiscard]] auto tcpTimeout() const noexcept -> std::chrono::milliseconds;
+
   template <typename T>
   auto udpBlockingReceive() -> T;
 
+  /**
+   * Blocks until a datagram has been received and writes it directly into the given storage.
+   *
+   * @param[out] data Caller-owned storage for the received datagram.
+   * @param[out] receive_time If given, host time at which the datagram has been received. On Linux,
+   * this is the kernel receive timestamp of the datagram.
+   */
+  template <typename T>
+  void udpBlockingReceive(T* data, std::chrono::system_clock::time_point* receive_time = nullptr);
+
   template <typename T>
   auto udpReceive(T* data) -> bool;
 
+  /**
+   * Receives all datagrams currently queued on the UDP socket without blocking and keeps the one
+   * with the most recent message ID.
+   *
+   * Queued datagrams are received in batches of up to Transport::kMaxReceiveBatchSize. On Linux,
+   * each batch takes a single system call.
+   *
+   * @param[in,out] latest Most recent message known to the caller. Overwritten if a datagram with
+   * a higher message ID has been received.
+   * @param[out] receive_time If given, overwritten together with latest by the host time at which
+   * the datagram has been received.
+   *
+   * @return Number of datagrams received.
+   */
+  template <typename T>
+  auto udpReceiveLatest(T* latest, std::chrono::system_clock::time_point* receive_time = nullptr)
+      -> size_t;
+
+  /**
+   * Like udpReceiveLatest(T*, std::chrono::system_clock::time_point*), but additionally invokes
+   * on_received for every received datagram, including the ones which are not kept.
+   *
+   * @param[in,out] latest Most recent message known to the caller.
+   * @param[out] receive_time If given, host time at which latest has been received.
+   * @param[in] on_received Callable invoked with each datagram and its host receive time.
+   *
+   * @return Number of datagrams received.
+   */
+  template <typename T, typename Callback>
+  auto udpReceiveLatest(T* latest,
+                        std::chrono::system_clock::time_point* receive_time,
+                        Callback&& on_received) -> size_t;
+
+  /**
+   * Allocates the storage used by udpReceiveLatest for datagrams of type T, so that receiving
+   * them in a control loop does not allocate.
+   */
+  template <typename T>
+  void udpReserveReceiveLatest();
+
   template <typename T>
   void udpSend(const T& data);
 
+  /**
+   * Throws the error encountered by the TCP reader thread, e.g. because the server closed the
+   * connection. Does nothing if the connection is still healthy.
+   *
+   * @throw NetworkException if the connection has been closed or reading from it failed.
+   * @throw ProtocolException if a malformed message has been received.
+   */
   void tcpThrowIfConnectionClosed();
 
   /**
    * Blocks until a T::Response message with the given command ID has been received.
    *
+   * Responses are read by a dedicated thread, which wakes up waiting callers as soon as a complete
+   * message has arrived.
+   *
    * Additional variable-length data for the expected response (if any) is written into the given
    * vl_buffer. If vl_buffer is not given, this data is discarded.
    *
@@ -60,9 +143,27 @@ class Network {
   auto tcpBlockingReceiveResponse(uint32_t command_id,
                                                   std::vector<uint8_t>* vl_buffer = nullptr) -> typename T::Response;
 
+  /**
+   * Like tcpBlockingReceiveResponse(uint32_t, std::vector<uint8_t>*), but gives up after the
+   * given timeout.
+   *
+   * @param[in] command_id Expected command ID of the T::Response.
+   * @param[in] timeout Maximum time to wait.
+   *
+   * @return Received T::Response instance.
+   *
+   * @throw NetworkException if no response has been received within the timeout.
+   */
+  template <typename T>
+  auto tcpBlockingReceiveResponse(uint32_t command_id, std::chrono::milliseconds timeout) ->
+      typename T::Response;
+
   /**
    * Tries to receive a T::Response message with the given command ID (non-blocking).
    *
+   * Only looks up responses already assembled by the TCP reader thread and never touches the
+   * socket.
+   *
    * Additional variable-length data for the expected response (if any) is discarded.
    *
    * @param[in] command_id Expected command ID of the T::Response.
@@ -75,203 +176,383 @@ class Network {
   auto tcpReceiveResponse(uint32_t command_id,
                           std::function<void(const typename T::Response&)> handler) -> bool;
 
+  /**
+   * Calls one of the given callbacks once a T::Response message with the given command ID has been
+   * received, without blocking.
+   *
+   * The callbacks are invoked from the TCP reader thread, or from the calling thread if the
+   * response has already been received or the connection has already failed. Additional
+   * variable-length data (if any) is discarded.
+   *
+   * @param[in] command_id Expected command ID of the T::Response.
+   * @param[in] on_response Callback to be invoked with the received response.
+   * @param[in] on_error Callback to be invoked if the response could not be received, or if
+   * on_response has thrown.
+   */
+  template <typename T>
+  void tcpReceiveResponseAsync(uint32_t command_id,
+                               std::function<void(const typename T::Response&)> on_response,
+                               std::function<void(std::exception_ptr)> on_error);
+
   template <typename T, typename... TArgs>
   auto tcpSendRequest(TArgs&&... args) -> uint32_t;
 
+  /**
+   * Sends a T request whose response carries variable-length data, which is passed to on_data in
+   * chunks as it arrives instead of being stored.
+   *
+   * on_data is invoked from the TCP reader thread. If it throws, the remaining data is discarded
+   * and tcpBlockingReceiveResponse rethrows the exception instead of returning the response. The
+   * fixed-size part of the response is received with tcpBlockingReceiveResponse as usual.
+   *
+   * @param[in] on_data Callback to be invoked with each chunk of variable-length data.
+   * @param[in] args Arguments for the T::Request.
+   *
+   * @return Command ID of the request.
+   */
+  template <typename T, typename... TArgs>
+  auto tcpSendRequestStreaming(std::function<void(const uint8_t*, size_t)> on_data,
+                               TArgs&&... args) -> uint32_t;
+
  private:
   template <typename T>
-  auto udpBlockingReceiveUnsafe() -> T;
+  void udpBlockingReceiveUnsafe(T* data, std::chrono::system_clock::time_point* receive_time);
 
   template <typename T>
+  auto tcpReceiveResponseUntil(uint32_t command_id,
+                               std::vector<uint8_t>* vl_buffer,
+                               const std::chrono::steady_clock::time_point* deadline) ->
+      typename T::Response;
+
+  template <typename T>
+  void tcpStartReader();
+  struct ResponseCallbacks {
+    std::function<void(const std::vector<uint8_t>&)> on_response;
+    std::function<void(std::exception_ptr)> on_error;
+  };
+
+  static void invokeResponseCallbacks(const ResponseCallbacks& callbacks,
+                                      const std::vector<uint8_t>& buffer);
+
+  struct ResponseStream {
+    // Size of the response without variable-length data.
+    size_t fixed_size;
+    std::function<void(const uint8_t*, size_t)> on_data;
+  };
+
+  /**
+   * Sends a T request and starts the TCP reader thread if necessary.
+   *
+   * @param[in] stream If given, registered for the command ID before the request is sent, so that
+   * variable-length data of the response is streamed to it.
+   * @param[in] args Arguments for the T::Request.
+   *
+   * @return Command ID of the request.
+   */
+  template <typename T, typename... TArgs>
+  auto tcpSendRequestWithStream(ResponseStream* stream, TArgs&&... args) -> uint32_t;
+
+  void tcpReaderLoop();
   void tcpReadFromBuffer(std::chrono::microseconds timeout);
 
-  Poco::Net::StreamSocket tcp_socket_;
-  Poco::Net::DatagramSocket udp_socket_;
-  Poco::Net::SocketAddress udp_server_address_;
-  uint16_t udp_port_;
+  static constexpr std::chrono::milliseconds kTcpReaderPollTimeout{100};
+
+  // Preallocated storage for unclaimed responses, so that receiving responses to commands like
+  // Move does not allocate. Responses with variable-length data may still grow a buffer.
+  static constexpr size_t kResponseTableCapacity = 16;
+  static constexpr size_t kResponseBufferSize = 256;
+  static constexpr size_t kStreamChunkSize = 64 * 1024;
+
+  std::unique_ptr<Transport> transport_;
+  const std::chrono::milliseconds tcp_timeout_;
+  std::vector<uint8_t> udp_batch_buffer_{};
+  std::array<std::chrono::system_clock::time_point, Transport::kMaxReceiveBatchSize>
+      udp_batch_receive_times_{};
 
   std::mutex tcp_mutex_;
   std::mutex udp_mutex_;
 
   uint32_t command_id_{0};
 
+  // Header layout of the protocol spoken on this connection, set when the reader is started.
+  size_t tcp_header_size_{0};
+  size_t tcp_command_id_offset_{0};
+  size_t tcp_size_offset_{0};
+
+  // Only accessed by the TCP reader thread.
   std::vector<uint8_t> pending_response_{};
   size_t pending_response_offset_ = 0;
-  uint32_t pending_command_id_ = 0;
-  std::unordered_map<uint32_t, std::vector<uint8_t>> received_responses_{};
+  std::function<void(const uint8_t*, size_t)> pending_stream_{};
+  size_t pending_stream_remaining_ = 0;
+  std::exception_ptr pending_stream_exception_{};
+  std::vector<uint8_t> stream_chunk_{};
+
+  // Guards received_responses_ and tcp_reader_exception_.
+  std::mutex tcp_response_mutex_;
+  std::condition_variable tcp_response_received_;
+  // Some commands (e.g. Move) answer with several responses carrying the same command ID, which
+  // are kept in the order of arrival.
+  ResponseTable received_responses_{kResponseTableCapacity, kResponseBufferSize};
+  std::unordered_map<uint32_t, ResponseCallbacks> response_callbacks_{};
+  std::unordered_map<uint32_t, ResponseStream> response_streams_{};
+  // Exceptions thrown by the on_data callback of a streamed response, by command ID.
+  std::unordered_map<uint32_t, std::exception_ptr> stream_exceptions_{};
+  std::exception_ptr tcp_reader_exception_{};
+  std::atomic_bool tcp_reader_failed_{false};
+  std::atomic_bool tcp_reader_stopped_{false};
+  std::thread tcp_reader_;
 };
 
 template <typename T>
 auto Network::udpReceive(T* data) -> bool{
   std::lock_guard<std::mutex> _(udp_mutex_);
 
-  if (udp_socket_.available() >= static_cast<int>(sizeof(T))) {
-    *data = udpBlockingReceiveUnsafe<T>();
-    return true;
-  }
-  return false;
+  std::chrono::system_clock::time_point receive_time;
+  return transport_->udpReceiveBatch(reinterpret_cast<uint8_t*>(data), sizeof(T), 1,
+                                     &receive_time) == 1;
 }
 
 template <typename T>
-auto Network::udpBlockingReceive() -> T {
+auto Network::udpReceiveLatest(T* latest, std::chrono::system_clock::time_point* receive_time)
+    -> size_t {
+  return udpReceiveLatest(latest, receive_time,
+                          [](const T&, std::chrono::system_clock::time_point) {});
+}
+
+template <typename T, typename Callback>
+auto Network::udpReceiveLatest(T* latest,
+                               std::chrono::system_clock::time_point* receive_time,
+                               Callback&& on_received) -> size_t {
   std::lock_guard<std::mutex> _(udp_mutex_);
-  return udpBlockingReceiveUnsafe<T>();
+
+  // Does not allocate if udpReserveReceiveLatest<T>() has been called before.
+  udp_batch_buffer_.resize(Transport::kMaxReceiveBatchSize * sizeof(T));
+
+  size_t received = 0;
+  size_t batch_size = 0;
+  do {
+    batch_size = transport_->udpReceiveBatch(udp_batch_buffer_.data(), sizeof(T),
+                                             Transport::kMaxReceiveBatchSize,
+                                             udp_batch_receive_times_.data());
+    for (size_t i = 0; i < batch_size; i++) {
+      const T* data = reinterpret_cast<const T*>(&udp_batch_buffer_[i * sizeof(T)]);
+      on_received(*data, udp_batch_receive_times_[i]);
+      if (data->message_id > latest->message_id) {
+        *latest = *data;
+        if (receive_time != nullptr) {
+          *receive_time = udp_batch_receive_times_[i];
+        }
+      }
+    }
+    received += batch_size;
+  } while (batch_size == Transport::kMaxReceiveBatchSize);
+  return received;
 }
 
 template <typename T>
-auto Network::udpBlockingReceiveUnsafe() -> T try {
-  std::array<uint8_t, sizeof(T)> buffer;
+void Network::udpReserveReceiveLatest() {
+  std::lock_guard<std::mutex> _(udp_mutex_);
+  udp_batch_buffer_.resize(Transport::kMaxReceiveBatchSize * sizeof(T));
+}
+
+template <typename T>
+auto Network::udpBlockingReceive() -> T {
+  T data;
+  udpBlockingReceive(&data);
+  return data;
+}
 
-  int bytes_received =
-      udp_socket_.receiveFrom(buffer.data(), static_cast<int>(buffer.size()), udp_server_address_);
+template <typename T>
+void Network::udpBlockingReceive(T* data, std::chrono::system_clock::time_point* receive_time) {
+  std::lock_guard<std::mutex> _(udp_mutex_);
+  udpBlockingReceiveUnsafe(data, receive_time);
+}
 
-  if (bytes_received != buffer.size()) {
+template <typename T>
+void Network::udpBlockingReceiveUnsafe(T* data,
+                                       std::chrono::system_clock::time_point* receive_time) {
+  if (transport_->udpReceive(data, sizeof(T), receive_time) != sizeof(T)) {
     throw ProtocolException("libfranka: incorrect object size");
   }
-
-  return *reinterpret_cast<T*>(buffer.data());
-} catch (const Poco::Exception& e) {
-  //--------------g alexander ------------//
-  //use gcc 8+
-  using std::string_literals::operator""s;
-  throw NetworkException("libfranka: UDP receive: "s + e.what());
 }
 
 template <typename T>
-void Network::udpSend(const T& data) try {
+void Network::udpSend(const T& data) {
   std::lock_guard<std::mutex> _(udp_mutex_);
-
-  int bytes_sent = udp_socket_.sendTo(&data, sizeof(data), udp_server_address_);
-  if (bytes_sent != sizeof(data)) {
-    throw NetworkException("libfranka: could not send UDP data");
-  }
-} catch (const Poco::Exception& e) {
-  //--------------g alexander ------------//
-  //use gcc 8+
-  using std::literals::string_literals::operator""s;
-  throw NetworkException("libfranka: UDP send: "s + e.what());
+  transport_->udpSend(&data, sizeof(data));
 }
 
 template <typename T>
-void Network::tcpReadFromBuffer(std::chrono::microseconds timeout) try {
-  if (!tcp_socket_.poll(timeout.count(), Poco::Net::Socket::SELECT_READ)) {
-    return;
-  }
+void Network::tcpStartReader() {
+  using Header = typename T::Header;
+  static_assert(std::is_same<decltype(Header::command_id), uint32_t>::value &&
+                    std::is_same<decltype(Header::size), uint32_t>::value,
+                "Unexpected command header layout.");
+
+  tcp_header_size_ = sizeof(Header);
+  tcp_command_id_offset_ = offsetof(Header, command_id);
+  tcp_size_offset_ = offsetof(Header, size);
+  tcp_reader_ = std::thread(&Network::tcpReaderLoop, this);
+}
 
-  int available_bytes = tcp_socket_.available();
-  if (pending_response_.empty() &&
-      available_bytes >= static_cast<int>(sizeof(typename T::Header))) {
-    typename T::Header header;
-    tcp_socket_.receiveBytes(&header, sizeof(header));
-    if (header.size < sizeof(header)) {
-      throw ProtocolException("libfranka: Incorrect TCP message size.");
-    }
-    pending_response_.resize(header.size);
-    std::memcpy(pending_response_.data(), &header, sizeof(header));
-    pending_response_offset_ = sizeof(header);
-    pending_command_id_ = header.command_id;
-  }
-  if (!pending_response_.empty() && available_bytes > 0) {
-    pending_response_offset_ += tcp_socket_.receiveBytes(
-        &pending_response_[pending_response_offset_],
-        std::min(tcp_socket_.available(),
-                 static_cast<int>(pending_response_.size() - pending_response_offset_)));
-    if (pending_response_offset_ == pending_response_.size()) {
-      received_responses_.emplace(pending_command_id_, pending_response_);
-      pending_response_.clear();
-      pending_response_offset_ = 0;
-      pending_command_id_ = 0;
-    }
-  }
-} catch (const Poco::Exception& e) {
-  //--------------g alexander ------------//
-  //use gcc 8+
-  using namespace std::literals::string_literals;
-  throw NetworkException("libfranka: TCP receive: "s + e.what());
+template <typename T, typename... TArgs>
+auto Network::tcpSendRequest(TArgs&&... args) -> uint32_t {
+  return tcpSendRequestWithStream<T>(nullptr, std::forward<TArgs>(args)...);
 }
 
 template <typename T, typename... TArgs>
-auto Network::tcpSendRequest(TArgs&&... args) -> uint32_t try {
+auto Network::tcpSendRequestStreaming(std::function<void(const uint8_t*, size_t)> on_data,
+                                      TArgs&&... args) -> uint32_t {
+  ResponseStream stream{sizeof(typename T::template Message<typename T::Response>),
+                        std::move(on_data)};
+  return tcpSendRequestWithStream<T>(&stream, std::forward<TArgs>(args)...);
+}
+
+template <typename T, typename... TArgs>
+auto Network::tcpSendRequestWithStream(ResponseStream* stream, TArgs&&... args) -> uint32_t {
   std::lock_guard<std::mutex> _(tcp_mutex_);
 
+  // Responses only arrive after a request, so the reader is started with the first one.
+  if (!tcp_reader_.joinable() && !tcp_reader_stopped_) {
+    tcpStartReader<T>();
+  }
+
   typename T::template Message<typename T::Request> message(
       typename T::Header(T::kCommand, command_id_++,
                          sizeof(typename T::template Message<typename T::Request>)),
       typename T::Request(std::forward<TArgs>(args)...));
 
-  tcp_socket_.sendBytes(&message, sizeof(message));
+  // The stream has to be known before the response can arrive.
+  if (stream != nullptr) {
+    std::lock_guard<std::mutex> response_lock(tcp_response_mutex_);
+    response_streams_[message.header.command_id] = std::move(*stream);
+  }
+  try {
+    transport_->tcpSend(&message, sizeof(message));
+  } catch (...) {
+    if (stream != nullptr) {
+      std::lock_guard<std::mutex> response_lock(tcp_response_mutex_);
+      response_streams_.erase(message.header.command_id);
+    }
+    throw;
+  }
 
   return message.header.command_id;
-} catch (const Poco::Exception& e) {
-  //--------------g alexander ------------//
-  //use gcc 8+
-  using namespace std::literals::string_literals;
-  throw NetworkException("libfranka: TCP send bytes: "s + e.what());
 }
 
 template <typename T>
 auto Network::tcpReceiveResponse(uint32_t command_id,
                                  std::function<void(const typename T::Response&)> handler) -> bool {
-  //--------------g alexander ------------//
-  //use gcc 8+ or clang 8+
-  using namespace std::literals::chrono_literals;
-  std::unique_lock<std::mutex> lock(tcp_mutex_, std::try_to_lock);
+  std::unique_lock<std::mutex> lock(tcp_response_mutex_, std::try_to_lock);
   if (!lock.owns_lock()) {
     return false;
   }
 
-  tcpReadFromBuffer<T>(0us);
-  auto it = received_responses_.find(command_id);
-  if (it != received_responses_.end()) {
+  const std::vector<uint8_t>* response = received_responses_.find(command_id);
+  if (response != nullptr) {
     auto message = reinterpret_cast<const typename T::template Message<typename T::Response>*>(
-        it->second.data());
-    if (message->header.size < sizeof(message)) {
+        response->data());
+    if (response->size() < sizeof(*message)) {
       throw ProtocolException("libfranka: Incorrect TCP message size.");
     }
     handler(message->getInstance());
-    received_responses_.erase(it);
+    received_responses_.release(response);
     return true;
   }
   return false;
 }
 
+template <typename T>
+void Network::tcpReceiveResponseAsync(uint32_t command_id,
+                                      std::function<void(const typename T::Response&)> on_response,
+                                      std::function<void(std::exception_ptr)> on_error) {
+  ResponseCallbacks callbacks{
+      [on_response = std::move(on_response)](const std::vector<uint8_t>& buffer) {
+        using Message = typename T::template Message<typename T::Response>;
+        if (buffer.size() < sizeof(Message)) {
+          throw ProtocolException("libfranka: Incorrect TCP message size.");
+        }
+        on_response(reinterpret_cast<const Message*>(buffer.data())->getInstance());
+      },
+      std::move(on_error)};
+
+  std::unique_lock<std::mutex> lock(tcp_response_mutex_);
+  const std::vector<uint8_t>* response = received_responses_.find(command_id);
+  if (response != nullptr) {
+    std::vector<uint8_t> buffer = received_responses_.take(response);
+    lock.unlock();
+    invokeResponseCallbacks(callbacks, buffer);
+  } else if (tcp_reader_exception_ != nullptr) {
+    std::exception_ptr exception = tcp_reader_exception_;
+    lock.unlock();
+    callbacks.on_error(exception);
+  } else {
+    response_callbacks_.emplace(command_id, std::move(callbacks));
+  }
+}
+
 template <typename T>
 auto Network::tcpBlockingReceiveResponse(uint32_t command_id,
                                                          std::vector<uint8_t>* vl_buffer) -> typename T::Response {
-  //--------------g alexander ------------//
-  //use gcc 8+ or clang 8+
-  using namespace std::literals::chrono_literals;
-  std::unique_lock<std::mutex> lock(tcp_mutex_, std::defer_lock);
-  decltype(received_responses_)::const_iterator it;
-  do {
-    lock.lock();
-    tcpReadFromBuffer<T>(10ms);
-    it = received_responses_.find(command_id);
-    lock.unlock();
-    std::this_thread::yield();
-  } while (it == received_responses_.end());
+  return tcpReceiveResponseUntil<T>(command_id, vl_buffer, nullptr);
+}
 
-  auto message = *reinterpret_cast<const typename T::template Message<typename T::Response>*>(
-      it->second.data());
-  if (message.header.size < sizeof(message)) {
+template <typename T>
+auto Network::tcpBlockingReceiveResponse(uint32_t command_id, std::chrono::milliseconds timeout) ->
+    typename T::Response {
+  const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + timeout;
+  return tcpReceiveResponseUntil<T>(command_id, nullptr, &deadline);
+}
+
+template <typename T>
+auto Network::tcpReceiveResponseUntil(uint32_t command_id,
+                                      std::vector<uint8_t>* vl_buffer,
+                                      const std::chrono::steady_clock::time_point* deadline) ->
+    typename T::Response {
+  std::unique_lock<std::mutex> lock(tcp_response_mutex_);
+  const std::vector<uint8_t>* response = nullptr;
+  auto received = [&] {
+    response = received_responses_.find(command_id);
+    return response != nullptr || tcp_reader_exception_ != nullptr;
+  };
+  if (deadline == nullptr) {
+    tcp_response_received_.wait(lock, received);
+  } else if (!tcp_response_received_.wait_until(lock, *deadline, received)) {
+    throw NetworkException("libfranka: TCP receive: Timeout");
+  }
+  if (response == nullptr) {
+    std::rethrow_exception(tcp_reader_exception_);
+  }
+  if (!stream_exceptions_.empty()) {
+    auto stream_exception = stream_exceptions_.find(command_id);
+    if (stream_exception != stream_exceptions_.end()) {
+      std::exception_ptr exception = stream_exception->second;
+      stream_exceptions_.erase(stream_exception);
+      received_responses_.release(response);
+      std::rethrow_exception(exception);
+    }
+  }
+
+  if (response->size() < sizeof(typename T::template Message<typename T::Response>)) {
+    received_responses_.release(response);
     throw ProtocolException("libfranka: Incorrect TCP message size.");
   }
+  auto message = *reinterpret_cast<const typename T::template Message<typename T::Response>*>(
+      response->data());
 
   if (vl_buffer != nullptr && message.header.size != sizeof(message)) {
-    size_t data_size = message.header.size - sizeof(message);
-    std::vector<uint8_t> data_buffer(data_size);
-    std::memcpy(data_buffer.data(), &it->second[sizeof(message)], data_size);
-    *vl_buffer = data_buffer;
+    vl_buffer->assign(response->begin() + sizeof(message), response->end());
   }
 
-  received_responses_.erase(it);
+  received_responses_.release(response);
   return message.getInstance();
 }
 
 template <typename T, uint16_t kLibraryVersion>
 void connect(Network& network, uint16_t* ri_version) {
   uint32_t command_id = network.tcpSendRequest<T>(network.udpPort());
-  typename T::Response connect_response = network.tcpBlockingReceiveResponse<T>(command_id);
+  typename T::Response connect_response =
+      network.tcpBlockingReceiveResponse<T>(command_id, network.tcpTimeout());
   switch (connect_response.status) {
     case (T::Status::kIncompatibleLibraryVersion):
       throw IncompatibleVersionException(connect_response.version, kLibraryVersion);
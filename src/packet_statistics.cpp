@@ -0,0 +1,81 @@
+// Copyright (c) 2017 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include "packet_statistics.h"
+
+#include <algorithm>
+
+#include "relaxed_counter.h"
+
+namespace franka {
+
+void PacketStatisticsRecorder::record(uint64_t message_id,
+                                      std::chrono::system_clock::time_point receive_time) noexcept {
+  if (received_.load(std::memory_order_relaxed) > 0) {
+    auto inter_arrival_time = std::max(receive_time - last_receive_time_,
+                                       std::chrono::system_clock::duration::zero());
+    auto bucket = static_cast<size_t>(std::min<std::chrono::system_clock::duration::rep>(
+        inter_arrival_time / PacketStatistics::kInterArrivalBucketWidth,
+        PacketStatistics::kInterArrivalBuckets - 1));
+    relaxedAdd(inter_arrival_histogram_[bucket], 1);
+
+    if (message_id > newest_message_id_) {
+      uint64_t shift = message_id - newest_message_id_;
+      relaxedAdd(message_id_gaps_, shift - 1);
+      received_window_ = shift < kWindowSize ? (received_window_ << shift) | 1 : 1;
+      newest_message_id_ = message_id;
+    } else {
+      uint64_t offset = newest_message_id_ - message_id;
+      if (offset < kWindowSize && (received_window_ & (uint64_t{1} << offset)) != 0) {
+        relaxedAdd(duplicates_, 1);
+      } else {
+        if (offset < kWindowSize) {
+          received_window_ |= uint64_t{1} << offset;
+        }
+        relaxedAdd(out_of_order_, 1);
+      }
+    }
+  } else {
+    newest_message_id_ = message_id;
+    received_window_ = 1;
+  }
+  last_receive_time_ = receive_time;
+  relaxedAdd(received_, 1);
+}
+
+void PacketStatisticsRecorder::recordStale(uint64_t count) noexcept {
+  relaxedAdd(stale_, count);
+  if (count > max_stale_per_read_.load(std::memory_order_relaxed)) {
+    max_stale_per_read_.store(count, std::memory_order_relaxed);
+  }
+}
+
+auto PacketStatisticsRecorder::snapshot() const noexcept -> PacketStatistics {
+  PacketStatistics statistics;
+  statistics.received = received_.load(std::memory_order_relaxed);
+  statistics.message_id_gaps = message_id_gaps_.load(std::memory_order_relaxed);
+  statistics.out_of_order = out_of_order_.load(std::memory_order_relaxed);
+  statistics.duplicates = duplicates_.load(std::memory_order_relaxed);
+  statistics.stale = stale_.load(std::memory_order_relaxed);
+  statistics.max_stale_per_read = max_stale_per_read_.load(std::memory_order_relaxed);
+  for (size_t i = 0; i < statistics.inter_arrival_histogram.size(); i++) {
+    statistics.inter_arrival_histogram[i] =
+        inter_arrival_histogram_[i].load(std::memory_order_relaxed);
+  }
+  return statistics;
+}
+
+auto operator<<(std::ostream& ostream, const PacketStatistics& statistics) -> std::ostream& {
+  ostream << "{\"received\": " << statistics.received
+          << ", \"message_id_gaps\": " << statistics.message_id_gaps
+          << ", \"out_of_order\": " << statistics.out_of_order
+          << ", \"duplicates\": " << statistics.duplicates << ", \"stale\": " << statistics.stale
+          << ", \"max_stale_per_read\": " << statistics.max_stale_per_read
+          << ", \"inter_arrival_histogram\": [";
+  for (size_t i = 0; i < statistics.inter_arrival_histogram.size(); i++) {
+    ostream << (i > 0 ? "," : "") << statistics.inter_arrival_histogram[i];
+  }
+  ostream << "]}";
+  return ostream;
+}
+
+}  // namespace franka
@@ -0,0 +1,59 @@
+// Copyright (c) 2017 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include <franka/packet_statistics.h>
+
+namespace franka {
+
+/**
+ * Collects PacketStatistics for received states.
+ *
+ * Only a single thread may record packets, while any number of threads may read a snapshot
+ * concurrently without blocking. The fields of a snapshot are read independently of each other.
+ */
+class PacketStatisticsRecorder {
+ public:
+  /**
+   * Records a received state.
+   *
+   * @param[in] message_id Message ID of the state.
+   * @param[in] receive_time Time the state arrived at the host.
+   */
+  void record(uint64_t message_id, std::chrono::system_clock::time_point receive_time) noexcept;
+
+  /**
+   * Records the number of states which have been drained without being used while reading a state.
+   *
+   * @param[in] count Number of drained states.
+   */
+  void recordStale(uint64_t count) noexcept;
+
+  auto snapshot() const noexcept -> PacketStatistics;
+
+ private:
+  // Number of recent message IDs remembered to tell duplicates from out-of-order states.
+  static constexpr uint64_t kWindowSize = 64;
+
+  std::atomic<uint64_t> received_{0};
+  std::atomic<uint64_t> message_id_gaps_{0};
+  std::atomic<uint64_t> out_of_order_{0};
+  std::atomic<uint64_t> duplicates_{0};
+  std::atomic<uint64_t> stale_{0};
+  std::atomic<uint64_t> max_stale_per_read_{0};
+  std::array<std::atomic<uint64_t>, PacketStatistics::kInterArrivalBuckets>
+      inter_arrival_histogram_{};
+
+  // Only accessed by the recording thread.
+  uint64_t newest_message_id_{0};
+  // Bit i is set if newest_message_id_ - i has been received.
+  uint64_t received_window_{0};
+  std::chrono::system_clock::time_point last_receive_time_{};
+};
+
+}  // namespace franka
@@ -4,6 +4,8 @@
 #include <franka/control_tools.h>
 #include <franka/rate_limiting.h>
 
+#include "joint_lanes.h"
+
 namespace franka {
 
 namespace {
@@ -50,23 +52,53 @@ auto limitRate(double max_velocity,
   return limited_commanded_velocity;
 }
 
+// Lane-wise version of the scalar limitRate for velocities, with the same operations in the same
+// order.
+auto limitRate(const JointLanes& max_velocity,
+               const JointLanes& max_acceleration,
+               const JointLanes& max_jerk,
+               const JointLanes& commanded_velocity,
+               const JointLanes& last_commanded_velocity,
+               const JointLanes& last_commanded_acceleration) -> JointLanes {
+  JointLanes delta_t(kDeltaT);
+
+  // Differentiate to get jerk
+  JointLanes commanded_jerk =
+      (((commanded_velocity - last_commanded_velocity) / delta_t) - last_commanded_acceleration) /
+      delta_t;
+
+  // Limit jerk and integrate to get acceleration
+  JointLanes commanded_acceleration =
+      last_commanded_acceleration + max(min(commanded_jerk, max_jerk), -max_jerk) * delta_t;
+
+  // Compute acceleration limits
+  JointLanes safe_max_acceleration =
+      min((max_jerk / max_acceleration) * (max_velocity - last_commanded_velocity),
+          max_acceleration);
+  JointLanes safe_min_acceleration =
+      max((max_jerk / max_acceleration) * (-max_velocity - last_commanded_velocity),
+          -max_acceleration);
+
+  // Limit acceleration and integrate to get desired velocities
+  return last_commanded_velocity +
+         max(min(commanded_acceleration, safe_max_acceleration), safe_min_acceleration) * delta_t;
+}
+
 }  // anonymous namespace
 
 auto limitRate(const std::array<double, 7>& max_derivatives,
                                 const std::array<double, 7>& commanded_values,
                                 const std::array<double, 7>& last_commanded_values) -> std::array<double, 7>{
-  if (!std::all_of(commanded_values.begin(), commanded_values.end(),
-                   [](double d) { return std::isfinite(d); })) {
+  JointLanes commanded(commanded_values, 0.0);
+  if (!commanded.allFinite()) {
     throw std::invalid_argument("Commanding value is infinite or NaN.");
   }
-  std::array<double, 7> limited_values{};
-  for (size_t i = 0; i < 7; i++) {
-    double commanded_derivative = (commanded_values[i] - last_commanded_values[i]) / kDeltaT;
-    limited_values[i] =
-        last_commanded_values[i] +
-        std::max(std::min(commanded_derivative, max_derivatives[i]), -max_derivatives[i]) * kDeltaT;
-  }
-  return limited_values;
+  JointLanes last_commanded(last_commanded_values, 0.0);
+  JointLanes max_derivative(max_derivatives, 1.0);
+  JointLanes delta_t(kDeltaT);
+  JointLanes commanded_derivative = (commanded - last_commanded) / delta_t;
+  JointLanes limited_derivative = max(min(commanded_derivative, max_derivative), -max_derivative);
+  return (last_commanded + limited_derivative * delta_t).toArray();
 }
 
 auto limitRate(double max_velocity,
@@ -122,18 +154,15 @@ auto limitRate(const std::array<double, 7>& max_velocity,
                                 const std::array<double, 7>& commanded_velocities,
                                 const std::array<double, 7>& last_commanded_velocities,
                                 const std::array<double, 7>& last_commanded_accelerations) -> std::array<double, 7> {
-  if (!std::all_of(commanded_velocities.begin(), commanded_velocities.end(),
-                   [](double d) { return std::isfinite(d); })) {
+  JointLanes commanded(commanded_velocities, 0.0);
+  if (!commanded.allFinite()) {
     throw std::invalid_argument("commanded_velocities is infinite or NaN.");
   }
-  std::array<double, 7> limited_commanded_velocities{};
-
-  for (size_t i = 0; i < 7; i++) {
-    limited_commanded_velocities[i] =
-        limitRate(max_velocity[i], max_acceleration[i], max_jerk[i], commanded_velocities[i],
-                  last_commanded_velocities[i], last_commanded_accelerations[i]);
-  }
-  return limited_commanded_velocities;
+  return limitRate(JointLanes(max_velocity, 1.0), JointLanes(max_acceleration, 1.0),
+                   JointLanes(max_jerk, 1.0), commanded,
+                   JointLanes(last_commanded_velocities, 0.0),
+                   JointLanes(last_commanded_accelerations, 0.0))
+      .toArray();
 }
 
 auto limitRate(const std::array<double, 7>& max_velocity,
@@ -143,17 +172,22 @@ auto limitRate(const std::array<double, 7>& max_velocity,
                                 const std::array<double, 7>& last_commanded_positions,
                                 const std::array<double, 7>& last_commanded_velocities,
                                 const std::array<double, 7>& last_commanded_accelerations) -> std::array<double, 7> {
-  if (!std::all_of(commanded_positions.begin(), commanded_positions.end(),
-                   [](double d) { return std::isfinite(d); })) {
+  JointLanes commanded(commanded_positions, 0.0);
+  if (!commanded.allFinite()) {
     throw std::invalid_argument("commanded_positions is infinite or NaN.");
   }
-  std::array<double, 7> limited_commanded_positions{};
-  for (size_t i = 0; i < 7; i++) {
-    limited_commanded_positions[i] = limitRate(
-        max_velocity[i], max_acceleration[i], max_jerk[i], commanded_positions[i],
-        last_commanded_positions[i], last_commanded_velocities[i], last_commanded_accelerations[i]);
+  JointLanes last_commanded(last_commanded_positions, 0.0);
+  JointLanes delta_t(kDeltaT);
+  JointLanes commanded_velocity = (commanded - last_commanded) / delta_t;
+  if (!commanded_velocity.allFinite()) {
+    throw std::invalid_argument("commanded_velocity is infinite or NaN.");
   }
-  return limited_commanded_positions;
+  return (last_commanded + limitRate(JointLanes(max_velocity, 1.0),
+                                     JointLanes(max_acceleration, 1.0), JointLanes(max_jerk, 1.0),
+                                     commanded_velocity, JointLanes(last_commanded_velocities, 0.0),
+                                     JointLanes(last_commanded_accelerations, 0.0)) *
+                               delta_t)
+      .toArray();
 }
 
 auto limitRate(
@@ -0,0 +1,21 @@
+// Copyright (c) 2017 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#pragma once
+
+#include <atomic>
+
+namespace franka {
+
+/**
+ * Adds value to a counter which is only written by a single thread, while other threads may read
+ * it concurrently.
+ *
+ * Since there is only one writer, no read-modify-write operation is needed, which keeps recording
+ * cheap on the real-time path.
+ */
+template <typename T>
+void relaxedAdd(std::atomic<T>& counter, typename std::atomic<T>::value_type value) noexcept {
+  counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+}  // namespace franka
@@ -0,0 +1,71 @@
+// Copyright (c) 2017 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include "response_table.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace franka {
+
+ResponseTable::ResponseTable(size_t capacity, size_t buffer_size)
+    : slots_(capacity), buffer_size_(buffer_size) {
+  for (Slot& slot : slots_) {
+    slot.buffer.reserve(buffer_size_);
+  }
+}
+
+void ResponseTable::insert(uint32_t command_id, std::vector<uint8_t>* buffer) {
+  auto slot = std::find_if(slots_.begin(), slots_.end(), [](const Slot& s) { return !s.used; });
+  if (slot == slots_.end()) {
+    slots_.emplace_back();
+    slot = slots_.end() - 1;
+    slot->buffer.reserve(buffer_size_);
+  }
+
+  slot->used = true;
+  slot->command_id = command_id;
+  slot->sequence = next_sequence_++;
+  slot->buffer.swap(*buffer);
+  buffer->clear();
+}
+
+auto ResponseTable::find(uint32_t command_id) -> const std::vector<uint8_t>* {
+  const Slot* oldest = nullptr;
+  for (const Slot& slot : slots_) {
+    if (slot.used && slot.command_id == command_id &&
+        (oldest == nullptr || slot.sequence < oldest->sequence)) {
+      oldest = &slot;
+    }
+  }
+  return oldest != nullptr ? &oldest->buffer : nullptr;
+}
+
+void ResponseTable::release(const std::vector<uint8_t>* response) noexcept {
+  for (Slot& slot : slots_) {
+    if (&slot.buffer == response) {
+      slot.used = false;
+      slot.buffer.clear();
+      return;
+    }
+  }
+}
+
+auto ResponseTable::take(const std::vector<uint8_t>* response) -> std::vector<uint8_t> {
+  for (Slot& slot : slots_) {
+    if (&slot.buffer == response) {
+      std::vector<uint8_t> buffer = std::move(slot.buffer);
+      slot.used = false;
+      slot.buffer = std::vector<uint8_t>();
+      slot.buffer.reserve(buffer_size_);
+      return buffer;
+    }
+  }
+  return {};
+}
+
+auto ResponseTable::size() const noexcept -> size_t {
+  return static_cast<size_t>(
+      std::count_if(slots_.begin(), slots_.end(), [](const Slot& slot) { return slot.used; }));
+}
+
+}  // namespace franka
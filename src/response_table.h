@@ -0,0 +1,84 @@
+// Copyright (c) 2017 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace franka {
+
+/**
+ * Stores received TCP responses until they are claimed, in a table of preallocated slots.
+ *
+ * Message buffers are exchanged with the caller instead of copied, so that storing and claiming
+ * responses does not allocate as long as they fit into the preallocated buffers and there are
+ * enough free slots. The table grows if all slots are taken. Not threadsafe.
+ */
+class ResponseTable {
+ public:
+  /**
+   * Creates a table with the given number of slots.
+   *
+   * @param[in] capacity Number of preallocated slots.
+   * @param[in] buffer_size Preallocated size of the buffer in each slot, in bytes.
+   */
+  ResponseTable(size_t capacity, size_t buffer_size);
+
+  /**
+   * Stores a response by swapping the given buffer with the one of a free slot.
+   *
+   * @param[in] command_id Command ID of the response.
+   * @param[in,out] buffer Buffer holding the response. Replaced by an empty buffer.
+   */
+  void insert(uint32_t command_id, std::vector<uint8_t>* buffer);
+
+  /**
+   * Looks up the oldest stored response with the given command ID.
+   *
+   * @param[in] command_id Command ID of the response.
+   *
+   * @return Buffer holding the response, or nullptr if there is none. Valid until the table is
+   * modified.
+   */
+  auto find(uint32_t command_id) -> const std::vector<uint8_t>*;
+
+  /**
+   * Frees the slot holding the given response.
+   *
+   * @param[in] response Buffer returned by find.
+   */
+  void release(const std::vector<uint8_t>* response) noexcept;
+
+  /**
+   * Moves a response out of the table and frees its slot, e.g. to hand it to another thread.
+   *
+   * The slot gets a new preallocated buffer, so the allocation happens in the calling thread
+   * instead of the one storing the next response.
+   *
+   * @param[in] response Buffer returned by find.
+   *
+   * @return Buffer holding the response.
+   */
+  auto take(const std::vector<uint8_t>* response) -> std::vector<uint8_t>;
+
+  /**
+   * @return Number of stored responses.
+   */
+  [[nodiscard]] auto size() const noexcept -> size_t;
+
+ private:
+  struct Slot {
+    bool used{false};
+    uint32_t command_id{0};
+    // Arrival order, to hand out multiple responses to the same command in order.
+    uint64_t sequence{0};
+    std::vector<uint8_t> buffer{};
+  };
+
+  std::vector<Slot> slots_;
+  const size_t buffer_size_;
+  uint64_t next_sequence_{0};
+};
+
+}  // namespace franka
@@ -2,17 +2,38 @@
 // Use of this source code is governed by the Apache-2.0 license, see LICENSE
 #include <franka/robot.h>
 
+#include <chrono>
+#include <stdexcept>
 #include <utility>
 
 #include "control_loop.h"
+#include "io_thread_transport.h"
 #include "network.h"
 #include "robot_impl.h"
+#include "shared_memory_channel.h"
 
 namespace franka {
 
-Robot::Robot(const std::string& franka_address, RealtimeConfig realtime_config, size_t log_size)
+Robot::Robot(const std::string& franka_address,
+             const RealtimeConfig& realtime_config,
+             size_t log_size,
+             const NetworkConfig& network_config)
+    : impl_{new Robot::Impl(std::make_unique<Network>(franka_address,
+                                                      research_interface::robot::kCommandPort,
+                                                      network_config),
+                            log_size,
+                            realtime_config)} {}
+
+Robot::Robot(SharedMemoryChannel& channel,
+             const RealtimeConfig& realtime_config,
+             size_t log_size,
+             const NetworkConfig& network_config)
     : impl_{new Robot::Impl(
-          std::make_unique<Network>(franka_address, research_interface::robot::kCommandPort),
+          std::make_unique<Network>(
+              withUdpIoThread(std::make_unique<SharedMemoryTransport>(channel.impl_,
+                                                                      network_config.udp_timeout),
+                              network_config),
+              network_config.tcp_timeout),
           log_size,
           realtime_config)} {}
 
@@ -38,6 +59,54 @@ auto Robot::serverVersion() const noexcept -> Robot::ServerVersion {
   return impl_->serverVersion();
 }
 
+auto Robot::packetStatistics() const noexcept -> PacketStatistics {
+  return impl_->packetStatistics();
+}
+
+void Robot::setControlLoopTimingEnabled(bool enabled) noexcept {
+  impl_->setControlLoopTimingEnabled(enabled);
+}
+
+auto Robot::controlLoopTiming() const noexcept -> ControlLoopTiming {
+  return impl_->controlLoopTiming();
+}
+
+void Robot::setControlLoopWatchdog(const ControlLoopWatchdog& watchdog) {
+  if (watchdog.budget < std::chrono::microseconds::zero()) {
+    throw std::invalid_argument("libfranka: Watchdog budget must not be negative.");
+  }
+  std::unique_lock<std::mutex> l = lockForControl();
+  impl_->setControlLoopWatchdog(watchdog);
+}
+
+auto Robot::deadlineMisses() const noexcept -> uint64_t {
+  return impl_->deadlineMisses();
+}
+
+void Robot::startTelemetryRecording(const std::string& path) {
+  std::unique_lock<std::mutex> l = lockForControl();
+  impl_->startTelemetryRecording(path);
+}
+
+auto Robot::stopTelemetryRecording() -> TelemetryStatistics {
+  std::unique_lock<std::mutex> l = lockForControl();
+  return impl_->stopTelemetryRecording();
+}
+
+auto Robot::lockForControl() -> std::unique_lock<std::mutex> {
+  std::unique_lock<std::mutex> l(control_mutex_, std::try_to_lock);
+  if (!l.owns_lock()) {
+    throw InvalidOperationException(
+        "libfranka robot: Cannot perform this operation while another control or read operation "
+        "is running.");
+  }
+  return l;
+}
+
+auto Robot::robotControl() noexcept -> RobotControl& {
+  return *impl_;
+}
+
 void Robot::control(std::function<Torques(const RobotState&, franka::Duration)> control_callback,
                     bool limit_rate,
                     double cutoff_frequency) {
@@ -294,14 +363,30 @@ void Robot::setFilters(double joint_position_filter_frequency,
       controller_filter_frequency);
 }
 
+void Robot::configure(const RobotConfiguration& configuration) {
+  impl_->configure(configuration);
+}
+
+auto Robot::configureAsync(const RobotConfiguration& configuration) -> std::future<void> {
+  return impl_->configureAsync(configuration);
+}
+
 void Robot::automaticErrorRecovery() {
   impl_->executeCommand<research_interface::robot::AutomaticErrorRecovery>();
 }
 
+auto Robot::automaticErrorRecoveryAsync() -> std::future<void> {
+  return impl_->executeCommandAsync<research_interface::robot::AutomaticErrorRecovery>();
+}
+
 void Robot::stop() {
   impl_->executeCommand<research_interface::robot::StopMove>();
 }
 
+auto Robot::stopAsync() -> std::future<void> {
+  return impl_->executeCommandAsync<research_interface::robot::StopMove>();
+}
+
 auto Robot::loadModel() -> Model {
   return impl_->loadModel();
 }
@@ -1,6 +1,7 @@
 // Copyright (c) 2017 Franka Emika GmbH
 // Use of this source code is governed by the Apache-2.0 license, see LICENSE
 #pragma once
+#include <franka/control_loop_watchdog.h>
 #include <franka/control_types.h>
 #include <franka/robot_state.h>
 #include <research_interface/robot/rbk_types.h>
@@ -9,6 +10,8 @@
 
 namespace franka {
 
+class ControlLoopTimingRecorder;
+
 class RobotControl {
  public:
   virtual ~RobotControl() = default;
@@ -30,9 +33,40 @@ class RobotControl {
       const research_interface::robot::MotionGeneratorCommand* motion_command,
       const research_interface::robot::ControllerCommand* control_command) -> RobotState = 0;
 
+  /**
+   * Sends the given commands without waiting for the next robot state. Together with receive,
+   * this splits update into two steps.
+   */
+  virtual void send(const research_interface::robot::MotionGeneratorCommand* motion_command,
+                    const research_interface::robot::ControllerCommand* control_command) = 0;
+
+  /**
+   * Waits for the next robot state.
+   */
+  virtual auto receive() -> RobotState = 0;
+
   virtual void throwOnMotionError(const RobotState& robot_state, uint32_t motion_id) = 0;
 
-  [[nodiscard]] virtual auto realtimeConfig() const noexcept -> RealtimeConfig = 0;
+  [[nodiscard]] virtual auto realtimeConfig() const noexcept -> const RealtimeConfig& = 0;
+
+  /**
+   * @return Recorder for the timing of control loops, or nullptr if timing is not recorded.
+   */
+  virtual auto controlLoopTimingRecorder() noexcept -> ControlLoopTimingRecorder* {
+    return nullptr;
+  }
+
+  /**
+   * @return Watchdog configuration for control loops. Disabled by default.
+   */
+  [[nodiscard]] virtual auto controlLoopWatchdog() const noexcept -> ControlLoopWatchdog {
+    return {};
+  }
+
+  /**
+   * Counts a callback which overran the budget of the watchdog.
+   */
+  virtual void recordDeadlineMiss() noexcept {}
 };
 
 }  // namespace franka
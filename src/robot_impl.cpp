@@ -1,6 +1,9 @@
 // Copyright (c) 2017 Franka Emika GmbH
 // Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <memory>
+#include <mutex>
 #include <sstream>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -39,9 +42,66 @@ inline ControlException createControlException(const char* message,
   return ControlException(message_stream.str(), log);
 }
 
+// Completes a future once every command of a batch has been answered. Errors of failed commands
+// are collected, so that none of the responses is left behind.
+class CommandBatch : public std::enable_shared_from_this<CommandBatch> {
+ public:
+  auto future() -> std::future<void> { return promise_.get_future(); }
+
+  auto add() -> std::function<void(std::exception_ptr)> {
+    std::lock_guard<std::mutex> _(mutex_);
+    pending_++;
+    commands_++;
+    return [self = shared_from_this()](std::exception_ptr exception) { self->complete(exception); };
+  }
+
+  // Called once all commands have been sent.
+  void seal() { complete(nullptr); }
+
+ private:
+  void complete(std::exception_ptr exception) {
+    std::lock_guard<std::mutex> _(mutex_);
+    if (exception != nullptr) {
+      try {
+        std::rethrow_exception(exception);
+      } catch (const CommandException& e) {
+        errors_ << std::endl << e.what();
+        failed_commands_++;
+      } catch (...) {
+        if (exception_ == nullptr) {
+          exception_ = exception;
+        }
+      }
+    }
+    if (--pending_ > 0) {
+      return;
+    }
+
+    if (exception_ != nullptr) {
+      promise_.set_exception(exception_);
+    } else if (failed_commands_ > 0) {
+      promise_.set_exception(std::make_exception_ptr(CommandException(
+          "libfranka robot: " + std::to_string(failed_commands_) + " of " +
+          std::to_string(commands_) + " configuration commands failed:" + errors_.str())));
+    } else {
+      promise_.set_value();
+    }
+  }
+
+  std::mutex mutex_;
+  std::promise<void> promise_;
+  size_t pending_{1};
+  size_t commands_{0};
+  size_t failed_commands_{0};
+  std::ostringstream errors_;
+  std::exception_ptr exception_{};
+};
+
 }  // anonymous namespace
 
-Robot::Impl::Impl(std::unique_ptr<Network> network, size_t log_size, RealtimeConfig realtime_config)
+Robot::Impl::Impl(std::unique_ptr<Network> network,
+                  size_t log_size,
+                  const RealtimeConfig& realtime_config)
     : network_{std::move(network)}, logger_{log_size}, realtime_config_{realtime_config} {
   if (!network_) {
     throw std::invalid_argument("libfranka robot: Invalid argument");
@@ -49,19 +109,44 @@ Robot::Impl::Impl(std::unique_ptr<Network> network, size_t log_size, RealtimeCon
 
   connect<research_interface::robot::Connect, research_interface::robot::kVersion>(*network_,
                                                                                    &ri_version_);
-  updateState(network_->udpBlockingReceive<research_interface::robot::RobotState>());
+  network_->udpReserveReceiveLatest<research_interface::robot::RobotState>();
+  network_->udpBlockingReceive(&received_states_[current_state_], &state_receive_time_);
+  state_pickup_time_ = std::chrono::system_clock::now();
+  packet_statistics_.record(received_states_[current_state_].message_id, state_receive_time_);
+  updateState(received_states_[current_state_]);
 }
 
 RobotState Robot::Impl::update(
     const research_interface::robot::MotionGeneratorCommand* motion_command,
     const research_interface::robot::ControllerCommand* control_command) {
+  send(motion_command, control_command);
+  return receive();
+}
+
+void Robot::Impl::send(const research_interface::robot::MotionGeneratorCommand* motion_command,
+                       const research_interface::robot::ControllerCommand* control_command) {
   network_->tcpThrowIfConnectionClosed();
 
-  research_interface::robot::RobotCommand robot_command =
-      sendRobotCommand(motion_command, control_command);
+  sent_command_ = sendRobotCommand(motion_command, control_command);
+  command_send_time_ = {};
+  if (motion_command != nullptr || control_command != nullptr) {
+    command_send_time_ = std::chrono::system_clock::now();
+  }
+}
 
-  RobotState state = convertRobotState(receiveRobotState());
-  logger_.log(state, robot_command);
+RobotState Robot::Impl::receive() {
+  network_->tcpThrowIfConnectionClosed();
+
+  std::chrono::system_clock::time_point previous_receive_time = state_receive_time_;
+  const research_interface::robot::RobotState& received_state = receiveRobotState();
+  RobotState state =
+      convertReceivedState(received_state, previous_receive_time, command_send_time_);
+  logger_.log(state, sent_command_);
+  if (telemetry_recorder_) {
+    telemetry_recorder_->record(received_state, sent_command_, state);
+  }
+  sent_command_ = {};
+  command_send_time_ = {};
 
   return state;
 }
@@ -84,13 +169,26 @@ void Robot::Impl::throwOnMotionError(const RobotState& robot_state, uint32_t mot
   }
 }
 
+auto Robot::Impl::recordPacket()
+    -> std::function<void(const research_interface::robot::RobotState&,
+                          std::chrono::system_clock::time_point)> {
+  return [this](const research_interface::robot::RobotState& robot_state,
+                std::chrono::system_clock::time_point receive_time) {
+    packet_statistics_.record(robot_state.message_id, receive_time);
+  };
+}
+
 RobotState Robot::Impl::readOnce() {
   // Delete old data from the UDP buffer.
-  research_interface::robot::RobotState robot_state;
-  while (network_->udpReceive<decltype(robot_state)>(&robot_state)) {
-  }
+  research_interface::robot::RobotState robot_state{};
+  size_t drained = network_->udpReceiveLatest(&robot_state, nullptr, recordPacket());
 
-  return convertRobotState(receiveRobotState());
+  const research_interface::robot::RobotState& received_state = receiveRobotState(drained);
+  RobotState state = convertReceivedState(received_state, state_receive_time_, {});
+  if (telemetry_recorder_) {
+    telemetry_recorder_->record(received_state, {}, state);
+  }
+  return state;
 }
 
 research_interface::robot::RobotCommand Robot::Impl::sendRobotCommand(
@@ -130,28 +228,94 @@ research_interface::robot::RobotCommand Robot::Impl::sendRobotCommand(
   return robot_command;
 }
 
-research_interface::robot::RobotState Robot::Impl::receiveRobotState() {
-  research_interface::robot::RobotState latest_accepted_state;
-  latest_accepted_state.message_id = message_id_;
+const research_interface::robot::RobotState& Robot::Impl::receiveRobotState(size_t stale) {
+  research_interface::robot::RobotState& next_state = received_states_[1 - current_state_];
+  next_state.message_id = message_id_;
 
   // If states are already available on the socket, use the one with the most recent message ID.
-  research_interface::robot::RobotState received_state{};
-  while (network_->udpReceive(&received_state)) {
-    if (received_state.message_id > latest_accepted_state.message_id) {
-      latest_accepted_state = received_state;
-    }
+  stale += network_->udpReceiveLatest(&next_state, &state_receive_time_, recordPacket());
+  if (next_state.message_id > message_id_) {
+    stale--;
   }
 
   // If there was no valid state on the socket, we need to wait.
-  while (latest_accepted_state.message_id == message_id_) {
-    received_state = network_->udpBlockingReceive<decltype(received_state)>();
-    if (received_state.message_id > latest_accepted_state.message_id) {
-      latest_accepted_state = received_state;
+  while (next_state.message_id <= message_id_) {
+    network_->udpBlockingReceive(&next_state, &state_receive_time_);
+    packet_statistics_.record(next_state.message_id, state_receive_time_);
+    if (next_state.message_id <= message_id_) {
+      stale++;
     }
   }
+  state_pickup_time_ = std::chrono::system_clock::now();
+  packet_statistics_.recordStale(stale);
 
-  updateState(latest_accepted_state);
-  return latest_accepted_state;
+  current_state_ = 1 - current_state_;
+  updateState(next_state);
+  return next_state;
+}
+
+RobotState Robot::Impl::convertReceivedState(
+    const research_interface::robot::RobotState& robot_state,
+    std::chrono::system_clock::time_point previous_receive_time,
+    std::chrono::system_clock::time_point command_send_time) const {
+  RobotState converted = convertRobotState(robot_state);
+  converted.host_receive_time = state_receive_time_;
+  converted.host_receive_latency = state_pickup_time_ - state_receive_time_;
+  if (command_send_time != std::chrono::system_clock::time_point()) {
+    converted.host_command_send_time = command_send_time;
+    converted.host_command_turnaround = command_send_time - previous_receive_time;
+  }
+  return converted;
+}
+
+PacketStatistics Robot::Impl::packetStatistics() const noexcept {
+  return packet_statistics_.snapshot();
+}
+
+void Robot::Impl::setControlLoopTimingEnabled(bool enabled) noexcept {
+  control_loop_timing_enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+auto Robot::Impl::controlLoopTiming() const noexcept -> ControlLoopTiming {
+  return control_loop_timing_.snapshot();
+}
+
+auto Robot::Impl::controlLoopTimingRecorder() noexcept -> ControlLoopTimingRecorder* {
+  return control_loop_timing_enabled_.load(std::memory_order_relaxed) ? &control_loop_timing_
+                                                                     : nullptr;
+}
+
+void Robot::Impl::setControlLoopWatchdog(const ControlLoopWatchdog& watchdog) noexcept {
+  control_loop_watchdog_ = watchdog;
+}
+
+auto Robot::Impl::controlLoopWatchdog() const noexcept -> ControlLoopWatchdog {
+  return control_loop_watchdog_;
+}
+
+void Robot::Impl::recordDeadlineMiss() noexcept {
+  // Only the control loop thread counts misses.
+  deadline_misses_.store(deadline_misses_.load(std::memory_order_relaxed) + 1,
+                         std::memory_order_relaxed);
+}
+
+auto Robot::Impl::deadlineMisses() const noexcept -> uint64_t {
+  return deadline_misses_.load(std::memory_order_relaxed);
+}
+
+void Robot::Impl::startTelemetryRecording(const std::string& path) {
+  if (telemetry_recorder_) {
+    throw InvalidOperationException("libfranka robot: Telemetry recording is already running.");
+  }
+  telemetry_recorder_ = std::make_unique<TelemetryRecorder>(path, ri_version_);
+}
+
+auto Robot::Impl::stopTelemetryRecording() -> TelemetryStatistics {
+  if (!telemetry_recorder_) {
+    throw InvalidOperationException("libfranka robot: No telemetry recording is running.");
+  }
+  std::unique_ptr<TelemetryRecorder> recorder = std::move(telemetry_recorder_);
+  return recorder->stop();
 }
 
 void Robot::Impl::updateState(const research_interface::robot::RobotState& robot_state) {
@@ -172,7 +336,7 @@ bool Robot::Impl::controllerRunning() const noexcept {
   return controller_mode_ == research_interface::robot::ControllerMode::kExternalController;
 }
 
-RealtimeConfig Robot::Impl::realtimeConfig() const noexcept {
+auto Robot::Impl::realtimeConfig() const noexcept -> const RealtimeConfig& {
   return realtime_config_;
 }
 
@@ -291,9 +455,8 @@ void Robot::Impl::cancelMotion(uint32_t motion_id) {
     throw ControlException(e.what());
   }
 
-  research_interface::robot::RobotState robot_state;
   do {
-    robot_state = receiveRobotState();
+    receiveRobotState();
   } while (motionGeneratorRunning() || controllerRunning());
 
   // Ignore Move response.
@@ -303,6 +466,48 @@ void Robot::Impl::cancelMotion(uint32_t motion_id) {
   current_move_controller_mode_ = research_interface::robot::ControllerMode::kOther;
 }
 
+void Robot::Impl::configure(const RobotConfiguration& configuration) {
+  configureAsync(configuration).get();
+}
+
+auto Robot::Impl::configureAsync(const RobotConfiguration& configuration) -> std::future<void> {
+  using namespace research_interface::robot;
+
+  auto batch = std::make_shared<CommandBatch>();
+  std::future<void> future = batch->future();
+  if (configuration.collision_behavior) {
+    const auto& behavior = *configuration.collision_behavior;
+    sendCommand<SetCollisionBehavior>(
+        batch->add(), behavior.lower_torque_thresholds_acceleration,
+        behavior.upper_torque_thresholds_acceleration, behavior.lower_torque_thresholds_nominal,
+        behavior.upper_torque_thresholds_nominal, behavior.lower_force_thresholds_acceleration,
+        behavior.upper_force_thresholds_acceleration, behavior.lower_force_thresholds_nominal,
+        behavior.upper_force_thresholds_nominal);
+  }
+  if (configuration.joint_impedance) {
+    sendCommand<SetJointImpedance>(batch->add(), *configuration.joint_impedance);
+  }
+  if (configuration.cartesian_impedance) {
+    sendCommand<SetCartesianImpedance>(batch->add(), *configuration.cartesian_impedance);
+  }
+  if (configuration.guiding_mode) {
+    sendCommand<SetGuidingMode>(batch->add(), configuration.guiding_mode->guiding_mode,
+                                configuration.guiding_mode->elbow);
+  }
+  if (configuration.F_T_EE) {
+    sendCommand<SetFToEE>(batch->add(), *configuration.F_T_EE);
+  }
+  if (configuration.EE_T_K) {
+    sendCommand<SetEEToK>(batch->add(), *configuration.EE_T_K);
+  }
+  if (configuration.load) {
+    sendCommand<SetLoad>(batch->add(), configuration.load->load_mass,
+                         configuration.load->F_x_Cload, configuration.load->load_inertia);
+  }
+  batch->seal();
+  return future;
+}
+
 Model Robot::Impl::loadModel() const {
   return Model(*network_);
 }
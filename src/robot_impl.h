@@ -8,13 +8,22 @@
 #include <research_interface/robot/service_traits.h>
 #include <research_interface/robot/service_types.h>
 
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <exception>
+#include <functional>
+#include <future>
 #include <memory>
 #include <type_traits>
+#include <vector>
 
+#include "control_loop_timing.h"
 #include "logger.h"
 #include "network.h"
+#include "packet_statistics.h"
 #include "robot_control.h"
+#include "telemetry.h"
 
 namespace franka {
 
@@ -24,17 +33,20 @@ class Robot::Impl : public RobotControl {
  public:
   explicit Impl(std::unique_ptr<Network> network,
                 size_t log_size,
-                RealtimeConfig realtime_config = RealtimeConfig::kEnforce);
+                const RealtimeConfig& realtime_config = RealtimeConfig::kEnforce);
 
   auto update(const research_interface::robot::MotionGeneratorCommand* motion_command,
                     const research_interface::robot::ControllerCommand* control_command) -> RobotState override;
+  void send(const research_interface::robot::MotionGeneratorCommand* motion_command,
+            const research_interface::robot::ControllerCommand* control_command) override;
+  auto receive() -> RobotState override;
 
   void throwOnMotionError(const RobotState& robot_state, uint32_t motion_id) override;
 
   auto readOnce() -> RobotState;
 
   [[nodiscard]] auto serverVersion() const noexcept -> ServerVersion ;
-  [[nodiscard]] auto realtimeConfig() const noexcept -> RealtimeConfig override;
+  [[nodiscard]] auto realtimeConfig() const noexcept -> const RealtimeConfig& override;
 
   auto startMotion(
       research_interface::robot::Move::ControllerMode controller_mode,
@@ -49,8 +61,33 @@ class Robot::Impl : public RobotControl {
   template <typename T, typename... TArgs>
   auto executeCommand(TArgs... /* args */) -> uint32_t ;
 
+  /**
+   * Sends a T request without waiting for its response.
+   *
+   * @return Future which becomes ready once the response has been received and handled.
+   */
+  template <typename T, typename... TArgs>
+  auto executeCommandAsync(TArgs... args) -> std::future<void>;
+
+  void configure(const RobotConfiguration& configuration);
+  auto configureAsync(const RobotConfiguration& configuration) -> std::future<void>;
+
   [[nodiscard]] auto loadModel() const -> Model;
 
+  [[nodiscard]] auto packetStatistics() const noexcept -> PacketStatistics;
+
+  void setControlLoopTimingEnabled(bool enabled) noexcept;
+  [[nodiscard]] auto controlLoopTiming() const noexcept -> ControlLoopTiming;
+  auto controlLoopTimingRecorder() noexcept -> ControlLoopTimingRecorder* override;
+
+  void setControlLoopWatchdog(const ControlLoopWatchdog& watchdog) noexcept;
+  [[nodiscard]] auto controlLoopWatchdog() const noexcept -> ControlLoopWatchdog override;
+  void recordDeadlineMiss() noexcept override;
+  [[nodiscard]] auto deadlineMisses() const noexcept -> uint64_t;
+
+  void startTelemetryRecording(const std::string& path);
+  auto stopTelemetryRecording() -> TelemetryStatistics;
+
  protected:
   [[nodiscard]] auto motionGeneratorRunning() const noexcept -> bool;
   [[nodiscard]] auto controllerRunning() const noexcept -> bool;
@@ -101,10 +138,30 @@ class Robot::Impl : public RobotControl {
     }
   }
 
+  /**
+   * Sends a T request and calls on_done from the TCP reader thread once the response has been
+   * handled, with the error if the command failed and nullptr otherwise.
+   */
+  template <typename T, typename... TArgs>
+  void sendCommand(std::function<void(std::exception_ptr)> on_done, TArgs... args);
+
   auto sendRobotCommand(
       const research_interface::robot::MotionGeneratorCommand* motion_command,
       const research_interface::robot::ControllerCommand* control_command) const -> research_interface::robot::RobotCommand ;
-  auto receiveRobotState() -> research_interface::robot::RobotState;
+  /**
+   * Receives the next state.
+   *
+   * @param[in] stale Number of states already drained without being used.
+   */
+  auto receiveRobotState(size_t stale = 0) -> const research_interface::robot::RobotState&;
+  // Returns a callback which records received states in packet_statistics_. It only captures
+  // this, so creating it does not allocate.
+  auto recordPacket() -> std::function<void(const research_interface::robot::RobotState&,
+                                            std::chrono::system_clock::time_point)>;
+  auto convertReceivedState(const research_interface::robot::RobotState& robot_state,
+                            std::chrono::system_clock::time_point previous_receive_time,
+                            std::chrono::system_clock::time_point command_send_time) const
+      -> RobotState;
   void updateState(const research_interface::robot::RobotState& robot_state);
 
   std::unique_ptr<Network> network_;
@@ -121,6 +178,31 @@ class Robot::Impl : public RobotControl {
       research_interface::robot::ControllerMode::kOther;
   research_interface::robot::ControllerMode current_move_controller_mode_;
   uint64_t message_id_;
+
+  // Received states are written directly into the spare slot, which becomes the current one once
+  // it holds a state newer than message_id_.
+  std::array<research_interface::robot::RobotState, 2> received_states_{};
+  size_t current_state_{0};
+
+  // Last command sent with send and its send time, logged together with the next received state.
+  research_interface::robot::RobotCommand sent_command_{};
+  std::chrono::system_clock::time_point command_send_time_{};
+
+  // Host receive time of the current state and the time it has been picked up.
+  std::chrono::system_clock::time_point state_receive_time_{};
+  std::chrono::system_clock::time_point state_pickup_time_{};
+
+  PacketStatisticsRecorder packet_statistics_;
+
+  std::atomic<bool> control_loop_timing_enabled_{false};
+  ControlLoopTimingRecorder control_loop_timing_;
+
+  // Only changed while no control loop is running.
+  ControlLoopWatchdog control_loop_watchdog_;
+  std::atomic<uint64_t> deadline_misses_{0};
+
+  // Only changed while no control or read operation is running.
+  std::unique_ptr<TelemetryRecorder> telemetry_recorder_;
 };
 
 template <>
@@ -278,6 +360,34 @@ auto Robot::Impl::executeCommand(TArgs... args) -> uint32_t {
   return command_id;
 }
 
+template <typename T, typename... TArgs>
+void Robot::Impl::sendCommand(std::function<void(std::exception_ptr)> on_done, TArgs... args) {
+  uint32_t command_id = network_->tcpSendRequest<T>(args...);
+  network_->tcpReceiveResponseAsync<T>(
+      command_id,
+      [this, on_done](const typename T::Response& response) {
+        handleCommandResponse<T>(response);
+        on_done(nullptr);
+      },
+      on_done);
+}
+
+template <typename T, typename... TArgs>
+auto Robot::Impl::executeCommandAsync(TArgs... args) -> std::future<void> {
+  auto promise = std::make_shared<std::promise<void>>();
+  std::future<void> future = promise->get_future();
+  sendCommand<T>(
+      [promise](std::exception_ptr exception) {
+        if (exception != nullptr) {
+          promise->set_exception(exception);
+        } else {
+          promise->set_value();
+        }
+      },
+      args...);
+  return future;
+}
+
 template <>
 inline auto Robot::Impl::
     executeCommand<research_interface::robot::GetCartesianLimit, int32_t, VirtualWallCuboid*>(
@@ -1,6 +1,7 @@
 // Copyright (c) 2017 Franka Emika GmbH
 // Use of this source code is governed by the Apache-2.0 license, see LICENSE
 #include <algorithm>
+#include <chrono>
 #include <cstring>
 #include <iterator>
 #include "franka/robot_state.h"
@@ -81,7 +82,17 @@ auto operator<<(std::ostream& ostream, const franka::RobotState& robot_state) ->
           << ", \"last_motion_errors\": " << robot_state.last_motion_errors
           << ", \"control_command_success_rate\": " << robot_state.control_command_success_rate
           << ", \"robot_mode\": " << robot_state.robot_mode
-          << ", \"time\": " << robot_state.time.toMSec() << "}";
+          << ", \"time\": " << robot_state.time.toMSec() << ", \"host_receive_time\": "
+          << std::chrono::duration_cast<std::chrono::nanoseconds>(
+                 robot_state.host_receive_time.time_since_epoch())
+                 .count()
+          << ", \"host_receive_latency\": " << robot_state.host_receive_latency.count()
+          << ", \"host_command_send_time\": "
+          << std::chrono::duration_cast<std::chrono::nanoseconds>(
+                 robot_state.host_command_send_time.time_since_epoch())
+                 .count()
+          << ", \"host_command_turnaround\": " << robot_state.host_command_turnaround.count()
+          << "}";
   return ostream;
 }
 
@@ -0,0 +1,249 @@
+// Copyright (c) 2017 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include "shared_memory_channel.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include <franka/exception.h>
+
+namespace franka {
+
+DatagramQueue::DatagramQueue(size_t capacity, size_t max_datagram_size)
+    : capacity_(capacity),
+      max_datagram_size_(max_datagram_size),
+      slots_(capacity),
+      data_(capacity * max_datagram_size) {}
+
+auto DatagramQueue::push(const void* data, size_t size) -> bool {
+  return push(data, size, std::chrono::system_clock::now());
+}
+
+auto DatagramQueue::push(const void* data,
+                         size_t size,
+                         std::chrono::system_clock::time_point send_time) -> bool {
+  if (size > max_datagram_size_) {
+    throw std::invalid_argument("libfranka: Datagram too large for shared memory channel");
+  }
+
+  size_t tail = tail_.load(std::memory_order_relaxed);
+  if (tail - head_.load(std::memory_order_acquire) == capacity_) {
+    return false;
+  }
+  size_t index = tail % capacity_;
+  std::memcpy(&data_[index * max_datagram_size_], data, size);
+  slots_[index] = Slot{size, send_time};
+  tail_.store(tail + 1, std::memory_order_release);
+
+  // Pairs with the fence in pop, so that either the consumer sees the new tail or the producer
+  // sees that the consumer is waiting.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (consumer_waiting_.load(std::memory_order_relaxed)) {
+    std::lock_guard<std::mutex> _(wait_mutex_);
+    pushed_.notify_one();
+  }
+  return true;
+}
+
+auto DatagramQueue::pop(void* data,
+                        size_t size,
+                        size_t* datagram_size,
+                        std::chrono::system_clock::time_point* send_time) -> bool {
+  size_t head = head_.load(std::memory_order_relaxed);
+  if (head == tail_.load(std::memory_order_acquire)) {
+    return false;
+  }
+  size_t index = head % capacity_;
+  const Slot slot = slots_[index];
+  bool fits = slot.size <= size;
+  if (fits) {
+    std::memcpy(data, &data_[index * max_datagram_size_], slot.size);
+  }
+  head_.store(head + 1, std::memory_order_release);
+
+  if (!fits) {
+    throw ProtocolException("libfranka: incorrect object size");
+  }
+  *datagram_size = slot.size;
+  if (send_time != nullptr) {
+    *send_time = slot.send_time;
+  }
+  return true;
+}
+
+auto DatagramQueue::pop(void* data,
+                        size_t size,
+                        size_t* datagram_size,
+                        std::chrono::system_clock::time_point* send_time,
+                        std::chrono::steady_clock::time_point deadline) -> bool {
+  // Busy-waits shortly to pick up a datagram as soon as it has been appended.
+  const auto spin_deadline = std::min(deadline, std::chrono::steady_clock::now() + kSpinDuration);
+  do {
+    if (pop(data, size, datagram_size, send_time)) {
+      return true;
+    }
+  } while (std::chrono::steady_clock::now() < spin_deadline);
+
+  auto empty = [this] {
+    return head_.load(std::memory_order_relaxed) == tail_.load(std::memory_order_acquire);
+  };
+  {
+    std::unique_lock<std::mutex> lock(wait_mutex_);
+    consumer_waiting_.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    pushed_.wait_until(lock, deadline, [&] { return !empty(); });
+    consumer_waiting_.store(false, std::memory_order_relaxed);
+  }
+  return pop(data, size, datagram_size, send_time);
+}
+
+auto ByteStream::write(const void* data, size_t size) -> bool {
+  {
+    std::lock_guard<std::mutex> _(mutex_);
+    if (closed_) {
+      return false;
+    }
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    bytes_.insert(bytes_.end(), bytes, bytes + size);
+  }
+  readable_.notify_all();
+  return true;
+}
+
+auto ByteStream::poll(std::chrono::microseconds timeout) -> bool {
+  std::unique_lock<std::mutex> lock(mutex_);
+  return readable_.wait_for(lock, timeout, [this] { return !bytes_.empty() || closed_; });
+}
+
+auto ByteStream::read(void* data, size_t size) -> size_t {
+  std::lock_guard<std::mutex> _(mutex_);
+  size = std::min(size, bytes_.size());
+  std::copy_n(bytes_.begin(), size, static_cast<uint8_t*>(data));
+  bytes_.erase(bytes_.begin(), bytes_.begin() + static_cast<std::ptrdiff_t>(size));
+  return size;
+}
+
+auto ByteStream::readExactly(void* data, size_t size, std::chrono::microseconds timeout) -> bool {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (!readable_.wait_for(lock, timeout, [&] { return bytes_.size() >= size || closed_; }) ||
+      bytes_.size() < size) {
+    return false;
+  }
+  std::copy_n(bytes_.begin(), size, static_cast<uint8_t*>(data));
+  bytes_.erase(bytes_.begin(), bytes_.begin() + static_cast<std::ptrdiff_t>(size));
+  return true;
+}
+
+void ByteStream::close() {
+  {
+    std::lock_guard<std::mutex> _(mutex_);
+    closed_ = true;
+  }
+  readable_.notify_all();
+}
+
+SharedMemoryChannel::Impl::Impl()
+    : states(kDatagramQueueCapacity, kMaxDatagramSize),
+      commands(kDatagramQueueCapacity, kMaxDatagramSize) {}
+
+SharedMemoryChannel::SharedMemoryChannel() : impl_(std::make_shared<Impl>()) {}
+
+SharedMemoryChannel::~SharedMemoryChannel() noexcept = default;
+
+auto SharedMemoryChannel::sendState(const void* data, size_t size) -> bool {
+  return impl_->states.push(data, size);
+}
+
+auto SharedMemoryChannel::receiveCommand(void* data,
+                                         size_t size,
+                                         std::chrono::microseconds timeout) -> size_t {
+  size_t command_size = 0;
+  if (!impl_->commands.pop(data, size, &command_size, nullptr,
+                           std::chrono::steady_clock::now() + timeout)) {
+    return 0;
+  }
+  return command_size;
+}
+
+auto SharedMemoryChannel::receiveRequest(void* data,
+                                         size_t size,
+                                         std::chrono::microseconds timeout) -> bool {
+  return impl_->requests.readExactly(data, size, timeout);
+}
+
+void SharedMemoryChannel::sendResponse(const void* data, size_t size) {
+  impl_->responses.write(data, size);
+}
+
+void SharedMemoryChannel::close() {
+  impl_->responses.close();
+}
+
+SharedMemoryTransport::SharedMemoryTransport(std::shared_ptr<SharedMemoryChannel::Impl> channel,
+                                             std::chrono::milliseconds udp_timeout)
+    : channel_(std::move(channel)), udp_timeout_(udp_timeout) {}
+
+auto SharedMemoryTransport::udpPort() const noexcept -> uint16_t {
+  return 0;
+}
+
+auto SharedMemoryTransport::udpReceive(void* data,
+                                       size_t size,
+                                       std::chrono::system_clock::time_point* receive_time)
+    -> size_t {
+  size_t datagram_size = 0;
+  if (!channel_->states.pop(data, size, &datagram_size, receive_time,
+                            std::chrono::steady_clock::now() + udp_timeout_)) {
+    throw NetworkException("libfranka: UDP receive: Timeout");
+  }
+  return datagram_size;
+}
+
+auto SharedMemoryTransport::udpReceiveBatch(uint8_t* buffer,
+                                            size_t datagram_size,
+                                            size_t max_count,
+                                            std::chrono::system_clock::time_point* receive_times)
+    -> size_t {
+  size_t received = 0;
+  size_t size = 0;
+  while (received < max_count && channel_->states.pop(&buffer[received * datagram_size],
+                                                      datagram_size, &size,
+                                                      &receive_times[received])) {
+    if (size != datagram_size) {
+      throw ProtocolException("libfranka: incorrect object size");
+    }
+    received++;
+  }
+  return received;
+}
+
+void SharedMemoryTransport::udpSend(const void* data, size_t size) {
+  // Like UDP, commands are dropped if the simulator does not keep up.
+  channel_->commands.push(data, size);
+}
+
+void SharedMemoryTransport::tcpSend(const void* data, size_t size) {
+  if (!channel_->requests.write(data, size)) {
+    throw NetworkException("libfranka: TCP send bytes: connection closed");
+  }
+}
+
+auto SharedMemoryTransport::tcpPoll(std::chrono::microseconds timeout) -> bool {
+  return channel_->responses.poll(timeout);
+}
+
+auto SharedMemoryTransport::tcpReceive(void* data, size_t size) -> size_t {
+  size_t bytes_received = channel_->responses.read(data, size);
+  if (bytes_received == 0) {
+    throw NetworkException("libfranka: server closed connection");
+  }
+  return bytes_received;
+}
+
+void SharedMemoryTransport::tcpShutdown() noexcept {
+  channel_->requests.close();
+  channel_->responses.close();
+}
+
+}  // namespace franka
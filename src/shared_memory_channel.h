@@ -0,0 +1,181 @@
+// Copyright (c) 2017 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#pragma once
+
+#include <franka/shared_memory_channel.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "transport.h"
+
+namespace franka {
+
+/**
+ * Lock-free queue of datagrams with a single producer and a single consumer.
+ *
+ * All storage is allocated on construction. Datagrams are dropped if the queue is full.
+ */
+class DatagramQueue {
+ public:
+  DatagramQueue(size_t capacity, size_t max_datagram_size);
+
+  /**
+   * Appends a datagram, stamped with the current time.
+   *
+   * @return False if the datagram has been dropped because the queue is full.
+   *
+   * @throw std::invalid_argument if the datagram is larger than the maximum datagram size.
+   */
+  auto push(const void* data, size_t size) -> bool;
+
+  /**
+   * Like push(const void*, size_t), but stamps the datagram with the given time, e.g. the time
+   * at which it has been received from a socket.
+   */
+  auto push(const void* data, size_t size, std::chrono::system_clock::time_point send_time)
+      -> bool;
+
+  /**
+   * Removes the oldest datagram without blocking.
+   *
+   * @param[out] data Storage for the datagram.
+   * @param[in] size Size of data in bytes.
+   * @param[out] datagram_size Size of the removed datagram.
+   * @param[out] send_time If given, time at which the datagram has been appended.
+   *
+   * @return False if the queue is empty.
+   *
+   * @throw ProtocolException if the datagram does not fit into data. It is removed nevertheless.
+   */
+  auto pop(void* data,
+           size_t size,
+           size_t* datagram_size,
+           std::chrono::system_clock::time_point* send_time) -> bool;
+
+  /**
+   * Like pop, but waits until a datagram is available or the deadline has passed.
+   *
+   * Busy-waits for up to #kSpinDuration to pick up a datagram with low latency, then blocks, so
+   * that a producer on the same core can run even if the caller has real-time priority.
+   */
+  auto pop(void* data,
+           size_t size,
+           size_t* datagram_size,
+           std::chrono::system_clock::time_point* send_time,
+           std::chrono::steady_clock::time_point deadline) -> bool;
+
+  /**
+   * Maximum time pop busy-waits before blocking.
+   */
+  static constexpr std::chrono::microseconds kSpinDuration{50};
+
+ private:
+  struct Slot {
+    size_t size;
+    std::chrono::system_clock::time_point send_time;
+  };
+
+  const size_t capacity_;
+  const size_t max_datagram_size_;
+  std::vector<Slot> slots_;
+  std::vector<uint8_t> data_;
+  // Monotonic positions; the slot index is the position modulo the capacity.
+  std::atomic<size_t> head_{0};
+  std::atomic<size_t> tail_{0};
+
+  // Only locked if the consumer is blocked, so that push stays lock-free otherwise.
+  std::atomic_bool consumer_waiting_{false};
+  std::mutex wait_mutex_;
+  std::condition_variable pushed_;
+};
+
+/**
+ * Reliable in-order byte stream, which can be closed by either side.
+ */
+class ByteStream {
+ public:
+  /**
+   * Appends bytes to the stream.
+   *
+   * @return False if the stream has been closed.
+   */
+  auto write(const void* data, size_t size) -> bool;
+
+  /**
+   * Waits until bytes can be read or the stream has been closed.
+   *
+   * @return False after the timeout.
+   */
+  auto poll(std::chrono::microseconds timeout) -> bool;
+
+  /**
+   * Reads at most size bytes which are already available.
+   *
+   * @return Number of bytes read.
+   */
+  auto read(void* data, size_t size) -> size_t;
+
+  /**
+   * Waits until size bytes are available and reads them.
+   *
+   * @return False after the timeout or if the stream has been closed before.
+   */
+  auto readExactly(void* data, size_t size, std::chrono::microseconds timeout) -> bool;
+
+  void close();
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable readable_;
+  std::deque<uint8_t> bytes_;
+  bool closed_{false};
+};
+
+class SharedMemoryChannel::Impl {
+ public:
+  Impl();
+
+  // Simulator to robot side.
+  DatagramQueue states;
+  ByteStream responses;
+
+  // Robot side to simulator.
+  DatagramQueue commands;
+  ByteStream requests;
+};
+
+/**
+ * Transport over a SharedMemoryChannel, used on the robot side.
+ */
+class SharedMemoryTransport : public Transport {
+ public:
+  SharedMemoryTransport(std::shared_ptr<SharedMemoryChannel::Impl> channel,
+                        std::chrono::milliseconds udp_timeout);
+
+  [[nodiscard]] auto udpPort() const noexcept -> uint16_t override;
+  auto udpReceive(void* data, size_t size, std::chrono::system_clock::time_point* receive_time)
+      -> size_t override;
+  auto udpReceiveBatch(uint8_t* buffer,
+                       size_t datagram_size,
+                       size_t max_count,
+                       std::chrono::system_clock::time_point* receive_times) -> size_t override;
+  void udpSend(const void* data, size_t size) override;
+
+  void tcpSend(const void* data, size_t size) override;
+  auto tcpPoll(std::chrono::microseconds timeout) -> bool override;
+  auto tcpReceive(void* data, size_t size) -> size_t override;
+  void tcpShutdown() noexcept override;
+
+ private:
+  std::shared_ptr<SharedMemoryChannel::Impl> channel_;
+  const std::chrono::milliseconds udp_timeout_;
+};
+
+}  // namespace franka
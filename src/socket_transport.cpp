@@ -0,0 +1,307 @@
+// Copyright (c) 2017 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include "socket_transport.h"
+
+#if defined(__linux__)
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <time.h>
+#endif
+
+#include <Poco/Net/NetException.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <string>
+
+#include <franka/exception.h>
+
+using namespace std::string_literals;
+
+namespace franka {
+
+namespace {
+
+#if defined(__linux__)
+// Ancillary data buffer large enough for a SCM_TIMESTAMPNS message.
+struct ControlBuffer {
+  alignas(cmsghdr) char data[CMSG_SPACE(sizeof(timespec))];
+};
+
+// Returns the kernel receive timestamp of the given message, or the current time if the kernel did
+// not provide one.
+auto kernelReceiveTime(const msghdr& message) -> std::chrono::system_clock::time_point {
+  for (const cmsghdr* header = CMSG_FIRSTHDR(&message); header != nullptr;
+       header = CMSG_NXTHDR(const_cast<msghdr*>(&message), const_cast<cmsghdr*>(header))) {
+    if (header->cmsg_level == SOL_SOCKET && header->cmsg_type == SCM_TIMESTAMPNS) {
+      timespec timestamp{};
+      std::memcpy(&timestamp, CMSG_DATA(header), sizeof(timestamp));
+      return std::chrono::system_clock::time_point(
+          std::chrono::duration_cast<std::chrono::system_clock::duration>(
+              std::chrono::seconds(timestamp.tv_sec) +
+              std::chrono::nanoseconds(timestamp.tv_nsec)));
+    }
+  }
+  return std::chrono::system_clock::now();
+}
+#endif
+
+}  // anonymous namespace
+
+SocketTransport::SocketTransport(const std::string& franka_address,
+                                 uint16_t franka_port,
+                                 const NetworkConfig& config) {
+  if (config.dscp > 63) {
+    throw NetworkException("libfranka: Invalid DSCP value "s + std::to_string(config.dscp));
+  }
+  try {
+    Poco::Timespan poco_timeout(1000l * config.tcp_timeout.count());
+    Poco::Net::SocketAddress address(franka_address, franka_port);
+
+    tcp_socket_.connect(address, poco_timeout);
+    tcp_socket_.setBlocking(true);
+    tcp_socket_.setSendTimeout(poco_timeout);
+    tcp_socket_.setReceiveTimeout(poco_timeout);
+    // Requests are small and may be sent back-to-back without waiting for a response.
+    tcp_socket_.setNoDelay(true);
+
+    if (config.tcp_keepalive) {
+      tcp_socket_.setKeepAlive(true);
+      try {
+      //*----- fix for apple by g alexander 02/26/20----*//
+      //* add -DAPPLE to CXXFLAGS
+        #if defined (APPLE)
+          tcp_socket_.setOption(IPPROTO_TCP, TCP_KEEPALIVE, config.tcp_keepalive_idle);
+        #else
+          tcp_socket_.setOption(IPPROTO_TCP, TCP_KEEPIDLE, config.tcp_keepalive_idle);
+        #endif
+        tcp_socket_.setOption(IPPROTO_TCP, TCP_KEEPCNT, config.tcp_keepalive_count);
+        tcp_socket_.setOption(IPPROTO_TCP, TCP_KEEPINTVL, config.tcp_keepalive_interval);
+      } catch (...) {
+      }
+    }
+    if (config.dscp > 0) {
+      // The DSCP occupies the upper six bits of the TOS field.
+      try {
+        tcp_socket_.setOption(IPPROTO_IP, IP_TOS, config.dscp << 2);
+      } catch (...) {
+      }
+    }
+
+    // A default-constructed socket is only opened by bind, so it is configured afterwards.
+    udp_socket_.bind({"0.0.0.0", config.udp_port});
+    configureUdpSocket(config);
+    udp_socket_.setReceiveTimeout(Poco::Timespan{1000l * config.udp_timeout.count()});
+#if defined(__linux__)
+    try {
+      udp_socket_.setOption(SOL_SOCKET, SO_TIMESTAMPNS, 1);
+    } catch (...) {
+      // Without kernel timestamps, datagrams are timestamped when they are read.
+    }
+#endif
+    udp_port_ = udp_socket_.address().port();
+  } catch (const Poco::Net::NetException& e) {
+    throw NetworkException("libfranka: Connection error: "s + e.what());
+  } catch (const Poco::TimeoutException& e) {
+    throw NetworkException("libfranka: Connection timeout"s);
+  } catch (const Poco::Exception& e) {
+    throw NetworkException("libfranka: "s + e.what());
+  }
+}
+
+void SocketTransport::configureUdpSocket(const NetworkConfig& config) {
+  auto set_option = [this](int level, int option, int value, const char* name) {
+    try {
+      udp_socket_.setOption(level, option, value);
+    } catch (const Poco::Exception& e) {
+      throw NetworkException("libfranka: Could not set "s + name + ": " + e.what());
+    }
+  };
+
+  if (config.udp_receive_buffer_size > 0) {
+    set_option(SOL_SOCKET, SO_RCVBUF, config.udp_receive_buffer_size, "SO_RCVBUF");
+  }
+  if (config.udp_send_buffer_size > 0) {
+    set_option(SOL_SOCKET, SO_SNDBUF, config.udp_send_buffer_size, "SO_SNDBUF");
+  }
+  if (config.dscp > 0) {
+    set_option(IPPROTO_IP, IP_TOS, config.dscp << 2, "IP_TOS");
+  }
+
+#if defined(__linux__)
+  if (config.udp_busy_poll.count() > 0) {
+    set_option(SOL_SOCKET, SO_BUSY_POLL, static_cast<int>(config.udp_busy_poll.count()),
+               "SO_BUSY_POLL");
+  }
+  if (!config.network_interface.empty()) {
+    if (setsockopt(udp_socket_.impl()->sockfd(), SOL_SOCKET, SO_BINDTODEVICE,
+                   config.network_interface.c_str(),
+                   static_cast<socklen_t>(config.network_interface.size() + 1)) != 0) {
+      throw NetworkException("libfranka: Could not bind to interface "s +
+                             config.network_interface + ": " + std::strerror(errno));
+    }
+  }
+#else
+  if (config.udp_busy_poll.count() > 0 || !config.network_interface.empty()) {
+    throw NetworkException(
+        "libfranka: Busy polling and binding to an interface are only supported on Linux");
+  }
+#endif
+}
+
+auto SocketTransport::udpPort() const noexcept -> uint16_t {
+  return udp_port_;
+}
+
+auto SocketTransport::udpReceive(void* data,
+                                 size_t size,
+                                 std::chrono::system_clock::time_point* receive_time) -> size_t {
+#if defined(__linux__)
+  iovec buffer{data, size};
+  sockaddr_storage address{};
+  ControlBuffer control{};
+  msghdr message{};
+  message.msg_iov = &buffer;
+  message.msg_iovlen = 1;
+  message.msg_name = &address;
+  message.msg_namelen = sizeof(address);
+  message.msg_control = control.data;
+  message.msg_controllen = sizeof(control.data);
+
+  ssize_t bytes_received = 0;
+  do {
+    // Blocks for at most the receive timeout set on the socket.
+    bytes_received = recvmsg(udp_socket_.impl()->sockfd(), &message, 0);
+  } while (bytes_received < 0 && errno == EINTR);
+  if (bytes_received < 0) {
+    if (errno == EAGAIN || errno == EWOULDBLOCK) {
+      throw NetworkException("libfranka: UDP receive: Timeout");
+    }
+    throw NetworkException("libfranka: UDP receive: "s + std::strerror(errno));
+  }
+  if ((message.msg_flags & MSG_TRUNC) != 0) {
+    throw ProtocolException("libfranka: incorrect object size");
+  }
+
+  udp_server_address_ =
+      Poco::Net::SocketAddress(reinterpret_cast<const sockaddr*>(&address), message.msg_namelen);
+  if (receive_time != nullptr) {
+    *receive_time = kernelReceiveTime(message);
+  }
+  return static_cast<size_t>(bytes_received);
+#else
+  try {
+    int bytes_received =
+        udp_socket_.receiveFrom(data, static_cast<int>(size), udp_server_address_);
+    if (receive_time != nullptr) {
+      *receive_time = std::chrono::system_clock::now();
+    }
+    return static_cast<size_t>(bytes_received);
+  } catch (const Poco::Exception& e) {
+    throw NetworkException("libfranka: UDP receive: "s + e.what());
+  }
+#endif
+}
+
+auto SocketTransport::udpReceiveBatch(uint8_t* buffer,
+                                      size_t datagram_size,
+                                      size_t max_count,
+                                      std::chrono::system_clock::time_point* receive_times)
+    -> size_t {
+#if defined(__linux__)
+  max_count = std::min(max_count, kMaxReceiveBatchSize);
+  std::array<mmsghdr, kMaxReceiveBatchSize> headers{};
+  std::array<iovec, kMaxReceiveBatchSize> buffers{};
+  std::array<sockaddr_storage, kMaxReceiveBatchSize> addresses{};
+  std::array<ControlBuffer, kMaxReceiveBatchSize> controls{};
+  for (size_t i = 0; i < max_count; i++) {
+    buffers[i].iov_base = &buffer[i * datagram_size];
+    buffers[i].iov_len = datagram_size;
+    headers[i].msg_hdr.msg_iov = &buffers[i];
+    headers[i].msg_hdr.msg_iovlen = 1;
+    headers[i].msg_hdr.msg_name = &addresses[i];
+    headers[i].msg_hdr.msg_namelen = sizeof(addresses[i]);
+    headers[i].msg_hdr.msg_control = controls[i].data;
+    headers[i].msg_hdr.msg_controllen = sizeof(controls[i].data);
+  }
+
+  int datagrams = recvmmsg(udp_socket_.impl()->sockfd(), headers.data(),
+                           static_cast<unsigned int>(max_count), MSG_DONTWAIT, nullptr);
+  if (datagrams < 0) {
+    if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+      return 0;
+    }
+    throw NetworkException("libfranka: UDP receive: "s + std::strerror(errno));
+  }
+
+  for (int i = 0; i < datagrams; i++) {
+    if (headers[i].msg_len != datagram_size || (headers[i].msg_hdr.msg_flags & MSG_TRUNC) != 0) {
+      throw ProtocolException("libfranka: incorrect object size");
+    }
+    receive_times[i] = kernelReceiveTime(headers[i].msg_hdr);
+  }
+  if (datagrams > 0) {
+    const mmsghdr& last = headers[datagrams - 1];
+    udp_server_address_ = Poco::Net::SocketAddress(
+        reinterpret_cast<const sockaddr*>(last.msg_hdr.msg_name), last.msg_hdr.msg_namelen);
+  }
+  return static_cast<size_t>(datagrams);
+#else
+  size_t received = 0;
+  try {
+    while (received < max_count &&
+           udp_socket_.available() >= static_cast<int>(datagram_size)) {
+      if (udpReceive(&buffer[received * datagram_size], datagram_size,
+                     &receive_times[received]) != datagram_size) {
+        throw ProtocolException("libfranka: incorrect object size");
+      }
+      received++;
+    }
+  } catch (const Poco::Exception& e) {
+    throw NetworkException("libfranka: UDP receive: "s + e.what());
+  }
+  return received;
+#endif
+}
+
+void SocketTransport::udpSend(const void* data, size_t size) try {
+  int bytes_sent = udp_socket_.sendTo(data, static_cast<int>(size), udp_server_address_);
+  if (bytes_sent != static_cast<int>(size)) {
+    throw NetworkException("libfranka: could not send UDP data");
+  }
+} catch (const Poco::Exception& e) {
+  throw NetworkException("libfranka: UDP send: "s + e.what());
+}
+
+void SocketTransport::tcpSend(const void* data, size_t size) try {
+  tcp_socket_.sendBytes(data, static_cast<int>(size));
+} catch (const Poco::Exception& e) {
+  throw NetworkException("libfranka: TCP send bytes: "s + e.what());
+}
+
+auto SocketTransport::tcpPoll(std::chrono::microseconds timeout) -> bool try {
+  return tcp_socket_.poll(timeout.count(), Poco::Net::Socket::SELECT_READ);
+} catch (const Poco::Exception& e) {
+  throw NetworkException("libfranka: TCP receive: "s + e.what());
+}
+
+auto SocketTransport::tcpReceive(void* data, size_t size) -> size_t try {
+  int bytes_received = tcp_socket_.receiveBytes(data, static_cast<int>(size));
+  if (bytes_received <= 0) {
+    throw NetworkException("libfranka: server closed connection");
+  }
+  return static_cast<size_t>(bytes_received);
+} catch (const Poco::Exception& e) {
+  throw NetworkException("libfranka: TCP receive: "s + e.what());
+}
+
+void SocketTransport::tcpShutdown() noexcept {
+  try {
+    tcp_socket_.shutdown();
+  } catch (...) {
+  }
+}
+
+}  // namespace franka
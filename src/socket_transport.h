@@ -0,0 +1,54 @@
+// Copyright (c) 2017 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#pragma once
+
+#include <franka/network_config.h>
+#include <Poco/Net/DatagramSocket.h>
+#include <Poco/Net/SocketAddress.h>
+#include <Poco/Net/StreamSocket.h>
+
+#include <string>
+
+#include "transport.h"
+
+namespace franka {
+
+/**
+ * Transport over a TCP connection and a UDP socket, as used for the real hardware.
+ */
+class SocketTransport : public Transport {
+ public:
+  /**
+   * Connects to the given server and opens the UDP socket.
+   *
+   * @throw NetworkException if the connection is unsuccessful or the socket settings cannot be
+   * applied.
+   */
+  SocketTransport(const std::string& franka_address,
+                  uint16_t franka_port,
+                  const NetworkConfig& config);
+
+  [[nodiscard]] auto udpPort() const noexcept -> uint16_t override;
+  auto udpReceive(void* data, size_t size, std::chrono::system_clock::time_point* receive_time)
+      -> size_t override;
+  auto udpReceiveBatch(uint8_t* buffer,
+                       size_t datagram_size,
+                       size_t max_count,
+                       std::chrono::system_clock::time_point* receive_times) -> size_t override;
+  void udpSend(const void* data, size_t size) override;
+
+  void tcpSend(const void* data, size_t size) override;
+  auto tcpPoll(std::chrono::microseconds timeout) -> bool override;
+  auto tcpReceive(void* data, size_t size) -> size_t override;
+  void tcpShutdown() noexcept override;
+
+ private:
+  void configureUdpSocket(const NetworkConfig& config);
+
+  Poco::Net::StreamSocket tcp_socket_;
+  Poco::Net::DatagramSocket udp_socket_;
+  Poco::Net::SocketAddress udp_server_address_;
+  uint16_t udp_port_;
+};
+
+}  // namespace franka
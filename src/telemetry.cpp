@@ -0,0 +1,174 @@
+// Copyright (c) 2017 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include "telemetry.h"
+
+#include <cstring>
+
+#include <franka/exception.h>
+
+#include "logger.h"
+#include "relaxed_counter.h"
+#include "robot_impl.h"
+
+namespace franka {
+
+namespace {
+
+auto toNanoseconds(std::chrono::system_clock::time_point time) noexcept -> int64_t {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+auto toTimePoint(int64_t nanoseconds) noexcept -> std::chrono::system_clock::time_point {
+  return std::chrono::system_clock::time_point(
+      std::chrono::duration_cast<std::chrono::system_clock::duration>(
+          std::chrono::nanoseconds(nanoseconds)));
+}
+
+}  // anonymous namespace
+
+constexpr std::array<char, 8> TelemetryFileHeader::kMagic;
+constexpr size_t TelemetryRecorder::kQueueCapacity;
+constexpr std::chrono::milliseconds TelemetryRecorder::kWriteInterval;
+
+TelemetryRecorder::TelemetryRecorder(const std::string& path, uint16_t version)
+    : path_(path),
+      file_(path, std::ios::binary | std::ios::trunc),
+      queue_(kQueueCapacity, kRecordSize),
+      record_buffer_(kRecordSize),
+      write_buffer_(kRecordSize) {
+  TelemetryFileHeader header{
+      TelemetryFileHeader::kMagic, version,
+      static_cast<uint32_t>(sizeof(research_interface::robot::RobotState)),
+      static_cast<uint32_t>(sizeof(research_interface::robot::RobotCommand))};
+  file_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  if (!file_) {
+    throw Exception("libfranka: Cannot create telemetry file " + path_);
+  }
+  writer_ = std::thread(&TelemetryRecorder::run, this);
+}
+
+TelemetryRecorder::~TelemetryRecorder() noexcept {
+  if (writer_.joinable()) {
+    stopped_ = true;
+    writer_.join();
+  }
+}
+
+void TelemetryRecorder::record(const research_interface::robot::RobotState& state,
+                               const research_interface::robot::RobotCommand& command,
+                               const RobotState& converted) noexcept {
+  TelemetryRecordHeader header{
+      toNanoseconds(converted.host_receive_time),
+      toNanoseconds(converted.host_receive_time) + converted.host_receive_latency.count(),
+      toNanoseconds(converted.host_command_send_time)};
+  uint8_t* data = record_buffer_.data();
+  std::memcpy(data, &header, sizeof(header));
+  std::memcpy(data + sizeof(header), &state, sizeof(state));
+  std::memcpy(data + sizeof(header) + sizeof(state), &command, sizeof(command));
+  if (queue_.push(data, kRecordSize, converted.host_receive_time)) {
+    relaxedAdd(recorded_, 1);
+  } else {
+    relaxedAdd(dropped_, 1);
+  }
+}
+
+auto TelemetryRecorder::stop() -> TelemetryStatistics {
+  if (writer_.joinable()) {
+    stopped_ = true;
+    writer_.join();
+  }
+  file_.close();
+  if (failed_ || file_.fail()) {
+    throw Exception("libfranka: Writing telemetry file " + path_ + " failed.");
+  }
+  return TelemetryStatistics{recorded_.load(), dropped_.load()};
+}
+
+void TelemetryRecorder::run() noexcept {
+  while (!stopped_) {
+    std::this_thread::sleep_for(kWriteInterval);
+    write();
+  }
+  // Pick up records queued before stopped_ has been set.
+  write();
+}
+
+void TelemetryRecorder::write() noexcept {
+  size_t size = 0;
+  while (queue_.pop(write_buffer_.data(), write_buffer_.size(), &size, nullptr)) {
+    if (!failed_) {
+      file_.write(reinterpret_cast<const char*>(write_buffer_.data()),
+                  static_cast<std::streamsize>(size));
+    }
+  }
+  if (!failed_) {
+    file_.flush();
+    failed_ = file_.fail();
+  }
+}
+
+class TelemetryReader::Impl {
+ public:
+  explicit Impl(const std::string& path) : path_(path), file_(path, std::ios::binary) {
+    if (!file_) {
+      throw Exception("libfranka: Cannot open telemetry file " + path_);
+    }
+    TelemetryFileHeader header{};
+    if (!file_.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        header.magic != TelemetryFileHeader::kMagic) {
+      throw Exception("libfranka: " + path_ + " is not a telemetry file.");
+    }
+    if (header.version != research_interface::robot::kVersion ||
+        header.state_size != sizeof(research_interface::robot::RobotState) ||
+        header.command_size != sizeof(research_interface::robot::RobotCommand)) {
+      throw IncompatibleVersionException(header.version, research_interface::robot::kVersion);
+    }
+  }
+
+  auto read(Record* record) -> bool {
+    TelemetryRecordHeader header{};
+    research_interface::robot::RobotState state{};
+    research_interface::robot::RobotCommand command{};
+    if (!file_.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+      if (file_.gcount() == 0 && file_.eof()) {
+        return false;
+      }
+      throw Exception("libfranka: Cannot read telemetry file " + path_);
+    }
+    if (!file_.read(reinterpret_cast<char*>(&state), sizeof(state)) ||
+        !file_.read(reinterpret_cast<char*>(&command), sizeof(command))) {
+      throw Exception("libfranka: Telemetry file " + path_ + " ends within a record.");
+    }
+
+    record->state = convertRobotState(state);
+    record->state.host_receive_time = toTimePoint(header.receive_time);
+    record->state.host_receive_latency =
+        std::chrono::nanoseconds(header.pickup_time - header.receive_time);
+    if (header.command_send_time != 0) {
+      record->state.host_command_send_time = toTimePoint(header.command_send_time);
+      // The turnaround is measured from the receive time of the previous state.
+      if (previous_receive_time_ != 0) {
+        record->state.host_command_turnaround =
+            std::chrono::nanoseconds(header.command_send_time - previous_receive_time_);
+      }
+    }
+    record->command = convertRobotCommand(command);
+    previous_receive_time_ = header.receive_time;
+    return true;
+  }
+
+ private:
+  const std::string path_;
+  std::ifstream file_;
+  int64_t previous_receive_time_{0};
+};
+
+TelemetryReader::TelemetryReader(const std::string& path) : impl_(std::make_unique<Impl>(path)) {}
+
+TelemetryReader::~TelemetryReader() noexcept = default;
+
+auto TelemetryReader::read(Record* record) -> bool {
+  return impl_->read(record);
+}
+
+}  // namespace franka
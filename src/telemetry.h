@@ -0,0 +1,131 @@
+// Copyright (c) 2017 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <franka/robot_state.h>
+#include <franka/telemetry.h>
+#include <research_interface/robot/rbk_types.h>
+
+#include "shared_memory_channel.h"
+
+namespace franka {
+
+#pragma pack(push, 1)
+
+/**
+ * Header at the start of a telemetry file.
+ */
+struct TelemetryFileHeader {
+  static constexpr std::array<char, 8> kMagic{{'F', 'R', 'A', 'N', 'K', 'A', 'T', 'L'}};
+
+  std::array<char, 8> magic;
+  uint16_t version;
+  uint32_t state_size;
+  uint32_t command_size;
+};
+
+/**
+ * Host timestamps preceding the state and command of each record, in nanoseconds since the epoch
+ * of the system clock. A command send time of zero means that no command has been sent.
+ */
+struct TelemetryRecordHeader {
+  int64_t receive_time;
+  int64_t pickup_time;
+  int64_t command_send_time;
+};
+
+#pragma pack(pop)
+
+/**
+ * Streams robot states and commands to a telemetry file.
+ *
+ * The thread calling record only copies the record into a lock-free queue, from which a writer
+ * thread appends them to the file every #kWriteInterval. Records are dropped if the writer thread
+ * falls behind by more than #kQueueCapacity records.
+ */
+class TelemetryRecorder {
+ public:
+  /**
+   * Number of records which can be queued, i.e. about four seconds of states.
+   */
+  static constexpr size_t kQueueCapacity = 4096;
+
+  /**
+   * Time between two writes of the queued records.
+   */
+  static constexpr std::chrono::milliseconds kWriteInterval{10};
+
+  /**
+   * Creates the file, writes its header and starts the writer thread.
+   *
+   * @param[in] path Path of the file, which is overwritten if it exists.
+   * @param[in] version Research interface version of the recorded states and commands.
+   *
+   * @throw Exception if the file cannot be created.
+   */
+  TelemetryRecorder(const std::string& path, uint16_t version);
+
+  /**
+   * Stops the writer thread if stop has not been called.
+   */
+  ~TelemetryRecorder() noexcept;
+
+  /**
+   * Queues a record without blocking. Only one thread may record at a time.
+   *
+   * @param[in] state State as received from the robot.
+   * @param[in] command Command sent before the state.
+   * @param[in] converted State converted from the received one, holding the host timestamps.
+   */
+  void record(const research_interface::robot::RobotState& state,
+              const research_interface::robot::RobotCommand& command,
+              const RobotState& converted) noexcept;
+
+  /**
+   * Writes the remaining records, stops the writer thread and closes the file.
+   *
+   * @return Numbers of recorded and dropped states.
+   *
+   * @throw Exception if writing the file failed.
+   */
+  auto stop() -> TelemetryStatistics;
+
+  TelemetryRecorder(const TelemetryRecorder&) = delete;
+  auto operator=(const TelemetryRecorder&) -> TelemetryRecorder& = delete;
+
+ private:
+  static constexpr size_t kRecordSize = sizeof(TelemetryRecordHeader) +
+                                        sizeof(research_interface::robot::RobotState) +
+                                        sizeof(research_interface::robot::RobotCommand);
+
+  void run() noexcept;
+  void write() noexcept;
+
+  const std::string path_;
+  std::ofstream file_;
+  DatagramQueue queue_;
+
+  // Used by the recording thread only.
+  std::vector<uint8_t> record_buffer_;
+  // Used by the writer thread only.
+  std::vector<uint8_t> write_buffer_;
+
+  std::atomic<uint64_t> recorded_{0};
+  std::atomic<uint64_t> dropped_{0};
+  std::atomic_bool stopped_{false};
+  // Only written by the writer thread before it has been joined.
+  bool failed_{false};
+
+  std::thread writer_;
+};
+
+}  // namespace franka
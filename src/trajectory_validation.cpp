@@ -0,0 +1,487 @@
+// Copyright (c) 2017 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <franka/trajectory_validation.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <thread>
+
+#include <Eigen/Dense>
+
+#include <franka/control_tools.h>
+#include <franka/rate_limiting.h>
+
+namespace franka {
+
+namespace {
+
+using Violations = std::vector<TrajectoryViolation>;
+
+// Time derivatives of a commanded value, or of the norm of a Cartesian one.
+struct Derivatives {
+  double velocity;
+  double acceleration;
+  double jerk;
+};
+
+// Limits of the derivatives, in the same order.
+struct Limits {
+  double velocity;
+  double acceleration;
+  double jerk;
+};
+
+template <size_t N>
+auto allFinite(const std::array<double, N>& values) noexcept -> bool {
+  return std::all_of(values.begin(), values.end(), [](double d) { return std::isfinite(d); });
+}
+
+// Differentiates over one cycle.
+template <size_t N>
+auto differentiate(const std::array<double, N>& value, const std::array<double, N>& last_value)
+    -> std::array<double, N> {
+  std::array<double, N> derivative{};
+  for (size_t i = 0; i < N; i++) {
+    derivative[i] = (value[i] - last_value[i]) / kDeltaT;
+  }
+  return derivative;
+}
+
+// Norm of three elements of a Cartesian twist, starting at offset.
+auto norm(const std::array<double, 6>& values, size_t offset) noexcept -> double {
+  return std::sqrt(values[offset] * values[offset] + values[offset + 1] * values[offset + 1] +
+                   values[offset + 2] * values[offset + 2]);
+}
+
+// Twist which moves the last pose to the pose in one cycle, computed like in limitRate.
+auto twist(const std::array<double, 16>& pose, const std::array<double, 16>& last_pose)
+    -> std::array<double, 6> {
+  Eigen::Affine3d commanded_pose(Eigen::Matrix4d::Map(pose.data()));
+  Eigen::Affine3d last_commanded_pose(Eigen::Matrix4d::Map(last_pose.data()));
+  Eigen::AngleAxisd rot_difference(commanded_pose.linear() *
+                                   last_commanded_pose.linear().transpose());
+
+  std::array<double, 6> result{};
+  Eigen::Map<Eigen::Matrix<double, 6, 1>> dx(result.data());
+  dx.head(3) << (commanded_pose.translation() - last_commanded_pose.translation()) / kDeltaT;
+  dx.tail(3) << rot_difference.axis() * rot_difference.angle() / kDeltaT;
+  return result;
+}
+
+auto classify(const Derivatives& derivatives, const Limits& limits) noexcept
+    -> TrajectoryViolationType {
+  if (!(std::abs(derivatives.velocity) <= limits.velocity)) {
+    return TrajectoryViolationType::kVelocityLimit;
+  }
+  if (!(std::abs(derivatives.acceleration) <= limits.acceleration)) {
+    return TrajectoryViolationType::kAccelerationLimit;
+  }
+  if (!(std::abs(derivatives.jerk) <= limits.jerk)) {
+    return TrajectoryViolationType::kJerkLimit;
+  }
+  return TrajectoryViolationType::kRateLimited;
+}
+
+void addViolation(size_t sample,
+                  size_t component,
+                  TrajectoryViolationType type,
+                  double deviation,
+                  Violations* violations) {
+  violations->push_back(TrajectoryViolation{sample, component, type, deviation});
+}
+
+// Reports a rate-limited component, if it changed by more than the tolerance.
+void checkDeviation(size_t sample,
+                    size_t component,
+                    double deviation,
+                    const Derivatives& derivatives,
+                    const Limits& limits,
+                    double tolerance,
+                    Violations* violations) {
+  if (deviation > tolerance) {
+    addViolation(sample, component, classify(derivatives, limits), deviation, violations);
+  }
+}
+
+// Commanded values of the last four cycles, starting with the current one. Before the first
+// sample, the robot rests at the first sample for positions, and has zero velocity for velocities.
+template <size_t N>
+using History = std::array<std::array<double, N>, 4>;
+
+template <typename Get>
+auto positionHistory(size_t sample, Get get) -> History<std::tuple_size<decltype(get(0))>::value> {
+  History<std::tuple_size<decltype(get(0))>::value> history{};
+  for (size_t back = 0; back < history.size(); back++) {
+    history[back] = get(sample >= back ? sample - back : 0);
+  }
+  return history;
+}
+
+template <typename Get>
+auto velocityHistory(size_t sample, Get get) -> History<std::tuple_size<decltype(get(0))>::value> {
+  History<std::tuple_size<decltype(get(0))>::value> history{};
+  for (size_t back = 0; back <= std::min<size_t>(sample, history.size() - 1); back++) {
+    history[back] = get(sample - back);
+  }
+  return history;
+}
+
+// Differentiates a velocity history to the accelerations of the current and last cycle and the
+// current jerk.
+template <size_t N>
+struct VelocityDerivatives {
+  explicit VelocityDerivatives(const History<N>& velocities)
+      : acceleration(differentiate(velocities[0], velocities[1])),
+        last_acceleration(differentiate(velocities[1], velocities[2])),
+        jerk(differentiate(acceleration, last_acceleration)) {}
+
+  std::array<double, N> acceleration;
+  std::array<double, N> last_acceleration;
+  std::array<double, N> jerk;
+};
+
+void checkJoints(size_t sample,
+                 const std::array<double, 7>& commanded,
+                 const std::array<double, 7>& limited,
+                 const History<7>& velocities,
+                 const VelocityDerivatives<7>& derivatives,
+                 double tolerance,
+                 Violations* violations) {
+  for (size_t i = 0; i < 7; i++) {
+    checkDeviation(
+        sample, i, std::abs(limited[i] - commanded[i]),
+        {velocities[0][i], derivatives.acceleration[i], derivatives.jerk[i]},
+        {kMaxJointVelocity[i], kMaxJointAcceleration[i], kMaxJointJerk[i]}, tolerance, violations);
+  }
+}
+
+// Reports non-finite joints and returns whether the sample can be rate limited.
+auto checkFiniteJoints(size_t sample, const std::array<double, 7>& values, Violations* violations)
+    -> bool {
+  for (size_t i = 0; i < 7; i++) {
+    if (!std::isfinite(values[i])) {
+      addViolation(sample, i, TrajectoryViolationType::kNotFinite, 0.0, violations);
+    }
+  }
+  return allFinite(values);
+}
+
+// Reports joints whose velocity is not finite, e.g. after an overflow, which the limiter rejects.
+auto checkFiniteVelocities(size_t sample,
+                           const std::array<double, 7>& velocities,
+                           Violations* violations) -> bool {
+  for (size_t i = 0; i < 7; i++) {
+    if (!std::isfinite(velocities[i])) {
+      addViolation(sample, i, TrajectoryViolationType::kVelocityLimit,
+                   std::numeric_limits<double>::infinity(), violations);
+    }
+  }
+  return allFinite(velocities);
+}
+
+template <size_t N>
+auto allFinite(const History<N>& history) noexcept -> bool {
+  return std::all_of(history.begin(), history.end(),
+                     [](const std::array<double, N>& values) { return allFinite(values); });
+}
+
+// Checks and rate limits the elbow of a Cartesian sample, which is a position in all Cartesian
+// motions.
+template <typename T>
+void checkElbow(const Trajectory<T>& trajectory,
+                size_t sample,
+                double tolerance,
+                Violations* violations) {
+  constexpr size_t kElbow = 2;
+  const std::array<double, 2>& elbow = trajectory[sample].elbow;
+  if (!trajectory[sample].hasElbow()) {
+    return;
+  }
+  if (!allFinite(elbow)) {
+    addViolation(sample, kElbow, TrajectoryViolationType::kNotFinite, 0.0, violations);
+    return;
+  }
+  if (!isValidElbow(elbow)) {
+    addViolation(sample, kElbow, TrajectoryViolationType::kInvalidElbow, 0.0, violations);
+    return;
+  }
+
+  std::array<double, 4> positions{};
+  for (size_t back = 0; back < positions.size(); back++) {
+    const T& previous = trajectory[sample >= back ? sample - back : 0];
+    if (!previous.hasElbow() || !std::isfinite(previous.elbow[0])) {
+      return;
+    }
+    positions[back] = previous.elbow[0];
+  }
+  std::array<double, 3> velocities{};
+  for (size_t i = 0; i < velocities.size(); i++) {
+    velocities[i] = (positions[i] - positions[i + 1]) / kDeltaT;
+  }
+  if (!std::isfinite(velocities[0])) {
+    addViolation(sample, kElbow, TrajectoryViolationType::kVelocityLimit,
+                 std::numeric_limits<double>::infinity(), violations);
+    return;
+  }
+  double acceleration = (velocities[0] - velocities[1]) / kDeltaT;
+  double last_acceleration = (velocities[1] - velocities[2]) / kDeltaT;
+
+  double limited = limitRate(kMaxElbowVelocity, kMaxElbowAcceleration, kMaxElbowJerk,
+                             positions[0], positions[1], velocities[1], last_acceleration);
+  checkDeviation(sample, kElbow, std::abs(limited - positions[0]),
+                 {velocities[0], acceleration, (acceleration - last_acceleration) / kDeltaT},
+                 {kMaxElbowVelocity, kMaxElbowAcceleration, kMaxElbowJerk}, tolerance, violations);
+}
+
+// Reports the translation and rotation of a rate-limited Cartesian twist.
+void checkTwist(size_t sample,
+                const History<6>& twists,
+                const VelocityDerivatives<6>& derivatives,
+                const Limits& translational_limits,
+                const Limits& rotational_limits,
+                double translation_deviation,
+                double rotation_deviation,
+                double tolerance,
+                Violations* violations) {
+  checkDeviation(sample, 0, translation_deviation,
+                 {norm(twists[0], 0), norm(derivatives.acceleration, 0), norm(derivatives.jerk, 0)},
+                 translational_limits, tolerance, violations);
+  checkDeviation(sample, 1, rotation_deviation,
+                 {norm(twists[0], 3), norm(derivatives.acceleration, 3), norm(derivatives.jerk, 3)},
+                 rotational_limits, tolerance, violations);
+}
+
+// Reports a Cartesian twist which is not finite, e.g. after an overflow.
+auto checkFiniteTwist(size_t sample, const std::array<double, 6>& twist, Violations* violations)
+    -> bool {
+  for (size_t component = 0; component < 2; component++) {
+    if (!std::isfinite(norm(twist, 3 * component))) {
+      addViolation(sample, component, TrajectoryViolationType::kVelocityLimit,
+                   std::numeric_limits<double>::infinity(), violations);
+    }
+  }
+  return allFinite(twist);
+}
+
+template <typename T>
+void checkSample(const Trajectory<T>& trajectory,
+                 size_t sample,
+                 double tolerance,
+                 Violations* violations);
+
+template <>
+void checkSample<JointPositions>(const Trajectory<JointPositions>& trajectory,
+                                 size_t sample,
+                                 double tolerance,
+                                 Violations* violations) {
+  History<7> positions = positionHistory(sample, [&](size_t i) { return trajectory[i].q; });
+  if (!checkFiniteJoints(sample, positions[0], violations) || !allFinite(positions)) {
+    return;
+  }
+  History<7> velocities{};
+  for (size_t back = 0; back < 3; back++) {
+    velocities[back] = differentiate(positions[back], positions[back + 1]);
+  }
+  if (!checkFiniteVelocities(sample, velocities[0], violations) || !allFinite(velocities)) {
+    return;
+  }
+  VelocityDerivatives<7> derivatives(velocities);
+  std::array<double, 7> limited =
+      limitRate(kMaxJointVelocity, kMaxJointAcceleration, kMaxJointJerk, positions[0],
+                positions[1], velocities[1], derivatives.last_acceleration);
+  checkJoints(sample, positions[0], limited, velocities, derivatives, tolerance, violations);
+}
+
+template <>
+void checkSample<JointVelocities>(const Trajectory<JointVelocities>& trajectory,
+                                  size_t sample,
+                                  double tolerance,
+                                  Violations* violations) {
+  History<7> velocities = velocityHistory(sample, [&](size_t i) { return trajectory[i].dq; });
+  if (!checkFiniteJoints(sample, velocities[0], violations) || !allFinite(velocities)) {
+    return;
+  }
+  VelocityDerivatives<7> derivatives(velocities);
+  std::array<double, 7> limited =
+      limitRate(kMaxJointVelocity, kMaxJointAcceleration, kMaxJointJerk, velocities[0],
+                velocities[1], derivatives.last_acceleration);
+  checkJoints(sample, velocities[0], limited, velocities, derivatives, tolerance, violations);
+}
+
+template <>
+void checkSample<CartesianPose>(const Trajectory<CartesianPose>& trajectory,
+                                size_t sample,
+                                double tolerance,
+                                Violations* violations) {
+  const std::array<double, 16>& pose = trajectory[sample].O_T_EE;
+  if (!allFinite(pose)) {
+    addViolation(sample, 0, TrajectoryViolationType::kNotFinite, 0.0, violations);
+  } else if (!isHomogeneousTransformation(pose)) {
+    addViolation(sample, 0, TrajectoryViolationType::kInvalidTransformation, 0.0, violations);
+  } else {
+    History<16> poses = positionHistory(sample, [&](size_t i) { return trajectory[i].O_T_EE; });
+    bool valid_history = allFinite(poses) &&
+                         std::all_of(poses.begin(), poses.end(), [](const auto& previous_pose) {
+                           return isHomogeneousTransformation(previous_pose);
+                         });
+    if (valid_history) {
+      History<6> twists{};
+      for (size_t back = 0; back < 3; back++) {
+        twists[back] = twist(poses[back], poses[back + 1]);
+      }
+      if (checkFiniteTwist(sample, twists[0], violations) && allFinite(twists)) {
+        VelocityDerivatives<6> derivatives(twists);
+        std::array<double, 16> limited =
+            limitRate(kMaxTranslationalVelocity, kMaxTranslationalAcceleration,
+                      kMaxTranslationalJerk, kMaxRotationalVelocity, kMaxRotationalAcceleration,
+                      kMaxRotationalJerk, pose, poses[1], twists[1], derivatives.last_acceleration);
+
+        double translation_deviation = 0.0;
+        double rotation_deviation = 0.0;
+        for (size_t column = 0; column < 4; column++) {
+          for (size_t row = 0; row < 3; row++) {
+            double deviation = std::abs(limited[column * 4 + row] - pose[column * 4 + row]);
+            double& component_deviation = column == 3 ? translation_deviation : rotation_deviation;
+            component_deviation = std::max(component_deviation, deviation);
+          }
+        }
+        checkTwist(sample, twists, derivatives,
+                   {kMaxTranslationalVelocity, kMaxTranslationalAcceleration,
+                    kMaxTranslationalJerk},
+                   {kFactorCartesianRotationPoseInterface * kMaxRotationalVelocity,
+                    kFactorCartesianRotationPoseInterface * kMaxRotationalAcceleration,
+                    kFactorCartesianRotationPoseInterface * kMaxRotationalJerk},
+                   translation_deviation, rotation_deviation, tolerance, violations);
+      }
+    }
+  }
+  checkElbow(trajectory, sample, tolerance, violations);
+}
+
+template <>
+void checkSample<CartesianVelocities>(const Trajectory<CartesianVelocities>& trajectory,
+                                      size_t sample,
+                                      double tolerance,
+                                      Violations* violations) {
+  History<6> twists = velocityHistory(sample, [&](size_t i) { return trajectory[i].O_dP_EE; });
+  if (!allFinite(twists[0])) {
+    addViolation(sample, 0, TrajectoryViolationType::kNotFinite, 0.0, violations);
+  } else if (allFinite(twists)) {
+    VelocityDerivatives<6> derivatives(twists);
+    std::array<double, 6> limited =
+        limitRate(kMaxTranslationalVelocity, kMaxTranslationalAcceleration, kMaxTranslationalJerk,
+                  kMaxRotationalVelocity, kMaxRotationalAcceleration, kMaxRotationalJerk,
+                  twists[0], twists[1], derivatives.last_acceleration);
+
+    std::array<double, 2> deviations{};
+    for (size_t i = 0; i < 6; i++) {
+      deviations[i / 3] = std::max(deviations[i / 3], std::abs(limited[i] - twists[0][i]));
+    }
+    checkTwist(sample, twists, derivatives,
+               {kMaxTranslationalVelocity, kMaxTranslationalAcceleration, kMaxTranslationalJerk},
+               {kMaxRotationalVelocity, kMaxRotationalAcceleration, kMaxRotationalJerk},
+               deviations[0], deviations[1], tolerance, violations);
+  }
+  checkElbow(trajectory, sample, tolerance, violations);
+}
+
+template <typename T>
+auto validate(const std::vector<const Trajectory<T>*>& trajectories,
+              const TrajectoryValidationOptions& options)
+    -> std::vector<TrajectoryValidationReport> {
+  // Samples only depend on the three samples before them, so chunks can be checked independently.
+  struct Chunk {
+    size_t trajectory;
+    size_t begin;
+    size_t end;
+    Violations violations;
+  };
+  size_t chunk_size = std::max<size_t>(options.chunk_size, 1);
+  std::vector<Chunk> chunks;
+  for (size_t i = 0; i < trajectories.size(); i++) {
+    for (size_t begin = 0; begin < trajectories[i]->size(); begin += chunk_size) {
+      chunks.push_back({i, begin, std::min(begin + chunk_size, trajectories[i]->size()), {}});
+    }
+  }
+
+  std::atomic<size_t> next_chunk{0};
+  auto work = [&] {
+    for (size_t i = next_chunk++; i < chunks.size(); i = next_chunk++) {
+      Chunk& chunk = chunks[i];
+      for (size_t sample = chunk.begin; sample < chunk.end; sample++) {
+        checkSample(*trajectories[chunk.trajectory], sample, options.tolerance,
+                    &chunk.violations);
+      }
+    }
+  };
+
+  size_t threads = options.threads != 0
+                       ? options.threads
+                       : std::max<size_t>(std::thread::hardware_concurrency(), 1);
+  std::vector<std::thread> workers;
+  for (size_t i = 1; i < std::min(threads, chunks.size()); i++) {
+    workers.emplace_back(work);
+  }
+  work();
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+
+  std::vector<TrajectoryValidationReport> reports(trajectories.size());
+  for (size_t i = 0; i < trajectories.size(); i++) {
+    reports[i].samples = trajectories[i]->size();
+  }
+  for (Chunk& chunk : chunks) {
+    Violations& violations = reports[chunk.trajectory].violations;
+    violations.insert(violations.end(), chunk.violations.begin(), chunk.violations.end());
+  }
+  return reports;
+}
+
+}  // anonymous namespace
+
+template <typename T>
+auto validateTrajectory(const Trajectory<T>& trajectory,
+                        const TrajectoryValidationOptions& options)
+    -> TrajectoryValidationReport {
+  return std::move(validate<T>({&trajectory}, options).front());
+}
+
+template <typename T>
+auto validateTrajectories(const std::vector<Trajectory<T>>& trajectories,
+                          const TrajectoryValidationOptions& options)
+    -> std::vector<TrajectoryValidationReport> {
+  std::vector<const Trajectory<T>*> pointers;
+  pointers.reserve(trajectories.size());
+  for (const Trajectory<T>& trajectory : trajectories) {
+    pointers.push_back(&trajectory);
+  }
+  return validate(pointers, options);
+}
+
+template auto validateTrajectory(const Trajectory<JointPositions>&,
+                                 const TrajectoryValidationOptions&) -> TrajectoryValidationReport;
+template auto validateTrajectory(const Trajectory<JointVelocities>&,
+                                 const TrajectoryValidationOptions&) -> TrajectoryValidationReport;
+template auto validateTrajectory(const Trajectory<CartesianPose>&,
+                                 const TrajectoryValidationOptions&) -> TrajectoryValidationReport;
+template auto validateTrajectory(const Trajectory<CartesianVelocities>&,
+                                 const TrajectoryValidationOptions&) -> TrajectoryValidationReport;
+
+template auto validateTrajectories(const std::vector<Trajectory<JointPositions>>&,
+                                   const TrajectoryValidationOptions&)
+    -> std::vector<TrajectoryValidationReport>;
+template auto validateTrajectories(const std::vector<Trajectory<JointVelocities>>&,
+                                   const TrajectoryValidationOptions&)
+    -> std::vector<TrajectoryValidationReport>;
+template auto validateTrajectories(const std::vector<Trajectory<CartesianPose>>&,
+                                   const TrajectoryValidationOptions&)
+    -> std::vector<TrajectoryValidationReport>;
+template auto validateTrajectories(const std::vector<Trajectory<CartesianVelocities>>&,
+                                   const TrajectoryValidationOptions&)
+    -> std::vector<TrajectoryValidationReport>;
+
+}  // namespace franka
@@ -0,0 +1,106 @@
+// Copyright (c) 2017 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace franka {
+
+/**
+ * Moves bytes between libfranka and the robot, gripper or vacuum gripper.
+ *
+ * A transport provides two connections: a reliable byte stream for commands and their responses
+ * (TCP for the real hardware) and an unreliable datagram connection for states and real-time
+ * commands (UDP for the real hardware). Network builds the protocol on top of it.
+ *
+ * The command stream is written by any thread holding the Network's TCP lock and read only by the
+ * TCP reader thread. Datagrams are only sent or received while holding the Network's UDP lock.
+ */
+class Transport {
+ public:
+  virtual ~Transport() = default;
+
+  /**
+   * Maximum number of datagrams received by a single call to udpReceiveBatch.
+   */
+  static constexpr size_t kMaxReceiveBatchSize = 32;
+
+  /**
+   * @return Port the server has to send datagrams to, as announced in the Connect request.
+   */
+  [[nodiscard]] virtual auto udpPort() const noexcept -> uint16_t = 0;
+
+  /**
+   * Blocks until a datagram has been received.
+   *
+   * @param[out] data Storage for the datagram.
+   * @param[in] size Size of data in bytes.
+   * @param[out] receive_time If given, host time at which the datagram has been received.
+   *
+   * @return Size of the received datagram.
+   *
+   * @throw NetworkException if no datagram arrived within the receive timeout.
+   * @throw ProtocolException if the datagram does not fit into data.
+   */
+  virtual auto udpReceive(void* data,
+                          size_t size,
+                          std::chrono::system_clock::time_point* receive_time) -> size_t = 0;
+
+  /**
+   * Receives datagrams which are already queued without blocking.
+   *
+   * @param[out] buffer Storage for max_count datagrams of datagram_size bytes each.
+   * @param[in] datagram_size Expected size of each datagram.
+   * @param[in] max_count Maximum number of datagrams to receive, at most #kMaxReceiveBatchSize.
+   * @param[out] receive_times Storage for the host receive time of each datagram.
+   *
+   * @return Number of received datagrams.
+   *
+   * @throw ProtocolException if a datagram does not have the expected size.
+   */
+  virtual auto udpReceiveBatch(uint8_t* buffer,
+                               size_t datagram_size,
+                               size_t max_count,
+                               std::chrono::system_clock::time_point* receive_times) -> size_t = 0;
+
+  /**
+   * Sends a datagram to the server.
+   *
+   * @throw NetworkException if the datagram could not be sent.
+   */
+  virtual void udpSend(const void* data, size_t size) = 0;
+
+  /**
+   * Writes all given bytes to the command stream.
+   *
+   * @throw NetworkException if the bytes could not be sent.
+   */
+  virtual void tcpSend(const void* data, size_t size) = 0;
+
+  /**
+   * Waits until bytes can be read from the command stream.
+   *
+   * @param[in] timeout Maximum time to wait.
+   *
+   * @return True if tcpReceive will not block, false after the timeout.
+   */
+  virtual auto tcpPoll(std::chrono::microseconds timeout) -> bool = 0;
+
+  /**
+   * Reads at least one and at most size bytes from the command stream.
+   *
+   * @return Number of bytes read.
+   *
+   * @throw NetworkException if the server closed the connection or reading failed.
+   */
+  virtual auto tcpReceive(void* data, size_t size) -> size_t = 0;
+
+  /**
+   * Closes the command stream, which makes pending and subsequent reads fail.
+   */
+  virtual void tcpShutdown() noexcept = 0;
+};
+
+}  // namespace franka
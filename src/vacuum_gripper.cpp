@@ -3,6 +3,8 @@
 #include <franka/exception.h>
 #include <franka/vacuum_gripper.h>
 #include <research_interface/vacuum_gripper/types.h>
+#include <future>
+#include <memory>
 #include <sstream>
 #include "network.h"
 
@@ -10,11 +12,8 @@ namespace franka {
 
 namespace {
 
-template <typename T, typename... TArgs>
-auto executeCommand(Network& network, TArgs&&... args) -> bool {
-  uint32_t command_id = network.tcpSendRequest<T>(std::forward<TArgs>(args)...);
-  typename T::Response response = network.tcpBlockingReceiveResponse<T>(command_id);
-
+template <typename T>
+auto handleCommandResponse(const typename T::Response& response) -> bool {
   switch (response.status) {
     case T::Status::kSuccess:
       return true;
@@ -30,6 +29,27 @@ auto executeCommand(Network& network, TArgs&&... args) -> bool {
   }
 }
 
+template <typename T, typename... TArgs>
+auto executeCommand(Network& network, TArgs&&... args) -> bool {
+  uint32_t command_id = network.tcpSendRequest<T>(std::forward<TArgs>(args)...);
+  return handleCommandResponse<T>(network.tcpBlockingReceiveResponse<T>(command_id));
+}
+
+template <typename T, typename... TArgs>
+auto executeCommandAsync(Network& network, TArgs&&... args) -> std::future<bool> {
+  auto promise = std::make_shared<std::promise<bool>>();
+  std::future<bool> future = promise->get_future();
+
+  uint32_t command_id = network.tcpSendRequest<T>(std::forward<TArgs>(args)...);
+  network.tcpReceiveResponseAsync<T>(
+      command_id,
+      [promise](const typename T::Response& response) {
+        promise->set_value(handleCommandResponse<T>(response));
+      },
+      [promise](std::exception_ptr exception) { promise->set_exception(exception); });
+  return future;
+}
+
 auto convertVacuumGripperState(
     const research_interface::vacuum_gripper::VacuumGripperState& vacuum_gripper_state) noexcept -> VacuumGripperState {
   VacuumGripperState converted{};
@@ -56,11 +76,29 @@ auto convertVacuumGripperState(
   return converted;
 }
 
+auto convertProfile(VacuumGripper::ProductionSetupProfile profile)
+    -> research_interface::vacuum_gripper::Profile {
+  switch (profile) {
+    case VacuumGripper::ProductionSetupProfile::kP0:
+      return research_interface::vacuum_gripper::Profile::kP0;
+    case VacuumGripper::ProductionSetupProfile::kP1:
+      return research_interface::vacuum_gripper::Profile::kP1;
+    case VacuumGripper::ProductionSetupProfile::kP2:
+      return research_interface::vacuum_gripper::Profile::kP2;
+    case VacuumGripper::ProductionSetupProfile::kP3:
+      return research_interface::vacuum_gripper::Profile::kP3;
+    default:
+      throw CommandException("Vacuum Gripper: Vacuum profile not defined!");
+  }
+}
+
 }  // anonymous namespace
 
-VacuumGripper::VacuumGripper(const std::string& franka_address)
+VacuumGripper::VacuumGripper(const std::string& franka_address,
+                             const NetworkConfig& network_config)
     : network_{std::make_unique<Network>(franka_address,
-                                         research_interface::vacuum_gripper::kCommandPort)} {
+                                         research_interface::vacuum_gripper::kCommandPort,
+                                         network_config)} {
   connect<research_interface::vacuum_gripper::Connect,
           research_interface::vacuum_gripper::kVersion>(*network_, &ri_version_);
 }
@@ -76,43 +114,39 @@ auto VacuumGripper::serverVersion() const noexcept -> VacuumGripper::ServerVersi
 auto VacuumGripper::vacuum(uint8_t vacuum,
                            std::chrono::milliseconds timeout,
                            ProductionSetupProfile profile) const -> bool {
-  research_interface::vacuum_gripper::Profile converted_profile;
-  switch (profile) {
-    case ProductionSetupProfile::kP0:
-      converted_profile = research_interface::vacuum_gripper::Profile::kP0;
-      break;
-    case ProductionSetupProfile::kP1:
-      converted_profile = research_interface::vacuum_gripper::Profile::kP1;
-      break;
-    case ProductionSetupProfile::kP2:
-      converted_profile = research_interface::vacuum_gripper::Profile::kP2;
-      break;
-    case ProductionSetupProfile::kP3:
-      converted_profile = research_interface::vacuum_gripper::Profile::kP3;
-      break;
-    default:
-      throw CommandException("Vacuum Gripper: Vacuum profile not defined!");
-      break;
-  }
-  return executeCommand<research_interface::vacuum_gripper::Vacuum>(*network_, vacuum,
-                                                                    converted_profile, timeout);
+  return executeCommand<research_interface::vacuum_gripper::Vacuum>(
+      *network_, vacuum, convertProfile(profile), timeout);
+}
+
+auto VacuumGripper::vacuumAsync(uint8_t vacuum,
+                                std::chrono::milliseconds timeout,
+                                ProductionSetupProfile profile) const -> std::future<bool> {
+  return executeCommandAsync<research_interface::vacuum_gripper::Vacuum>(
+      *network_, vacuum, convertProfile(profile), timeout);
 }
 
 auto VacuumGripper::dropOff(std::chrono::milliseconds timeout) const -> bool {
   return executeCommand<research_interface::vacuum_gripper::DropOff>(*network_, timeout);
 }
 
+auto VacuumGripper::dropOffAsync(std::chrono::milliseconds timeout) const -> std::future<bool> {
+  return executeCommandAsync<research_interface::vacuum_gripper::DropOff>(*network_, timeout);
+}
+
 auto VacuumGripper::stop() const -> bool {
   return executeCommand<research_interface::vacuum_gripper::Stop>(*network_);
 }
 
+auto VacuumGripper::stopAsync() const -> std::future<bool> {
+  return executeCommandAsync<research_interface::vacuum_gripper::Stop>(*network_);
+}
+
 auto VacuumGripper::readOnce() const -> VacuumGripperState {
   research_interface::vacuum_gripper::VacuumGripperState vacuum_gripper_state{};
   // Delete old data from the UDP buffer.
-  while (network_->udpReceive<decltype(vacuum_gripper_state)>(&vacuum_gripper_state)) {
-  }
+  network_->udpReceiveLatest(&vacuum_gripper_state);
 
-  vacuum_gripper_state = network_->udpBlockingReceive<decltype(vacuum_gripper_state)>();
+  network_->udpBlockingReceive(&vacuum_gripper_state);
   return convertVacuumGripperState(vacuum_gripper_state);
 }
 
@@ -0,0 +1,117 @@
+// Copyright (c) 2017 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <array>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+#include <Eigen/Geometry>
+
+#include <franka/lowpass_filter.h>
+#include <franka/rate_limiting.h>
+#include <franka/robot_state.h>
+
+#include "cartesian_pose_conditioner.h"
+
+using franka::CartesianPoseConditioner;
+using franka::RobotState;
+
+namespace {
+
+auto toArray(const Eigen::Affine3d& transform) -> std::array<double, 16> {
+  std::array<double, 16> pose{};
+  Eigen::Map<Eigen::Matrix4d>(pose.data()) = transform.matrix();
+  return pose;
+}
+
+// Pose which rotates around a tilted axis and moves along a circle, with a step at sample 100.
+auto commandedPose(size_t sample) -> std::array<double, 16> {
+  double t = static_cast<double>(sample) * franka::kDeltaT;
+  double step = sample >= 100 ? 0.05 : 0.0;
+  Eigen::Affine3d transform(Eigen::AngleAxisd(M_PI / 2 + std::sin(t) + 4 * step,
+                                              Eigen::Vector3d(1.0, 2.0, 3.0).normalized()));
+  transform.translation() << 0.3 + 0.1 * std::cos(t) + step, 0.1 * std::sin(t), 0.5;
+  return toArray(transform);
+}
+
+// Updates the last commanded pose and its derivatives in the robot state as the robot does.
+void commandPose(const std::array<double, 16>& pose, RobotState* robot_state) {
+  Eigen::Affine3d transform(Eigen::Matrix4d::Map(pose.data()));
+  Eigen::Affine3d last_transform(Eigen::Matrix4d::Map(robot_state->O_T_EE_c.data()));
+  Eigen::AngleAxisd rotation(transform.linear() * last_transform.linear().transpose());
+  Eigen::Matrix<double, 6, 1> twist;
+  twist.head(3) << (transform.translation() - last_transform.translation()) / franka::kDeltaT;
+  twist.tail(3) << rotation.axis() * rotation.angle() / franka::kDeltaT;
+  for (size_t i = 0; i < 6; i++) {
+    robot_state->O_ddP_EE_c[i] = (twist(i) - robot_state->O_dP_EE_c[i]) / franka::kDeltaT;
+    robot_state->O_dP_EE_c[i] = twist(i);
+  }
+  robot_state->O_T_EE_c = pose;
+}
+
+auto limitPose(const std::array<double, 16>& pose, const RobotState& robot_state)
+    -> std::array<double, 16> {
+  return franka::limitRate(franka::kMaxTranslationalVelocity, franka::kMaxTranslationalAcceleration,
+                           franka::kMaxTranslationalJerk, franka::kMaxRotationalVelocity,
+                           franka::kMaxRotationalAcceleration, franka::kMaxRotationalJerk, pose,
+                           robot_state.O_T_EE_c, robot_state.O_dP_EE_c, robot_state.O_ddP_EE_c);
+}
+
+}  // anonymous namespace
+
+TEST(CartesianPoseConditioner, MatchesFilterFollowedByLimitRate) {
+  double gain = franka::lowpassFilterGain(franka::kDeltaT, 10.0);
+  for (bool filter : {false, true}) {
+    CartesianPoseConditioner conditioner;
+    RobotState robot_state;
+    robot_state.O_T_EE_c = commandedPose(0);
+
+    for (size_t sample = 1; sample < 400; sample++) {
+      std::array<double, 16> commanded = commandedPose(sample);
+      std::array<double, 16> expected = limitPose(
+          filter ? franka::cartesianLowpassFilter(gain, commanded, robot_state.O_T_EE_c)
+                 : commanded,
+          robot_state);
+      std::array<double, 16> actual = conditioner.condition(filter, gain, commanded, robot_state);
+      for (size_t i = 0; i < actual.size(); i++) {
+        ASSERT_NEAR(expected[i], actual[i], 1e-12) << "sample " << sample << ", element " << i;
+      }
+      commandPose(actual, &robot_state);
+    }
+  }
+}
+
+TEST(CartesianPoseConditioner, FollowsExternallyChangedLastPose) {
+  CartesianPoseConditioner conditioner;
+  RobotState robot_state;
+  robot_state.O_T_EE_c = commandedPose(0);
+  conditioner.condition(false, 1.0, commandedPose(1), robot_state);
+
+  // The robot reports a different last pose than the conditioned one, e.g. after a lost packet.
+  robot_state.O_T_EE_c = commandedPose(50);
+  std::array<double, 16> expected = limitPose(commandedPose(51), robot_state);
+  std::array<double, 16> actual = conditioner.condition(false, 1.0, commandedPose(51), robot_state);
+  for (size_t i = 0; i < actual.size(); i++) {
+    EXPECT_NEAR(expected[i], actual[i], 1e-12);
+  }
+}
+
+TEST(CartesianPoseConditioner, ThrowsOnInvalidPoses) {
+  CartesianPoseConditioner conditioner;
+  RobotState robot_state;
+  robot_state.O_T_EE_c = commandedPose(0);
+
+  std::array<double, 16> not_finite = commandedPose(1);
+  not_finite[12] = std::numeric_limits<double>::quiet_NaN();
+  EXPECT_THROW(conditioner.condition(true, 0.5, not_finite, robot_state), std::invalid_argument);
+
+  std::array<double, 16> invalid_last_row = commandedPose(1);
+  invalid_last_row[3] = 0.1;
+  EXPECT_THROW(conditioner.condition(true, 0.5, invalid_last_row, robot_state),
+               std::invalid_argument);
+
+  std::array<double, 16> scaled = commandedPose(1);
+  scaled[0] *= 2.0;
+  EXPECT_THROW(conditioner.condition(false, 1.0, scaled, robot_state), std::invalid_argument);
+}
@@ -1,12 +1,18 @@
 // Copyright (c) 2017 Franka Emika GmbH
 // Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <array>
+#include <chrono>
+#include <cmath>
 #include <exception>
 #include <functional>
+#include <memory>
+#include <thread>
 
 #include <gmock/gmock.h>
 
 #include <franka/lowpass_filter.h>
 #include "control_loop.h"
+#include "control_loop_timing.h"
 #include "motion_generator_traits.h"
 
 #include "helpers.h"
@@ -42,6 +48,9 @@ class ControlLoop : public franka::ControlLoop<T> {
   using franka::ControlLoop<T>::ControlLoop;
   using franka::ControlLoop<T>::spinMotion;
   using franka::ControlLoop<T>::spinControl;
+
+  static constexpr research_interface::robot::Move::Deviation kDefaultDeviation =
+      franka::kDefaultDeviation;
 };
 
 template <typename T>
@@ -1304,4 +1313,341 @@ TYPED_TEST(ControlLoopWithElbow, SpinOnceWithInvalidElbowCallback) {
     EXPECT_THROW(loop.spinMotion(robot_state, duration, &command.motion), std::invalid_argument);
     EXPECT_TRUE(loop.spinControl(robot_state, duration, &command.control));
   }
-}
\ No newline at end of file
+}
+
+TEST(ControlLoop, CanRunMoveOnlyCallables) {
+  NiceMock<MockRobotControl> robot;
+  EXPECT_CALL(robot, startMotion(Move::ControllerMode::kExternalController,
+                                 Move::MotionGeneratorMode::kJointPosition,
+                                 franka::kDefaultDeviation, franka::kDefaultDeviation))
+      .WillOnce(Return(200));
+  RobotState robot_state = generateValidRobotState();
+  EXPECT_CALL(robot, update(_, _)).WillRepeatedly(Return(robot_state));
+
+  // Cannot be stored in a std::function, as they are not copyable.
+  auto calls = std::make_unique<int>(0);
+  int* control_calls = calls.get();
+  auto control_callback = [calls = std::move(calls)](const RobotState&,
+                                                     Duration) mutable -> Torques {
+    ++*calls;
+    return Torques({0, 0, 0, 0, 0, 0, 0});
+  };
+  auto motion_callback = [count = std::make_unique<int>(0),
+                          q = robot_state.q_d](const RobotState&, Duration) -> JointPositions {
+    if (++*count < 3) {
+      return JointPositions(q);
+    }
+    return MotionFinished(JointPositions(q));
+  };
+
+  const research_interface::robot::ControllerCommand* finished_control_command = nullptr;
+  EXPECT_CALL(robot, finishMotion(200, NotNull(), NotNull()))
+      .WillOnce(SaveArg<2>(&finished_control_command));
+
+  franka::ControlLoop<JointPositions, decltype(motion_callback), decltype(control_callback)> loop(
+      robot, std::move(control_callback), std::move(motion_callback), false,
+      franka::kMaxCutoffFrequency);
+  loop();
+
+  EXPECT_NE(nullptr, finished_control_command);
+  EXPECT_EQ(2, *control_calls);
+}
+
+template <typename TRateLimiting, typename TFiltering>
+class PolicyControlLoop
+    : public franka::ControlLoop<JointPositions,
+                                 std::function<JointPositions(const RobotState&, Duration)>,
+                                 std::function<Torques(const RobotState&, Duration)>,
+                                 TRateLimiting,
+                                 TFiltering> {
+ public:
+  using franka::ControlLoop<JointPositions,
+                            std::function<JointPositions(const RobotState&, Duration)>,
+                            std::function<Torques(const RobotState&, Duration)>,
+                            TRateLimiting,
+                            TFiltering>::ControlLoop;
+  using franka::ControlLoop<JointPositions,
+                            std::function<JointPositions(const RobotState&, Duration)>,
+                            std::function<Torques(const RobotState&, Duration)>,
+                            TRateLimiting,
+                            TFiltering>::spinMotion;
+  using franka::ControlLoop<JointPositions,
+                            std::function<JointPositions(const RobotState&, Duration)>,
+                            std::function<Torques(const RobotState&, Duration)>,
+                            TRateLimiting,
+                            TFiltering>::spinControl;
+};
+
+template <typename TRateLimiting, typename TFiltering>
+void spinOnce(TRateLimiting rate_limiting,
+              TFiltering filtering,
+              const RobotState& robot_state,
+              const JointPositions& motion,
+              const Torques& torques,
+              RobotCommand* command) {
+  NiceMock<MockRobotControl> robot;
+  PolicyControlLoop<TRateLimiting, TFiltering> loop(
+      robot, [&](const RobotState&, Duration) { return torques; },
+      [&](const RobotState&, Duration) { return motion; }, rate_limiting, filtering);
+  EXPECT_TRUE(loop.spinMotion(robot_state, Duration(1), &command->motion));
+  EXPECT_TRUE(loop.spinControl(robot_state, Duration(1), &command->control));
+}
+
+TEST(ControlLoop, CopiesCommandsWithoutFilteringAndRateLimiting) {
+  RobotState robot_state = generateValidRobotState();
+  JointPositions motion(robot_state.q_d);
+  motion.q[0] += 0.1;
+  Torques torques({0, 1, 2, 3, 4, 5, 6});
+
+  RobotCommand command;
+  spinOnce(franka::NoRateLimiting(), franka::NoFiltering(), robot_state, motion, torques,
+           &command);
+
+  EXPECT_EQ(motion.q, command.motion.q_c);
+  EXPECT_EQ(torques.tau_J, command.control.tau_J_d);
+}
+
+TEST(ControlLoop, FiltersWithPrecomputedGain) {
+  RobotState robot_state = generateValidRobotState();
+  JointPositions motion(robot_state.q_d);
+  motion.q[0] += 0.1;
+  Torques torques({0, 1, 2, 3, 4, 5, 6});
+
+  RobotCommand command;
+  spinOnce(franka::NoRateLimiting(), franka::LowpassFiltering(franka::kDefaultCutoffFrequency),
+           robot_state, motion, torques, &command);
+
+  for (size_t i = 0; i < 7; i++) {
+    EXPECT_DOUBLE_EQ(franka::lowpassFilter(franka::kDeltaT, motion.q[i], robot_state.q_d[i],
+                                           franka::kDefaultCutoffFrequency),
+                     command.motion.q_c[i]);
+    EXPECT_DOUBLE_EQ(franka::lowpassFilter(franka::kDeltaT, torques.tau_J[i],
+                                           robot_state.tau_J_d[i], franka::kDefaultCutoffFrequency),
+                     command.control.tau_J_d[i]);
+  }
+}
+
+TEST(ControlLoop, PoliciesMatchRuntimeConfiguration) {
+  RobotState robot_state = generateValidRobotState();
+  JointPositions motion(robot_state.q_d);
+  motion.q[0] += 0.1;
+  Torques torques({0, 1, 2, 3, 4, 5, 6});
+
+  RobotCommand configured;
+  spinOnce(franka::ConfigurableRateLimiting(true),
+           franka::ConfigurableFiltering(franka::kDefaultCutoffFrequency), robot_state, motion,
+           torques, &configured);
+  RobotCommand fixed;
+  spinOnce(franka::RateLimiting(), franka::LowpassFiltering(franka::kDefaultCutoffFrequency),
+           robot_state, motion, torques, &fixed);
+  EXPECT_EQ(configured.motion.q_c, fixed.motion.q_c);
+  EXPECT_EQ(configured.control.tau_J_d, fixed.control.tau_J_d);
+
+  spinOnce(franka::ConfigurableRateLimiting(false),
+           franka::ConfigurableFiltering(franka::kMaxCutoffFrequency), robot_state, motion,
+           torques, &configured);
+  spinOnce(franka::NoRateLimiting(), franka::NoFiltering(), robot_state, motion, torques, &fixed);
+  EXPECT_EQ(configured.motion.q_c, fixed.motion.q_c);
+  EXPECT_EQ(configured.control.tau_J_d, fixed.control.tau_J_d);
+}
+
+TEST(ControlLoop, ThrowsOnInvalidCutoffFrequency) {
+  EXPECT_THROW(franka::LowpassFiltering(0.0), std::invalid_argument);
+  EXPECT_THROW(franka::ConfigurableFiltering(-1.0), std::invalid_argument);
+  EXPECT_NO_THROW(franka::ConfigurableFiltering(franka::kMaxCutoffFrequency));
+}
+
+class TimedRobotControl : public MockRobotControl {
+ public:
+  franka::ControlLoopTimingRecorder* controlLoopTimingRecorder() noexcept override {
+    return &recorder;
+  }
+
+  franka::ControlLoopTimingRecorder recorder;
+};
+
+TEST(ControlLoop, RecordsTimingOfEachPhase) {
+  NiceMock<TimedRobotControl> robot;
+  RobotState robot_state = generateValidRobotState();
+  EXPECT_CALL(robot, update(_, _)).WillRepeatedly(Return(robot_state));
+
+  int motion_calls = 0;
+  franka::ControlLoop<JointPositions> loop(
+      robot, [](const RobotState&, Duration) { return Torques({0, 0, 0, 0, 0, 0, 0}); },
+      [&](const RobotState&, Duration) {
+        if (++motion_calls < 3) {
+          return JointPositions(robot_state.q_d);
+        }
+        return MotionFinished(JointPositions(robot_state.q_d));
+      },
+      false, franka::kMaxCutoffFrequency);
+  loop();
+
+  franka::ControlLoopTiming timing = robot.recorder.snapshot();
+  EXPECT_EQ(3u, timing.update.count);
+  EXPECT_EQ(3u, timing.error_check.count);
+  EXPECT_EQ(3u, timing.motion_callback.count);
+  EXPECT_EQ(3u, timing.motion_conversion.count);
+  EXPECT_EQ(2u, timing.control_callback.count);
+  EXPECT_EQ(2u, timing.control_conversion.count);
+  EXPECT_LE(timing.update.max, timing.update.total);
+}
+
+class WatchedRobotControl : public MockRobotControl {
+ public:
+  franka::ControlLoopWatchdog controlLoopWatchdog() const noexcept override { return watchdog; }
+  void recordDeadlineMiss() noexcept override { misses++; }
+
+  franka::ControlLoopWatchdog watchdog;
+  int misses = 0;
+};
+
+template <typename T>
+auto slowCallback(T result) {
+  return [result](const RobotState&, Duration) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    return result;
+  };
+}
+
+TEST(ControlLoop, KeepsResultsOfCallbacksWithinBudget) {
+  NiceMock<WatchedRobotControl> robot;
+  robot.watchdog.budget = std::chrono::seconds(10);
+  RobotState robot_state = generateValidRobotState();
+  JointPositions motion(robot_state.q_d);
+  motion.q[0] += 0.1;
+  Torques torques({0, 1, 2, 3, 4, 5, 6});
+
+  ControlLoop<JointPositions> loop(
+      robot, [&](const RobotState&, Duration) { return torques; },
+      [&](const RobotState&, Duration) { return motion; }, false, franka::kMaxCutoffFrequency);
+  RobotCommand command{};
+  EXPECT_TRUE(loop.spinMotion(robot_state, Duration(1), &command.motion));
+  EXPECT_TRUE(loop.spinControl(robot_state, Duration(1), &command.control));
+
+  EXPECT_EQ(motion.q, command.motion.q_c);
+  EXPECT_EQ(torques.tau_J, command.control.tau_J_d);
+  EXPECT_EQ(0, robot.misses);
+}
+
+TEST(ControlLoop, HoldsPositionAndZeroesTorquesIfCallbacksOverrun) {
+  NiceMock<WatchedRobotControl> robot;
+  robot.watchdog.budget = std::chrono::microseconds(1);
+  RobotState robot_state = generateValidRobotState();
+  JointPositions motion(robot_state.q_d);
+  motion.q[0] += 0.1;
+
+  ControlLoop<JointPositions> loop(robot, slowCallback(Torques({0, 1, 2, 3, 4, 5, 6})),
+                                   slowCallback(motion), false, franka::kMaxCutoffFrequency);
+  RobotCommand command{};
+  EXPECT_TRUE(loop.spinMotion(robot_state, Duration(1), &command.motion));
+  EXPECT_TRUE(loop.spinControl(robot_state, Duration(1), &command.control));
+
+  EXPECT_EQ(robot_state.q_d, command.motion.q_c);
+  EXPECT_EQ((std::array<double, 7>{}), command.control.tau_J_d);
+  EXPECT_EQ(2, robot.misses);
+}
+
+TEST(ControlLoop, ExtrapolatesVelocityAndHoldsTorquesIfCallbacksOverrun) {
+  NiceMock<WatchedRobotControl> robot;
+  robot.watchdog.budget = std::chrono::microseconds(1);
+  robot.watchdog.motion_fallback = franka::MotionFallback::kExtrapolateVelocity;
+  robot.watchdog.torque_fallback = franka::TorqueFallback::kHoldTorque;
+  RobotState robot_state = generateValidRobotState();
+
+  ControlLoop<JointPositions> loop(robot, slowCallback(Torques({0, 1, 2, 3, 4, 5, 6})),
+                                   slowCallback(JointPositions(robot_state.q_d)), false,
+                                   franka::kMaxCutoffFrequency);
+  RobotCommand command{};
+  EXPECT_TRUE(loop.spinMotion(robot_state, Duration(1), &command.motion));
+  EXPECT_TRUE(loop.spinControl(robot_state, Duration(1), &command.control));
+
+  for (size_t i = 0; i < 7; i++) {
+    EXPECT_DOUBLE_EQ(robot_state.q_d[i] + robot_state.dq_d[i] * franka::kDeltaT,
+                     command.motion.q_c[i]);
+  }
+  EXPECT_EQ(robot_state.tau_J_d, command.control.tau_J_d);
+}
+
+TEST(ControlLoop, FallsBackForCartesianVelocities) {
+  NiceMock<WatchedRobotControl> robot;
+  robot.watchdog.budget = std::chrono::microseconds(1);
+  RobotState robot_state = generateValidRobotState();
+
+  ControlLoop<CartesianVelocities> loop(
+      robot, slowCallback(Torques({0, 1, 2, 3, 4, 5, 6})),
+      slowCallback(CartesianVelocities({0.1, 0.1, 0.1, 0.1, 0.1, 0.1})), false,
+      franka::kMaxCutoffFrequency);
+  RobotCommand command{};
+  EXPECT_TRUE(loop.spinMotion(robot_state, Duration(1), &command.motion));
+  EXPECT_EQ((std::array<double, 6>{}), command.motion.O_dP_EE_c);
+}
+
+TEST(ControlLoop, ExtrapolatesCartesianPose) {
+  NiceMock<WatchedRobotControl> robot;
+  robot.watchdog.budget = std::chrono::microseconds(1);
+  robot.watchdog.motion_fallback = franka::MotionFallback::kExtrapolateVelocity;
+  RobotState robot_state = generateValidRobotState();
+  robot_state.O_T_EE_c = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0.5, 0, 0.5, 1};
+  robot_state.O_dP_EE_c = {0.1, 0, 0, 0, 0, 0};
+
+  ControlLoop<CartesianPose> loop(robot, slowCallback(Torques({0, 1, 2, 3, 4, 5, 6})),
+                                  slowCallback(CartesianPose(robot_state.O_T_EE_c)), false,
+                                  franka::kMaxCutoffFrequency);
+  RobotCommand command{};
+  EXPECT_TRUE(loop.spinMotion(robot_state, Duration(1), &command.motion));
+
+  std::array<double, 16> expected = robot_state.O_T_EE_c;
+  expected[12] += 0.1 * franka::kDeltaT;
+  for (size_t i = 0; i < 16; i++) {
+    EXPECT_NEAR(expected[i], command.motion.O_T_EE_c[i], 1e-12);
+  }
+}
+
+TEST(ControlLoop, RateLimitsFallbacksWithoutRateLimiting) {
+  NiceMock<WatchedRobotControl> robot;
+  robot.watchdog.budget = std::chrono::microseconds(1);
+  RobotState robot_state = generateValidRobotState();
+  robot_state.dq_d = {1, 1, 1, 1, 1, 1, 1};
+  robot_state.tau_J_d = {10, 10, 10, 10, 10, 10, 10};
+
+  PolicyControlLoop<franka::NoRateLimiting, franka::NoFiltering> loop(
+      robot, slowCallback(Torques({0, 1, 2, 3, 4, 5, 6})),
+      slowCallback(JointPositions(robot_state.q_d)), franka::NoRateLimiting(),
+      franka::NoFiltering());
+  RobotCommand command{};
+  EXPECT_TRUE(loop.spinMotion(robot_state, Duration(1), &command.motion));
+  EXPECT_TRUE(loop.spinControl(robot_state, Duration(1), &command.control));
+  EXPECT_EQ(2, robot.misses);
+
+  for (size_t i = 0; i < 7; i++) {
+    double velocity = (command.motion.q_c[i] - robot_state.q_d[i]) / franka::kDeltaT;
+    double acceleration = (velocity - robot_state.dq_d[i]) / franka::kDeltaT;
+    double jerk = (acceleration - robot_state.ddq_d[i]) / franka::kDeltaT;
+    EXPECT_GT(velocity, 0.0);
+    EXPECT_LT(velocity, robot_state.dq_d[i]);
+    EXPECT_LE(std::abs(acceleration), franka::kMaxJointAcceleration[i] + 1e-6);
+    EXPECT_LE(std::abs(jerk), franka::kMaxJointJerk[i] + 1e-3);
+
+    double torque_rate =
+        (command.control.tau_J_d[i] - robot_state.tau_J_d[i]) / franka::kDeltaT;
+    EXPECT_LT(command.control.tau_J_d[i], robot_state.tau_J_d[i]);
+    EXPECT_LE(std::abs(torque_rate), franka::kMaxTorqueRate[i] + 1e-6);
+  }
+}
+
+TEST(ControlLoop, DoesNotReplaceFinishingResults) {
+  NiceMock<WatchedRobotControl> robot;
+  robot.watchdog.budget = std::chrono::microseconds(1);
+  RobotState robot_state = generateValidRobotState();
+  JointPositions motion(robot_state.q_d);
+  motion.q[0] += 0.1;
+
+  ControlLoop<JointPositions> loop(robot, slowCallback(Torques({0, 1, 2, 3, 4, 5, 6})),
+                                   slowCallback(franka::MotionFinished(motion)), false,
+                                   franka::kMaxCutoffFrequency);
+  RobotCommand command{};
+  EXPECT_FALSE(loop.spinMotion(robot_state, Duration(1), &command.motion));
+  EXPECT_EQ(motion.q, command.motion.q_c);
+  EXPECT_EQ(1, robot.misses);
+}
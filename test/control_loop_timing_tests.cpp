@@ -0,0 +1,76 @@
+// Copyright (c) 2017 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <array>
+#include <chrono>
+#include <sstream>
+
+#include <gtest/gtest.h>
+
+#include "control_loop_timing.h"
+
+using namespace std::chrono_literals;
+
+using franka::ControlLoopPhase;
+using franka::ControlLoopTiming;
+using franka::ControlLoopTimingRecorder;
+using franka::PhaseTiming;
+
+TEST(ControlLoopTiming, IsEmptyInitially) {
+  ControlLoopTimingRecorder recorder;
+  ControlLoopTiming timing = recorder.snapshot();
+
+  EXPECT_EQ(0u, timing.update.count);
+  EXPECT_EQ(0ns, timing.update.total);
+  EXPECT_EQ(0ns, timing.update.max);
+  for (uint64_t count : timing.control_conversion.histogram) {
+    EXPECT_EQ(0u, count);
+  }
+}
+
+TEST(ControlLoopTiming, RecordsPhasesSeparately) {
+  ControlLoopTimingRecorder recorder;
+
+  recorder.record(ControlLoopPhase::kUpdate, 900us);
+  recorder.record(ControlLoopPhase::kUpdate, 950us);
+  recorder.record(ControlLoopPhase::kMotionCallback, 20us);
+  ControlLoopTiming timing = recorder.snapshot();
+
+  EXPECT_EQ(2u, timing.update.count);
+  EXPECT_EQ(1850us, timing.update.total);
+  EXPECT_EQ(950us, timing.update.max);
+  EXPECT_EQ(1u, timing.motion_callback.count);
+  EXPECT_EQ(0u, timing.error_check.count);
+  EXPECT_EQ(0u, timing.control_callback.count);
+}
+
+TEST(ControlLoopTiming, SortsDurationsIntoLogarithmicBuckets) {
+  ControlLoopTimingRecorder recorder;
+
+  std::array<std::chrono::nanoseconds, 8> durations{500ns, 1us, 1999ns, 2us, 3us, 4us, 1ms, 1h};
+  for (std::chrono::nanoseconds duration : durations) {
+    recorder.record(ControlLoopPhase::kControlCallback, duration);
+  }
+  recorder.record(ControlLoopPhase::kControlCallback, -1us);
+  PhaseTiming timing = recorder.snapshot().control_callback;
+
+  EXPECT_EQ(2u, timing.histogram[0]);
+  EXPECT_EQ(2u, timing.histogram[1]);
+  EXPECT_EQ(2u, timing.histogram[2]);
+  EXPECT_EQ(1u, timing.histogram[3]);
+  // 1000 µs lies in [512, 1024).
+  EXPECT_EQ(1u, timing.histogram[10]);
+  EXPECT_EQ(1u, timing.histogram[PhaseTiming::kBuckets - 1]);
+  EXPECT_EQ(9u, timing.count);
+}
+
+TEST(ControlLoopTiming, CanBeStreamedAsJson) {
+  ControlLoopTimingRecorder recorder;
+  recorder.record(ControlLoopPhase::kErrorCheck, 3us);
+
+  std::ostringstream stream;
+  stream << recorder.snapshot();
+
+  EXPECT_NE(std::string::npos,
+            stream.str().find("\"error_check\": {\"count\": 1, \"total_ns\": 3000, \"max_ns\": "
+                              "3000, \"histogram\": [0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0]}"));
+}
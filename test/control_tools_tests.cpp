@@ -0,0 +1,62 @@
+// Copyright (c) 2017 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <franka/control_tools.h>
+#include <franka/exception.h>
+
+using franka::RealtimeConfig;
+
+TEST(ControlTools, CanParseCpuList) {
+  EXPECT_EQ(std::vector<int>(), franka::parseCpuList(""));
+  EXPECT_EQ(std::vector<int>(), franka::parseCpuList("\n"));
+  EXPECT_EQ(std::vector<int>({3}), franka::parseCpuList("3"));
+  EXPECT_EQ(std::vector<int>({0, 1, 2, 5}), franka::parseCpuList("0-2,5\n"));
+  EXPECT_EQ(std::vector<int>({8, 10, 11}), franka::parseCpuList(" 8, 10-11"));
+}
+
+TEST(ControlTools, ThrowsOnMalformedCpuList) {
+  EXPECT_THROW(franka::parseCpuList("a"), std::invalid_argument);
+  EXPECT_THROW(franka::parseCpuList("1-"), std::invalid_argument);
+  EXPECT_THROW(franka::parseCpuList("3-1"), std::invalid_argument);
+  EXPECT_THROW(franka::parseCpuList("-1"), std::invalid_argument);
+}
+
+TEST(ControlTools, RejectsInvalidAffinity) {
+  std::string error_message;
+  EXPECT_FALSE(franka::setCurrentThreadAffinity({-1}, &error_message));
+  EXPECT_FALSE(error_message.empty());
+}
+
+TEST(ControlTools, RejectsInvalidPriority) {
+  std::string error_message;
+  EXPECT_FALSE(franka::setCurrentThreadSchedulerPriority(1000, &error_message));
+  EXPECT_FALSE(error_message.empty());
+}
+
+TEST(ControlTools, CanPrefaultStackAndHeap) {
+  franka::prefaultStack(256 * 1024);
+  std::string error_message;
+  EXPECT_TRUE(franka::prefaultHeap(1024 * 1024, &error_message)) << error_message;
+}
+
+TEST(ControlTools, IgnoresFailuresIfNotEnforced) {
+  RealtimeConfig config = RealtimeConfig::kIgnore;
+  config.priority = 1000;
+  config.cpus = {-1};
+  EXPECT_NO_THROW(franka::applyRealtimeConfig(config));
+}
+
+TEST(ControlTools, ThrowsOnFailuresIfEnforced) {
+  RealtimeConfig config;
+  config.priority = 1000;
+  EXPECT_THROW(franka::applyRealtimeConfig(config), franka::RealtimeException);
+
+  config = RealtimeConfig();
+  config.cpus = {-1};
+  EXPECT_THROW(franka::applyRealtimeConfig(config), franka::RealtimeException);
+}
@@ -2,7 +2,10 @@
 // Use of this source code is governed by the Apache-2.0 license, see LICENSE
 #include <atomic>
 #include <functional>
+#include <future>
+#include <memory>
 
+#include <Poco/Net/DatagramSocket.h>
 #include <gmock/gmock.h>
 
 #include <franka/exception.h>
@@ -17,10 +20,12 @@ using ::testing::Return;
 
 using franka::Gripper;
 using franka::IncompatibleVersionException;
+using franka::NetworkConfig;
 using franka::NetworkException;
 
 using research_interface::gripper::Connect;
 using research_interface::gripper::GripperState;
+using research_interface::gripper::Homing;
 
 TEST(Gripper, CannotConnectIfNoServerRunning) {
   EXPECT_THROW(Gripper gripper("127.0.0.1"), NetworkException)
@@ -41,3 +46,72 @@ TEST(Gripper, ThrowsOnIncompatibleLibraryVersion) {
 
   EXPECT_THROW(Gripper("127.0.0.1"), IncompatibleVersionException);
 }
+
+TEST(Gripper, AppliesNetworkConfig) {
+  NetworkConfig config;
+  {
+    // Let the system pick a free port and release it again for the gripper.
+    Poco::Net::DatagramSocket socket({"0.0.0.0", 0});
+    config.udp_port = socket.address().port();
+  }
+  config.udp_receive_buffer_size = 1 << 16;
+
+  std::atomic<uint16_t> udp_port{0};
+  GripperMockServer server([&](const Connect::Request& request) {
+    udp_port = request.udp_port;
+    return Connect::Response(Connect::Status::kSuccess);
+  });
+
+  Gripper gripper("127.0.0.1", config);
+  EXPECT_EQ(config.udp_port, udp_port);
+}
+
+TEST(Gripper, ThrowsIfConnectionClosedWhileWaitingForResponse) {
+  auto server = std::make_unique<GripperMockServer>();
+  Gripper gripper("127.0.0.1");
+
+  auto homing = std::async(std::launch::async, [&] { return gripper.homing(); });
+  server
+      ->generic([mock = server.get()](GripperMockServer::Socket& tcp_socket,
+                                      GripperMockServer::Socket&) {
+        mock->receiveRequest<Homing>(tcp_socket);
+      })
+      .spinOnce();
+  server.reset();
+
+  EXPECT_THROW(homing.get(), NetworkException);
+}
+
+TEST(Gripper, CanOverlapAsyncCommands) {
+  using research_interface::gripper::Move;
+
+  GripperMockServer server;
+  Gripper gripper("127.0.0.1");
+
+  server
+      .generic([&](GripperMockServer::Socket& tcp_socket, GripperMockServer::Socket&) {
+        Homing::Header homing_header;
+        server.receiveRequest<Homing>(tcp_socket, &homing_header);
+        Move::Header move_header;
+        server.receiveRequest<Move>(tcp_socket, &move_header);
+
+        // Answer in reverse order.
+        server.sendResponse<Move>(
+            tcp_socket,
+            Move::Header(Move::kCommand, move_header.command_id,
+                         sizeof(Move::Message<Move::Response>)),
+            Move::Response(Move::Status::kSuccess));
+        server.sendResponse<Homing>(
+            tcp_socket,
+            Homing::Header(Homing::kCommand, homing_header.command_id,
+                           sizeof(Homing::Message<Homing::Response>)),
+            Homing::Response(Homing::Status::kUnsuccessful));
+      })
+      .spinOnce();
+
+  std::future<bool> homing = gripper.homingAsync();
+  std::future<bool> move = gripper.moveAsync(0.05, 0.1);
+
+  EXPECT_TRUE(move.get());
+  EXPECT_FALSE(homing.get());
+}
@@ -0,0 +1,131 @@
+// Copyright (c) 2017 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include <franka/exception.h>
+#include <franka/shared_memory_channel.h>
+
+#include "io_thread_transport.h"
+#include "shared_memory_channel.h"
+
+using namespace std::chrono_literals;
+
+using franka::IoThreadTransport;
+using franka::RealtimeConfig;
+using franka::SharedMemoryChannel;
+using franka::SharedMemoryTransport;
+
+namespace {
+
+struct Datagram {
+  uint64_t message_id;
+  double value;
+};
+
+class FailingSendTransport : public SharedMemoryTransport {
+ public:
+  using SharedMemoryTransport::SharedMemoryTransport;
+
+  void udpSend(const void*, size_t) override {
+    throw franka::NetworkException("libfranka: could not send UDP data");
+  }
+};
+
+auto sendState(SharedMemoryChannel::Impl& channel, uint64_t message_id) -> bool {
+  Datagram state{message_id, 0.0};
+  return channel.states.push(&state, sizeof(state));
+}
+
+}  // anonymous namespace
+
+TEST(IoThreadTransport, ForwardsStatesAndCommands) {
+  auto channel = std::make_shared<SharedMemoryChannel::Impl>();
+  IoThreadTransport transport(std::make_unique<SharedMemoryTransport>(channel, 50ms), 1s,
+                              RealtimeConfig::kIgnore);
+
+  Datagram sent_state{1, 4.2};
+  auto send_time = std::chrono::system_clock::now() - 1s;
+  ASSERT_TRUE(channel->states.push(&sent_state, sizeof(sent_state), send_time));
+
+  Datagram state{};
+  std::chrono::system_clock::time_point receive_time{};
+  ASSERT_EQ(sizeof(state), transport.udpReceive(&state, sizeof(state), &receive_time));
+  EXPECT_EQ(1u, state.message_id);
+  EXPECT_EQ(4.2, state.value);
+  EXPECT_EQ(send_time, receive_time);
+
+  Datagram sent_command{1, 2.4};
+  transport.udpSend(&sent_command, sizeof(sent_command));
+
+  Datagram command{};
+  size_t size = 0;
+  ASSERT_TRUE(channel->commands.pop(&command, sizeof(command), &size, nullptr,
+                                    std::chrono::steady_clock::now() + 1s));
+  EXPECT_EQ(sizeof(command), size);
+  EXPECT_EQ(1u, command.message_id);
+  EXPECT_EQ(2.4, command.value);
+}
+
+TEST(IoThreadTransport, CanReceiveQueuedStatesInBatches) {
+  auto channel = std::make_shared<SharedMemoryChannel::Impl>();
+  IoThreadTransport transport(std::make_unique<SharedMemoryTransport>(channel, 50ms), 1s,
+                              RealtimeConfig::kIgnore);
+
+  for (uint64_t message_id = 1; message_id <= 3; message_id++) {
+    ASSERT_TRUE(sendState(*channel, message_id));
+  }
+
+  // Without commands, the I/O thread picks up a state at least every kCommandWait.
+  std::this_thread::sleep_for(IoThreadTransport::kCommandWait * 3 + 10ms);
+
+  std::array<Datagram, 4> states{};
+  std::array<std::chrono::system_clock::time_point, 4> receive_times{};
+  ASSERT_EQ(3u, transport.udpReceiveBatch(reinterpret_cast<uint8_t*>(states.data()),
+                                          sizeof(Datagram), states.size(), receive_times.data()));
+  EXPECT_EQ(1u, states[0].message_id);
+  EXPECT_EQ(3u, states[2].message_id);
+}
+
+TEST(IoThreadTransport, TimesOutIfNoStateArrives) {
+  auto channel = std::make_shared<SharedMemoryChannel::Impl>();
+  IoThreadTransport transport(std::make_unique<SharedMemoryTransport>(channel, 50ms), 10ms,
+                              RealtimeConfig::kIgnore);
+
+  Datagram state{};
+  EXPECT_THROW(transport.udpReceive(&state, sizeof(state), nullptr), franka::NetworkException);
+}
+
+TEST(IoThreadTransport, ForwardsErrorsOfIoThread) {
+  auto channel = std::make_shared<SharedMemoryChannel::Impl>();
+  IoThreadTransport transport(std::make_unique<FailingSendTransport>(channel, 50ms), 1s,
+                              RealtimeConfig::kIgnore);
+
+  // Commands are only sent after a state has been received, so keep sending states.
+  auto deadline = std::chrono::steady_clock::now() + 5s;
+  EXPECT_THROW(
+      {
+        for (uint64_t message_id = 1; std::chrono::steady_clock::now() < deadline; message_id++) {
+          sendState(*channel, message_id);
+          Datagram state{};
+          transport.udpReceive(&state, sizeof(state), nullptr);
+          transport.udpSend(&state, sizeof(state));
+        }
+      },
+      franka::NetworkException);
+}
+
+TEST(IoThreadTransport, ThrowsIfRealtimeConfigCannotBeApplied) {
+  auto channel = std::make_shared<SharedMemoryChannel::Impl>();
+  RealtimeConfig config;
+  config.cpus = {-1};
+
+  EXPECT_THROW(
+      IoThreadTransport(std::make_unique<SharedMemoryTransport>(channel, 50ms), 1s, config),
+      franka::RealtimeException);
+}
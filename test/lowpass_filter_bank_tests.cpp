@@ -0,0 +1,106 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <array>
+#include <cmath>
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+
+#include <franka/lowpass_filter.h>
+#include <franka/lowpass_filter_bank.h>
+
+using franka::LowpassFilterBank;
+
+namespace {
+
+// Largest absolute output over the last half of a sine input with unit amplitude.
+auto sineAmplitude(LowpassFilterBank<1>& filter, double frequency) -> double {
+  constexpr size_t kSamples = 4000;
+  double amplitude = 0.0;
+  for (size_t i = 0; i < kSamples; i++) {
+    double y = filter.filter({{std::sin(2.0 * M_PI * frequency * 0.001 * i)}})[0];
+    if (i >= kSamples / 2) {
+      amplitude = std::max(amplitude, std::abs(y));
+    }
+  }
+  return amplitude;
+}
+
+}  // anonymous namespace
+
+TEST(LowpassFilterBank, FirstOrderFiltersLikeLowpassFilter) {
+  auto filter = LowpassFilterBank<7>::firstOrder(0.001, 100.0);
+  EXPECT_EQ(1u, filter.order());
+
+  std::array<double, 7> expected{{0.0, 0.1, 0.2, 0.3, 0.4, 0.5, 0.6}};
+  filter.filter(expected);
+  for (size_t step = 0; step < 50; step++) {
+    std::array<double, 7> input;
+    for (size_t i = 0; i < input.size(); i++) {
+      input[i] = std::sin(0.1 * step + i);
+      expected[i] = franka::lowpassFilter(0.001, input[i], expected[i], 100.0);
+    }
+    std::array<double, 7> output = filter.filter(input);
+    for (size_t i = 0; i < output.size(); i++) {
+      EXPECT_DOUBLE_EQ(expected[i], output[i]);
+    }
+  }
+}
+
+TEST(LowpassFilterBank, ButterworthHasExpectedCoefficients) {
+  // Reference values of a second-order Butterworth filter with a cutoff at 0.2 times the Nyquist
+  // frequency: b = {0.06745527, 0.13491055, 0.06745527}, a = {1, -1.14298050, 0.41280160}.
+  auto filter = LowpassFilterBank<1>::butterworth(2, 0.001, 100.0);
+  EXPECT_EQ(2u, filter.order());
+
+  filter.reset({{0.0}});
+  EXPECT_NEAR(0.06745527, filter.filter({{1.0}})[0], 1e-8);
+  EXPECT_NEAR(0.13491055 + 1.14298050 * 0.06745527, filter.filter({{0.0}})[0], 1e-8);
+}
+
+TEST(LowpassFilterBank, StartsInSteadyStateAndHasUnitDcGain) {
+  for (size_t order = 1; order <= LowpassFilterBank<2>::kMaxOrder; order++) {
+    auto filter = LowpassFilterBank<2>::butterworth(order, 0.001, 50.0);
+    EXPECT_EQ(order, filter.order());
+    for (size_t i = 0; i < 10; i++) {
+      std::array<double, 2> output = filter.filter({{1.5, -2.0}});
+      EXPECT_NEAR(1.5, output[0], 1e-12);
+      EXPECT_NEAR(-2.0, output[1], 1e-12);
+    }
+
+    std::array<double, 2> output{};
+    for (size_t i = 0; i < 1000; i++) {
+      output = filter.filter({{0.5, -2.0}});
+    }
+    EXPECT_NEAR(0.5, output[0], 1e-9);
+    EXPECT_NEAR(-2.0, output[1], 1e-12);
+
+    filter.reset();
+    output = filter.filter({{3.0, 4.0}});
+    EXPECT_NEAR(3.0, output[0], 1e-12);
+    EXPECT_NEAR(4.0, output[1], 1e-12);
+  }
+}
+
+TEST(LowpassFilterBank, HigherOrdersAttenuateMore) {
+  auto first_order = LowpassFilterBank<1>::butterworth(1, 0.001, 20.0);
+  auto fourth_order = LowpassFilterBank<1>::butterworth(4, 0.001, 20.0);
+  auto passband = LowpassFilterBank<1>::butterworth(4, 0.001, 20.0);
+
+  // A Butterworth filter of order n attenuates by 1 / sqrt(1 + (f / f_c)^(2n)).
+  EXPECT_NEAR(1.0 / std::sqrt(1.0 + std::pow(5.0, 2)), sineAmplitude(first_order, 100.0), 0.02);
+  EXPECT_NEAR(1.0 / std::sqrt(1.0 + std::pow(5.0, 8)), sineAmplitude(fourth_order, 100.0), 0.002);
+  EXPECT_NEAR(1.0, sineAmplitude(passband, 2.0), 0.01);
+}
+
+TEST(LowpassFilterBank, ThrowsOnInvalidParameters) {
+  EXPECT_THROW(LowpassFilterBank<7>::firstOrder(0.001, 0.0), std::invalid_argument);
+  EXPECT_THROW(LowpassFilterBank<7>::firstOrder(-0.001, 100.0), std::invalid_argument);
+  EXPECT_THROW(LowpassFilterBank<7>::butterworth(0, 0.001, 100.0), std::invalid_argument);
+  EXPECT_THROW(LowpassFilterBank<7>::butterworth(LowpassFilterBank<7>::kMaxOrder + 1, 0.001, 100.0),
+               std::invalid_argument);
+  EXPECT_THROW(LowpassFilterBank<7>::butterworth(2, 0.0, 100.0), std::invalid_argument);
+  EXPECT_THROW(LowpassFilterBank<7>::butterworth(2, 0.001, 500.0), std::invalid_argument);
+  EXPECT_THROW(LowpassFilterBank<7>::butterworth(2, 0.001, NAN), std::invalid_argument);
+  EXPECT_NO_THROW(LowpassFilterBank<7>::butterworth(2, 0.001, 499.0));
+}
@@ -26,3 +26,13 @@ TEST(LowpassFilter, DoesFilter) {
   EXPECT_NEAR(lowpassFilter(0.001, 1.0, 0.0, 500.0), 0.7585, 1e-4);
   EXPECT_NEAR(lowpassFilter(0.001, 1.0, 0.0, 900.0), 0.8497, 1e-4);
 }
+
+TEST(LowpassFilter, PrecomputedGainGivesSameResult) {
+  for (double cutoff_frequency : {10.0, 100.0, 500.0, 1000.0}) {
+    double gain = lowpassFilterGain(0.001, cutoff_frequency);
+    EXPECT_DOUBLE_EQ(lowpassFilter(0.001, 1.0, 0.2, cutoff_frequency),
+                     lowpassFilter(gain, 1.0, 0.2));
+  }
+  EXPECT_THROW(lowpassFilterGain(0.001, 0.0), std::invalid_argument);
+  EXPECT_THROW(lowpassFilterGain(-0.001, 100.0), std::invalid_argument);
+}
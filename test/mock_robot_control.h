@@ -25,9 +25,14 @@ class MockRobotControl : public franka::RobotControl {
       franka::RobotState(const research_interface::robot::MotionGeneratorCommand* motion_command,
                          const research_interface::robot::ControllerCommand* control_command));
 
+  MOCK_METHOD2(send,
+               void(const research_interface::robot::MotionGeneratorCommand* motion_command,
+                    const research_interface::robot::ControllerCommand* control_command));
+  MOCK_METHOD0(receive, franka::RobotState());
+
   MOCK_METHOD2(throwOnMotionError, void(const franka::RobotState& robot_state, uint32_t motion_id));
 
-  franka::RealtimeConfig realtimeConfig() const noexcept override {
+  const franka::RealtimeConfig& realtimeConfig() const noexcept override {
     return franka::RealtimeConfig::kIgnore;
   }
 };
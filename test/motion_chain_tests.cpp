@@ -0,0 +1,119 @@
+// Copyright (c) 2017 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <stdexcept>
+#include <vector>
+
+#include <gmock/gmock.h>
+
+#include <franka/motion_chain.h>
+
+#include "helpers.h"
+
+using namespace ::testing;
+
+using franka::Duration;
+using franka::JointPositions;
+using franka::JointVelocities;
+using franka::MotionChain;
+using franka::RobotState;
+using franka::Trajectory;
+
+TEST(MotionChain, SwitchesSegmentsWithoutFinishingMotion) {
+  RobotState robot_state = generateValidRobotState();
+  std::vector<uint64_t> time_steps;
+  auto segment = [&](const RobotState& state, Duration time_step) {
+    time_steps.push_back(time_step.toMSec());
+    JointPositions command(state.q_d);
+    command.motion_finished = time_steps.size() % 2 == 0;
+    return command;
+  };
+
+  MotionChain<JointPositions> chain;
+  chain.then(segment).then(segment);
+  EXPECT_EQ(2u, chain.size());
+
+  EXPECT_FALSE(chain(robot_state, Duration(0)).motion_finished);
+  EXPECT_FALSE(chain(robot_state, Duration(1)).motion_finished);
+  EXPECT_EQ(1u, chain.currentSegment());
+  EXPECT_FALSE(chain(robot_state, Duration(1)).motion_finished);
+  EXPECT_TRUE(chain(robot_state, Duration(1)).motion_finished);
+  EXPECT_EQ(1u, chain.currentSegment());
+
+  EXPECT_EQ((std::vector<uint64_t>{0, 1, 0, 1}), time_steps);
+}
+
+TEST(MotionChain, PlaysTrajectories) {
+  RobotState robot_state = generateValidRobotState();
+  Trajectory<JointPositions> first;
+  Trajectory<JointPositions> second;
+  for (size_t i = 0; i < 3; i++) {
+    first.add(JointPositions(robot_state.q_d));
+    second.add(JointPositions(robot_state.q_d));
+  }
+
+  MotionChain<JointPositions> chain;
+  chain.then(first).then(second);
+
+  size_t cycles = 1;
+  while (!chain(robot_state, Duration(cycles == 1 ? 0 : 1)).motion_finished) {
+    cycles++;
+  }
+  EXPECT_EQ(first.size() + second.size(), cycles);
+}
+
+TEST(MotionChain, ThrowsOnDiscontinuousPositions) {
+  RobotState robot_state = generateValidRobotState();
+  JointPositions jump(robot_state.q_d);
+  jump.q[2] += 0.01;
+
+  MotionChain<JointPositions> chain;
+  chain.then([&](const RobotState&, Duration) { return franka::MotionFinished(jump); })
+      .then([&](const RobotState& state, Duration) { return JointPositions(state.q_d); });
+
+  // The first segment starts the motion and is not checked.
+  EXPECT_FALSE(chain(robot_state, Duration(0)).motion_finished);
+  robot_state.q_d = jump.q;
+  EXPECT_NO_THROW(chain(robot_state, Duration(1)));
+
+  MotionChain<JointPositions> discontinuous;
+  discontinuous.then([&](const RobotState& state, Duration) {
+    return franka::MotionFinished(JointPositions(state.q_d));
+  });
+  discontinuous.then([&](const RobotState&, Duration) { return jump; });
+  robot_state = generateValidRobotState();
+  discontinuous(robot_state, Duration(0));
+  EXPECT_THROW(discontinuous(robot_state, Duration(1)), std::invalid_argument);
+}
+
+TEST(MotionChain, ThrowsOnDiscontinuousVelocities) {
+  RobotState robot_state = generateValidRobotState();
+  robot_state.dq_d[0] = 0.5;
+  robot_state.ddq_d[0] = 1.0;
+
+  auto finish = [](const RobotState& state, Duration) {
+    return franka::MotionFinished(JointVelocities(state.dq_d));
+  };
+  auto keep = [](const RobotState& state, Duration) { return JointVelocities(state.dq_d); };
+  auto stop = [](const RobotState&, Duration) {
+    return JointVelocities({0, 0, 0, 0, 0, 0, 0});
+  };
+
+  MotionChain<JointVelocities> continuous;
+  continuous.then(finish).then(keep);
+  continuous(robot_state, Duration(0));
+  EXPECT_NO_THROW(continuous(robot_state, Duration(1)));
+
+  MotionChain<JointVelocities> discontinuous;
+  discontinuous.then(finish).then(stop);
+  discontinuous(robot_state, Duration(0));
+  EXPECT_THROW(discontinuous(robot_state, Duration(1)), std::invalid_argument);
+}
+
+TEST(MotionChain, ThrowsOnInvalidSegments) {
+  MotionChain<JointPositions> chain;
+  EXPECT_TRUE(chain.empty());
+  EXPECT_THROW(chain(generateValidRobotState(), Duration(0)), std::invalid_argument);
+  EXPECT_THROW(chain.then(MotionChain<JointPositions>::Callback()), std::invalid_argument);
+  EXPECT_THROW(chain.then(Trajectory<JointPositions>()), std::invalid_argument);
+  EXPECT_TRUE(chain.empty());
+}
@@ -0,0 +1,206 @@
+// Copyright (c) 2017 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <array>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+#include <gmock/gmock.h>
+
+#include <franka/exception.h>
+#include <franka/motion_session.h>
+
+#include "control_loop.h"
+#include "helpers.h"
+#include "mock_robot_control.h"
+
+using namespace ::testing;
+
+using franka::CartesianPose;
+using franka::ControllerMode;
+using franka::Duration;
+using franka::JointPositions;
+using franka::JointVelocities;
+using franka::MotionSession;
+using franka::RobotState;
+using franka::Torques;
+
+using research_interface::robot::ControllerCommand;
+using research_interface::robot::MotionGeneratorCommand;
+using research_interface::robot::Move;
+
+TEST(MotionSession, SendsCommandsWithoutWaitingForState) {
+  NiceMock<MockRobotControl> robot;
+  std::mutex mutex;
+  RobotState robot_state = generateValidRobotState();
+  JointPositions motion(robot_state.q_d);
+  motion.q[0] += 0.01;
+
+  EXPECT_CALL(robot, startMotion(Move::ControllerMode::kJointImpedance,
+                                 Move::MotionGeneratorMode::kJointPosition,
+                                 franka::kDefaultDeviation, franka::kDefaultDeviation))
+      .WillOnce(Return(100));
+  EXPECT_CALL(robot, update(_, _)).Times(0);
+  EXPECT_CALL(robot, receive()).Times(3).WillRepeatedly(Return(robot_state));
+  EXPECT_CALL(robot, throwOnMotionError(_, 100)).Times(3);
+  EXPECT_CALL(robot, send(_, nullptr))
+      .Times(2)
+      .WillRepeatedly(Invoke([&](const MotionGeneratorCommand* command, const ControllerCommand*) {
+        EXPECT_EQ(motion.q, command->q_c);
+      }));
+  EXPECT_CALL(robot, finishMotion(100, NotNull(), nullptr));
+  EXPECT_CALL(robot, cancelMotion(_)).Times(0);
+
+  MotionSession<JointPositions> session(robot, std::unique_lock<std::mutex>(mutex),
+                                        ControllerMode::kJointImpedance, false,
+                                        franka::kMaxCutoffFrequency);
+  EXPECT_FALSE(mutex.try_lock());
+  for (int i = 0; i < 2; i++) {
+    session.waitForState();
+    session.sendCommand(motion);
+  }
+  session.waitForState();
+  session.sendCommand(franka::MotionFinished(motion));
+  EXPECT_TRUE(session.finished());
+}
+
+class CartesianPoseControlLoop : public franka::ControlLoop<CartesianPose> {
+ public:
+  using franka::ControlLoop<CartesianPose>::ControlLoop;
+  using franka::ControlLoop<CartesianPose>::spinMotion;
+};
+
+TEST(MotionSession, ConditionsCartesianPosesLikeControlLoop) {
+  std::mutex mutex;
+  RobotState robot_state = generateValidRobotState();
+  robot_state.O_T_EE_c = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0.3, 0, 0.5, 1};
+  // Rotated about z and moved along x, so that both the orientation and the translation are
+  // filtered and limited.
+  const double angle = 0.05;
+  CartesianPose pose({std::cos(angle), std::sin(angle), 0, 0, -std::sin(angle), std::cos(angle), 0,
+                      0, 0, 0, 1, 0, 0.31, 0, 0.5, 1});
+
+  NiceMock<MockRobotControl> loop_robot;
+  CartesianPoseControlLoop loop(
+      loop_robot, ControllerMode::kJointImpedance,
+      [&](const RobotState&, Duration) { return pose; }, true, 100.0);
+
+  NiceMock<MockRobotControl> session_robot;
+  std::vector<std::array<double, 16>> sent_poses;
+  ON_CALL(session_robot, receive()).WillByDefault(ReturnPointee(&robot_state));
+  ON_CALL(session_robot, send(_, _))
+      .WillByDefault(Invoke([&](const MotionGeneratorCommand* command, const ControllerCommand*) {
+        sent_poses.push_back(command->O_T_EE_c);
+      }));
+  MotionSession<CartesianPose> session(session_robot, std::unique_lock<std::mutex>(mutex),
+                                       ControllerMode::kJointImpedance, true, 100.0);
+
+  for (size_t i = 0; i < 3; i++) {
+    MotionGeneratorCommand command{};
+    EXPECT_TRUE(loop.spinMotion(robot_state, Duration(1), &command));
+    session.waitForState();
+    session.sendCommand(pose);
+
+    ASSERT_EQ(i + 1, sent_poses.size());
+    EXPECT_EQ(command.O_T_EE_c, sent_poses.back());
+    // Track the command like the robot.
+    robot_state.O_T_EE_c = command.O_T_EE_c;
+  }
+}
+
+TEST(MotionSession, SendsTorquesWithZeroVelocities) {
+  NiceMock<MockRobotControl> robot;
+  std::mutex mutex;
+  RobotState robot_state = generateValidRobotState();
+  Torques torques({0, 1, 2, 3, 4, 5, 6});
+
+  EXPECT_CALL(robot, startMotion(Move::ControllerMode::kExternalController,
+                                 Move::MotionGeneratorMode::kJointVelocity, _, _))
+      .WillOnce(Return(100));
+  ON_CALL(robot, receive()).WillByDefault(Return(robot_state));
+  EXPECT_CALL(robot, send(NotNull(), NotNull()))
+      .WillOnce(Invoke([&](const MotionGeneratorCommand* motion, const ControllerCommand* control) {
+        EXPECT_EQ((std::array<double, 7>{}), motion->dq_c);
+        EXPECT_EQ(torques.tau_J, control->tau_J_d);
+      }));
+  EXPECT_CALL(robot, cancelMotion(100));
+
+  MotionSession<JointVelocities> session(robot, std::unique_lock<std::mutex>(mutex), false,
+                                         franka::kMaxCutoffFrequency);
+  session.waitForState();
+  EXPECT_THROW(session.sendCommand(JointVelocities({0, 0, 0, 0, 0, 0, 0})),
+               franka::InvalidOperationException);
+  session.sendCommand(torques);
+  EXPECT_FALSE(session.finished());
+}
+
+TEST(MotionSession, ThrowsIfStepsAreOutOfOrder) {
+  NiceMock<MockRobotControl> robot;
+  std::mutex mutex;
+  RobotState robot_state = generateValidRobotState();
+  ON_CALL(robot, receive()).WillByDefault(Return(robot_state));
+
+  MotionSession<JointPositions> session(robot, std::unique_lock<std::mutex>(mutex),
+                                        ControllerMode::kJointImpedance, false,
+                                        franka::kMaxCutoffFrequency);
+  EXPECT_THROW(session.sendCommand(JointPositions(robot_state.q_d)),
+               franka::InvalidOperationException);
+  session.waitForState();
+  EXPECT_THROW(session.waitForState(), franka::InvalidOperationException);
+  EXPECT_THROW(session.sendCommand(JointPositions(robot_state.q_d), Torques(robot_state.tau_J)),
+               franka::InvalidOperationException);
+  EXPECT_FALSE(session.finished());
+}
+
+TEST(MotionSession, CancelsMotionOnInvalidCommand) {
+  NiceMock<MockRobotControl> robot;
+  std::mutex mutex;
+  RobotState robot_state = generateValidRobotState();
+  ON_CALL(robot, startMotion(_, _, _, _)).WillByDefault(Return(100));
+  ON_CALL(robot, receive()).WillByDefault(Return(robot_state));
+  EXPECT_CALL(robot, send(_, _)).Times(0);
+  EXPECT_CALL(robot, cancelMotion(100)).Times(1);
+
+  MotionSession<JointPositions> session(robot, std::unique_lock<std::mutex>(mutex),
+                                        ControllerMode::kJointImpedance, false,
+                                        franka::kMaxCutoffFrequency);
+  session.waitForState();
+  JointPositions motion(robot_state.q_d);
+  motion.q[3] = std::numeric_limits<double>::quiet_NaN();
+  EXPECT_THROW(session.sendCommand(motion), std::invalid_argument);
+  EXPECT_TRUE(session.finished());
+  EXPECT_THROW(session.waitForState(), franka::InvalidOperationException);
+}
+
+TEST(MotionSession, CancelsMotionOnControlException) {
+  NiceMock<MockRobotControl> robot;
+  std::mutex mutex;
+  ON_CALL(robot, startMotion(_, _, _, _)).WillByDefault(Return(100));
+  ON_CALL(robot, receive()).WillByDefault(Return(generateValidRobotState()));
+  EXPECT_CALL(robot, throwOnMotionError(_, 100))
+      .WillOnce(Throw(franka::ControlException("reflex")));
+  EXPECT_CALL(robot, cancelMotion(100)).Times(1);
+
+  MotionSession<JointPositions> session(robot, std::unique_lock<std::mutex>(mutex),
+                                        ControllerMode::kJointImpedance, false,
+                                        franka::kMaxCutoffFrequency);
+  EXPECT_THROW(session.waitForState(), franka::ControlException);
+  EXPECT_TRUE(session.finished());
+}
+
+TEST(MotionSession, CancelsUnfinishedMotionOnDestruction) {
+  NiceMock<MockRobotControl> robot;
+  std::mutex mutex;
+  ON_CALL(robot, startMotion(_, _, _, _)).WillByDefault(Return(100));
+  EXPECT_CALL(robot, cancelMotion(100)).Times(1);
+
+  {
+    MotionSession<JointPositions> session(robot, std::unique_lock<std::mutex>(mutex),
+                                          ControllerMode::kJointImpedance, false,
+                                          franka::kMaxCutoffFrequency);
+  }
+  EXPECT_TRUE(mutex.try_lock());
+  mutex.unlock();
+}
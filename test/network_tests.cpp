@@ -0,0 +1,175 @@
+// Copyright (c) 2017 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <franka/exception.h>
+#include <research_interface/robot/service_types.h>
+
+#include "network.h"
+
+using franka::Network;
+using franka::Transport;
+
+using research_interface::robot::CommandHeader;
+using research_interface::robot::LoadModelLibrary;
+
+namespace {
+
+// Transport which answers each request with the next queued response. Each read returns at most
+// max_read_size bytes, like a TCP connection would.
+class ScriptedTransport : public Transport {
+ public:
+  explicit ScriptedTransport(size_t max_read_size = 1500) : max_read_size_(max_read_size) {}
+
+  void queueResponse(std::vector<uint8_t> response) {
+    std::lock_guard<std::mutex> _(mutex_);
+    queued_.push_back(std::move(response));
+  }
+
+  auto udpPort() const noexcept -> uint16_t override { return 0; }
+  auto udpReceive(void*, size_t, std::chrono::system_clock::time_point*) -> size_t override {
+    throw franka::NetworkException("libfranka: UDP receive: Timeout");
+  }
+  auto udpReceiveBatch(uint8_t*, size_t, size_t, std::chrono::system_clock::time_point*)
+      -> size_t override {
+    return 0;
+  }
+  void udpSend(const void*, size_t) override {}
+
+  void tcpSend(const void*, size_t) override {
+    std::lock_guard<std::mutex> _(mutex_);
+    if (!queued_.empty()) {
+      readable_.insert(readable_.end(), queued_.front().begin(), queued_.front().end());
+      queued_.pop_front();
+    }
+  }
+  auto tcpPoll(std::chrono::microseconds timeout) -> bool override {
+    {
+      std::lock_guard<std::mutex> _(mutex_);
+      if (!readable_.empty()) {
+        return true;
+      }
+    }
+    std::this_thread::sleep_for(std::min(timeout, std::chrono::microseconds(1000)));
+    return false;
+  }
+  auto tcpReceive(void* data, size_t size) -> size_t override {
+    std::lock_guard<std::mutex> _(mutex_);
+    size_t read_size = std::min({size, readable_.size(), max_read_size_});
+    std::copy_n(readable_.begin(), read_size, static_cast<uint8_t*>(data));
+    readable_.erase(readable_.begin(), readable_.begin() + read_size);
+    return read_size;
+  }
+  void tcpShutdown() noexcept override {}
+
+ private:
+  const size_t max_read_size_;
+  std::mutex mutex_;
+  std::deque<std::vector<uint8_t>> queued_;
+  std::deque<uint8_t> readable_;
+};
+
+auto makeLoadModelLibraryResponse(uint32_t command_id,
+                                  LoadModelLibrary::Status status,
+                                  const std::vector<uint8_t>& payload) -> std::vector<uint8_t> {
+  using Message = LoadModelLibrary::Message<LoadModelLibrary::Response>;
+  Message message(CommandHeader(LoadModelLibrary::kCommand, command_id,
+                                static_cast<uint32_t>(sizeof(Message) + payload.size())),
+                  LoadModelLibrary::Response(status));
+  std::vector<uint8_t> response(sizeof(message));
+  std::memcpy(response.data(), &message, sizeof(message));
+  response.insert(response.end(), payload.begin(), payload.end());
+  return response;
+}
+
+auto makePayload(size_t size) -> std::vector<uint8_t> {
+  std::vector<uint8_t> payload(size);
+  for (size_t i = 0; i < size; i++) {
+    payload[i] = static_cast<uint8_t>(i * 31 + i / 256);
+  }
+  return payload;
+}
+
+}  // anonymous namespace
+
+TEST(Network, StreamsVariableLengthDataInSeveralChunks) {
+  // Three full chunks of 64 KiB and a partial one.
+  std::vector<uint8_t> payload = makePayload(3 * 64 * 1024 + 12345);
+  auto transport = std::make_unique<ScriptedTransport>(payload.size() * 2);
+  transport->queueResponse(
+      makeLoadModelLibraryResponse(0, LoadModelLibrary::Status::kSuccess, payload));
+  Network network(std::move(transport));
+
+  std::vector<uint8_t> received;
+  size_t chunks = 0;
+  uint32_t command_id = network.tcpSendRequestStreaming<LoadModelLibrary>(
+      [&](const uint8_t* data, size_t size) {
+        received.insert(received.end(), data, data + size);
+        chunks++;
+      },
+      LoadModelLibrary::Architecture::kX64, LoadModelLibrary::System::kLinux);
+  auto response = network.tcpBlockingReceiveResponse<LoadModelLibrary>(command_id);
+
+  EXPECT_EQ(LoadModelLibrary::Status::kSuccess, response.status);
+  EXPECT_EQ(4u, chunks);
+  EXPECT_EQ(payload, received);
+}
+
+TEST(Network, StreamsVariableLengthDataOfErrorResponse) {
+  std::vector<uint8_t> payload = makePayload(100);
+  auto transport = std::make_unique<ScriptedTransport>();
+  transport->queueResponse(
+      makeLoadModelLibraryResponse(0, LoadModelLibrary::Status::kError, payload));
+  Network network(std::move(transport));
+
+  std::vector<uint8_t> received;
+  uint32_t command_id = network.tcpSendRequestStreaming<LoadModelLibrary>(
+      [&](const uint8_t* data, size_t size) { received.insert(received.end(), data, data + size); },
+      LoadModelLibrary::Architecture::kX64, LoadModelLibrary::System::kLinux);
+  auto response = network.tcpBlockingReceiveResponse<LoadModelLibrary>(command_id);
+
+  EXPECT_EQ(LoadModelLibrary::Status::kError, response.status);
+  EXPECT_EQ(payload, received);
+}
+
+TEST(Network, RethrowsExceptionOfStreamCallback) {
+  auto transport = std::make_unique<ScriptedTransport>();
+  transport->queueResponse(makeLoadModelLibraryResponse(0, LoadModelLibrary::Status::kSuccess,
+                                                        makePayload(2 * 64 * 1024)));
+  std::vector<uint8_t> payload = makePayload(10);
+  transport->queueResponse(
+      makeLoadModelLibraryResponse(1, LoadModelLibrary::Status::kSuccess, payload));
+  Network network(std::move(transport));
+
+  size_t calls = 0;
+  uint32_t command_id = network.tcpSendRequestStreaming<LoadModelLibrary>(
+      [&](const uint8_t*, size_t) {
+        if (++calls == 2) {
+          throw std::runtime_error("disk full");
+        }
+      },
+      LoadModelLibrary::Architecture::kX64, LoadModelLibrary::System::kLinux);
+  EXPECT_THROW(network.tcpBlockingReceiveResponse<LoadModelLibrary>(command_id),
+               std::runtime_error);
+  EXPECT_EQ(2u, calls);
+
+  // The discarded data does not corrupt the following response.
+  std::vector<uint8_t> received;
+  command_id = network.tcpSendRequestStreaming<LoadModelLibrary>(
+      [&](const uint8_t* data, size_t size) { received.insert(received.end(), data, data + size); },
+      LoadModelLibrary::Architecture::kX64, LoadModelLibrary::System::kLinux);
+  auto response = network.tcpBlockingReceiveResponse<LoadModelLibrary>(command_id);
+
+  EXPECT_EQ(LoadModelLibrary::Status::kSuccess, response.status);
+  EXPECT_EQ(payload, received);
+}
@@ -0,0 +1,82 @@
+// Copyright (c) 2017 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <chrono>
+
+#include <gtest/gtest.h>
+
+#include "packet_statistics.h"
+
+using namespace std::chrono_literals;
+
+using franka::PacketStatistics;
+using franka::PacketStatisticsRecorder;
+
+TEST(PacketStatistics, IsEmptyInitially) {
+  PacketStatisticsRecorder recorder;
+  PacketStatistics statistics = recorder.snapshot();
+
+  EXPECT_EQ(0u, statistics.received);
+  EXPECT_EQ(0u, statistics.message_id_gaps);
+  for (uint64_t count : statistics.inter_arrival_histogram) {
+    EXPECT_EQ(0u, count);
+  }
+}
+
+TEST(PacketStatistics, CountsGapsOutOfOrderAndDuplicates) {
+  PacketStatisticsRecorder recorder;
+  std::chrono::system_clock::time_point time{};
+
+  for (uint64_t message_id : {2, 1, 5, 2, 3, 3, 4}) {
+    recorder.record(message_id, time);
+    time += 1ms;
+  }
+  PacketStatistics statistics = recorder.snapshot();
+
+  EXPECT_EQ(7u, statistics.received);
+  EXPECT_EQ(2u, statistics.message_id_gaps);
+  EXPECT_EQ(3u, statistics.out_of_order);
+  EXPECT_EQ(2u, statistics.duplicates);
+}
+
+TEST(PacketStatistics, TreatsStatesOutsideOfWindowAsOutOfOrder) {
+  PacketStatisticsRecorder recorder;
+
+  recorder.record(1, {});
+  recorder.record(1000, {});
+  recorder.record(1, {});
+  PacketStatistics statistics = recorder.snapshot();
+
+  EXPECT_EQ(998u, statistics.message_id_gaps);
+  EXPECT_EQ(1u, statistics.out_of_order);
+  EXPECT_EQ(0u, statistics.duplicates);
+}
+
+TEST(PacketStatistics, CountsStaleStates) {
+  PacketStatisticsRecorder recorder;
+
+  recorder.recordStale(2);
+  recorder.recordStale(0);
+  recorder.recordStale(5);
+  recorder.recordStale(1);
+  PacketStatistics statistics = recorder.snapshot();
+
+  EXPECT_EQ(8u, statistics.stale);
+  EXPECT_EQ(5u, statistics.max_stale_per_read);
+}
+
+TEST(PacketStatistics, BuildsInterArrivalHistogram) {
+  PacketStatisticsRecorder recorder;
+  std::chrono::system_clock::time_point time{};
+
+  recorder.record(1, time);
+  recorder.record(2, time + 1ms);
+  recorder.record(3, time + 2ms);
+  recorder.record(4, time + 2ms + 100us);
+  recorder.record(5, time + 1s);
+  PacketStatistics statistics = recorder.snapshot();
+
+  const auto one_millisecond = 1ms / PacketStatistics::kInterArrivalBucketWidth;
+  EXPECT_EQ(1u, statistics.inter_arrival_histogram[0]);
+  EXPECT_EQ(2u, statistics.inter_arrival_histogram[one_millisecond]);
+  EXPECT_EQ(1u, statistics.inter_arrival_histogram.back());
+}
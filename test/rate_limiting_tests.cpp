@@ -1,5 +1,8 @@
 // Copyright (c) 2018 Franka Emika GmbH
 // Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <cstring>
+#include <random>
+#include <stdexcept>
 
 #include <gtest/gtest.h>
 //------------g alexander mac osx ---------------------//
@@ -523,3 +526,82 @@ TEST(RateLimiting, CartesianPose) {
       kNoLimit, differentiateOneSample(limited_cartesian_pose, last_cmd_pose, kDeltaT),
       last_cmd_velocity, last_cmd_acceleration, kDeltaT));
 }
+
+TEST(RateLimiting, JointArraysAreBitIdenticalToScalarLimiting) {
+  std::mt19937 generator(42);
+  std::uniform_real_distribution<double> distribution(-3.0, 3.0);
+  auto random = [&](double scale) {
+    std::array<double, 7> values{};
+    for (double& value : values) {
+      value = scale * distribution(generator);
+    }
+    return values;
+  };
+  auto expectBitIdentical = [](const std::array<double, 7>& expected,
+                               const std::array<double, 7>& actual) {
+    EXPECT_EQ(0, std::memcmp(expected.data(), actual.data(), sizeof(expected)));
+  };
+
+  for (size_t i = 0; i < 1000; i++) {
+    std::array<double, 7> max_velocity = random(1.0);
+    std::array<double, 7> max_acceleration = random(10.0);
+    std::array<double, 7> max_jerk = random(1000.0);
+    for (size_t j = 0; j < 7; j++) {
+      max_velocity[j] = std::abs(max_velocity[j]);
+      max_acceleration[j] = std::abs(max_acceleration[j]);
+      max_jerk[j] = std::abs(max_jerk[j]);
+    }
+    std::array<double, 7> last_position = random(1.0);
+    std::array<double, 7> last_velocity = random(1.0);
+    std::array<double, 7> last_acceleration = random(10.0);
+    std::array<double, 7> commanded = random(1.0);
+    // Signed zeros and values at the limits select between equal operands of std::min/std::max.
+    commanded[0] = -0.0;
+    last_velocity[0] = 0.0;
+    last_acceleration[1] = -0.0;
+    commanded[2] = last_position[2] + max_velocity[2] * kDeltaT;
+
+    std::array<double, 7> expected_derivatives{};
+    std::array<double, 7> expected_velocities{};
+    std::array<double, 7> expected_positions{};
+    for (size_t j = 0; j < 7; j++) {
+      double commanded_derivative = (commanded[j] - last_position[j]) / kDeltaT;
+      expected_derivatives[j] =
+          last_position[j] +
+          std::max(std::min(commanded_derivative, max_velocity[j]), -max_velocity[j]) * kDeltaT;
+      expected_velocities[j] =
+          limitRate(max_velocity[j], max_acceleration[j], max_jerk[j], commanded[j],
+                    last_velocity[j], last_acceleration[j]);
+      expected_positions[j] =
+          limitRate(max_velocity[j], max_acceleration[j], max_jerk[j], commanded[j],
+                    last_position[j], last_velocity[j], last_acceleration[j]);
+    }
+
+    expectBitIdentical(expected_derivatives, limitRate(max_velocity, commanded, last_position));
+    expectBitIdentical(expected_velocities,
+                       limitRate(max_velocity, max_acceleration, max_jerk, commanded,
+                                 last_velocity, last_acceleration));
+    expectBitIdentical(expected_positions,
+                       limitRate(max_velocity, max_acceleration, max_jerk, commanded,
+                                 last_position, last_velocity, last_acceleration));
+  }
+}
+
+TEST(RateLimiting, JointArraysThrowOnNonFiniteValues) {
+  std::array<double, 7> zeros{};
+  std::array<double, 7> invalid{};
+  invalid[6] = std::numeric_limits<double>::infinity();
+
+  EXPECT_THROW(limitRate(kJointsNoLimit, invalid, zeros), std::invalid_argument);
+  EXPECT_THROW(limitRate(kJointsNoLimit, kJointsNoLimit, kJointsNoLimit, invalid, zeros, zeros),
+               std::invalid_argument);
+  EXPECT_THROW(
+      limitRate(kJointsNoLimit, kJointsNoLimit, kJointsNoLimit, invalid, zeros, zeros, zeros),
+      std::invalid_argument);
+  // The velocity derived from finite positions can still overflow.
+  std::array<double, 7> large{};
+  large[3] = std::numeric_limits<double>::max();
+  EXPECT_THROW(
+      limitRate(kJointsNoLimit, kJointsNoLimit, kJointsNoLimit, large, zeros, zeros, zeros),
+      std::invalid_argument);
+}
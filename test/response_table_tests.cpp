@@ -0,0 +1,90 @@
+// Copyright (c) 2017 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "response_table.h"
+
+using franka::ResponseTable;
+
+TEST(ResponseTable, ReturnsNullptrForUnknownCommand) {
+  ResponseTable table(4, 16);
+  EXPECT_EQ(nullptr, table.find(1));
+}
+
+TEST(ResponseTable, SwapsBuffersWithoutCopying) {
+  ResponseTable table(4, 16);
+
+  std::vector<uint8_t> buffer{1, 2, 3};
+  const uint8_t* data = buffer.data();
+  table.insert(7, &buffer);
+
+  EXPECT_TRUE(buffer.empty());
+  EXPECT_GE(buffer.capacity(), 16u);
+
+  const std::vector<uint8_t>* response = table.find(7);
+  ASSERT_NE(nullptr, response);
+  EXPECT_EQ(data, response->data());
+  EXPECT_EQ((std::vector<uint8_t>{1, 2, 3}), *response);
+
+  table.release(response);
+  EXPECT_EQ(nullptr, table.find(7));
+  EXPECT_EQ(0u, table.size());
+}
+
+TEST(ResponseTable, MovesTakenResponsesOutOfTheTable) {
+  ResponseTable table(1, 16);
+
+  std::vector<uint8_t> buffer{1, 2, 3};
+  const uint8_t* data = buffer.data();
+  table.insert(7, &buffer);
+
+  std::vector<uint8_t> response = table.take(table.find(7));
+  EXPECT_EQ(data, response.data());
+  EXPECT_EQ((std::vector<uint8_t>{1, 2, 3}), response);
+  EXPECT_EQ(0u, table.size());
+
+  // The freed slot has got a new preallocated buffer.
+  std::vector<uint8_t> next{4};
+  table.insert(8, &next);
+  EXPECT_GE(next.capacity(), 16u);
+  EXPECT_EQ(1u, table.size());
+}
+
+TEST(ResponseTable, ReturnsResponsesToTheSameCommandInOrder) {
+  ResponseTable table(4, 16);
+
+  for (uint8_t i = 0; i < 3; i++) {
+    std::vector<uint8_t> buffer{i};
+    table.insert(i == 1 ? 2 : 1, &buffer);
+  }
+
+  const std::vector<uint8_t>* response = table.find(1);
+  ASSERT_NE(nullptr, response);
+  EXPECT_EQ(0, response->front());
+  table.release(response);
+
+  response = table.find(1);
+  ASSERT_NE(nullptr, response);
+  EXPECT_EQ(2, response->front());
+  table.release(response);
+
+  EXPECT_EQ(1u, table.size());
+}
+
+TEST(ResponseTable, GrowsIfAllSlotsAreTaken) {
+  ResponseTable table(2, 16);
+
+  for (uint32_t command_id = 0; command_id < 5; command_id++) {
+    std::vector<uint8_t> buffer{static_cast<uint8_t>(command_id)};
+    table.insert(command_id, &buffer);
+  }
+
+  EXPECT_EQ(5u, table.size());
+  for (uint32_t command_id = 0; command_id < 5; command_id++) {
+    const std::vector<uint8_t>* response = table.find(command_id);
+    ASSERT_NE(nullptr, response);
+    EXPECT_EQ(command_id, response->front());
+  }
+}
@@ -3,7 +3,9 @@
 #include <gtest/gtest.h>
 
 #include <atomic>
+#include <chrono>
 #include <cstring>
+#include <future>
 #include <limits>
 
 #include <logger.h>
@@ -38,6 +40,23 @@ TEST(RobotImpl, CanReceiveRobotState) {
   testRobotStatesAreEqual(sent_robot_state, received_robot_state);
 }
 
+TEST(RobotImpl, StampsRobotStatesWithHostReceiveTime) {
+  RobotMockServer server;
+  Robot::Impl robot(std::make_unique<franka::Network>("127.0.0.1", kCommandPort), 0);
+
+  auto before = std::chrono::system_clock::now();
+  server.sendEmptyState<RobotState>().spinOnce();
+
+  auto received_robot_state = robot.update(nullptr, nullptr);
+  auto after = std::chrono::system_clock::now();
+
+  EXPECT_LE(before, received_robot_state.host_receive_time);
+  EXPECT_GE(after, received_robot_state.host_receive_time);
+  EXPECT_GE(received_robot_state.host_receive_latency.count(), 0);
+  EXPECT_EQ(std::chrono::system_clock::time_point(), received_robot_state.host_command_send_time);
+  EXPECT_EQ(0, received_robot_state.host_command_turnaround.count());
+}
+
 TEST(RobotImpl, CanReceiveReorderedRobotStatesCorrectly) {
   RobotMockServer server;
   Robot::Impl robot(std::make_unique<franka::Network>("127.0.0.1", kCommandPort), 0);
@@ -58,6 +77,60 @@ TEST(RobotImpl, CanReceiveReorderedRobotStatesCorrectly) {
   EXPECT_EQ(4u, received_robot_state.time.toMSec());
 }
 
+TEST(RobotImpl, CollectsPacketStatistics) {
+  RobotMockServer server;
+  Robot::Impl robot(std::make_unique<franka::Network>("127.0.0.1", kCommandPort), 0);
+
+  // The initial state has message ID 1.
+  server.onSendUDP<RobotState>([](RobotState& robot_state) { robot_state.message_id = 1; })
+      .onSendUDP<RobotState>([](RobotState& robot_state) { robot_state.message_id = 4; })
+      .spinOnce();
+  auto received_robot_state = robot.update(nullptr, nullptr);
+  ASSERT_EQ(4u, received_robot_state.time.toMSec());
+
+  franka::PacketStatistics statistics = robot.packetStatistics();
+  EXPECT_EQ(3u, statistics.received);
+  EXPECT_EQ(2u, statistics.message_id_gaps);
+  EXPECT_EQ(1u, statistics.duplicates);
+  EXPECT_EQ(0u, statistics.out_of_order);
+  EXPECT_EQ(1u, statistics.stale);
+}
+
+TEST(RobotImpl, IgnoresOlderRobotStatesWhileWaiting) {
+  RobotMockServer server;
+  Robot::Impl robot(std::make_unique<franka::Network>("127.0.0.1", kCommandPort), 0);
+
+  server.onSendUDP<RobotState>([](RobotState& robot_state) { robot_state.message_id = 5; })
+      .spinOnce();
+  EXPECT_EQ(5u, robot.update(nullptr, nullptr).time.toMSec());
+
+  auto received_robot_state =
+      std::async(std::launch::async, [&robot]() { return robot.update(nullptr, nullptr); });
+  server.onSendUDP<RobotState>([](RobotState& robot_state) { robot_state.message_id = 3; })
+      .onSendUDP<RobotState>([](RobotState& robot_state) { robot_state.message_id = 5; })
+      .onSendUDP<RobotState>([](RobotState& robot_state) { robot_state.message_id = 6; })
+      .spinOnce();
+
+  EXPECT_EQ(6u, received_robot_state.get().time.toMSec());
+}
+
+TEST(RobotImpl, CanDrainMoreQueuedRobotStatesThanOneBatch) {
+  RobotMockServer server;
+  Robot::Impl robot(std::make_unique<franka::Network>("127.0.0.1", kCommandPort), 0);
+
+  constexpr size_t kQueuedStates = franka::Transport::kMaxReceiveBatchSize + 8;
+  constexpr uint64_t kNewestMessageId = 1000;
+  for (size_t i = 0; i < kQueuedStates; i++) {
+    server.onSendUDP<RobotState>([=](RobotState& robot_state) {
+      robot_state.message_id = (i == 5) ? kNewestMessageId : 10 + i;
+    });
+  }
+  server.spinOnce();
+
+  auto received_robot_state = robot.update(nullptr, nullptr);
+  EXPECT_EQ(kNewestMessageId, received_robot_state.time.toMSec());
+}
+
 TEST(RobotImpl, ThrowsTimeoutIfNoRobotStateArrives) {
   RobotMockServer server;
   Robot::Impl robot(std::make_unique<franka::Network>("127.0.0.1", kCommandPort, 200ms), 0);
@@ -358,7 +431,10 @@ TEST(RobotImpl, CanSendControllerCommand) {
       })
       .spinOnce();
 
-  EXPECT_NO_THROW(robot.update(&sent_command.motion, &sent_command.control));
+  franka::RobotState robot_state;
+  EXPECT_NO_THROW(robot_state = robot.update(&sent_command.motion, &sent_command.control));
+  EXPECT_LT(std::chrono::system_clock::time_point(), robot_state.host_command_send_time);
+  EXPECT_GE(robot_state.host_command_turnaround.count(), 0);
 }
 
 TEST(RobotImpl, CanSendMotionGeneratorAndControlCommand) {
@@ -456,3 +456,95 @@ TEST(Robot, ThrowsIfConflictingOperationIsRunning) {
     thread.join();
   }
 }
+
+TEST(Robot, SendsConfigurationCommandsBeforeAwaitingResponses) {
+  RobotMockServer server;
+  Robot robot("127.0.0.1");
+
+  RobotConfiguration configuration;
+  configuration.joint_impedance = std::array<double, 7>{1, 2, 3, 4, 5, 6, 7};
+  configuration.EE_T_K = std::array<double, 16>{};
+  configuration.load = RobotConfiguration::Load{1.5, {0, 0, 0.1}, {}};
+
+  server
+      .generic([&](RobotMockServer::Socket& tcp_socket, RobotMockServer::Socket&) {
+        // All requests have to arrive before the first response is sent.
+        robot::SetJointImpedance::Header joint_impedance_header;
+        auto joint_impedance_request =
+            server.receiveRequest<robot::SetJointImpedance>(tcp_socket, &joint_impedance_header);
+        robot::SetEEToK::Header ee_to_k_header;
+        server.receiveRequest<robot::SetEEToK>(tcp_socket, &ee_to_k_header);
+        robot::SetLoad::Header load_header;
+        auto load_request = server.receiveRequest<robot::SetLoad>(tcp_socket, &load_header);
+
+        EXPECT_EQ(configuration.joint_impedance, joint_impedance_request.K_theta);
+        EXPECT_EQ(configuration.load->load_mass, load_request.m_load);
+
+        auto send_success = [&](auto command, uint32_t command_id) {
+          using T = decltype(command);
+          server.sendResponse<T>(
+              tcp_socket,
+              typename T::Header(T::kCommand, command_id,
+                                 sizeof(typename T::template Message<typename T::Response>)),
+              typename T::Response(T::Status::kSuccess));
+        };
+        send_success(robot::SetLoad{}, load_header.command_id);
+        send_success(robot::SetEEToK{}, ee_to_k_header.command_id);
+        send_success(robot::SetJointImpedance{}, joint_impedance_header.command_id);
+      })
+      .spinOnce();
+
+  EXPECT_NO_THROW(robot.configure(configuration));
+}
+
+TEST(Robot, ReportsEachFailedConfigurationCommand) {
+  RobotMockServer server;
+  Robot robot("127.0.0.1");
+
+  RobotConfiguration configuration;
+  configuration.joint_impedance = std::array<double, 7>{};
+  configuration.cartesian_impedance = std::array<double, 6>{};
+  configuration.F_T_EE = std::array<double, 16>{};
+
+  server
+      .waitForCommand<robot::SetJointImpedance>([](const robot::SetJointImpedance::Request&) {
+        return robot::SetJointImpedance::Response(
+            robot::SetJointImpedance::Status::kInvalidArgumentRejected);
+      })
+      .waitForCommand<robot::SetCartesianImpedance>(
+          [](const robot::SetCartesianImpedance::Request&) {
+            return robot::SetCartesianImpedance::Response(
+                robot::SetCartesianImpedance::Status::kSuccess);
+          })
+      .waitForCommand<robot::SetFToEE>([](const robot::SetFToEE::Request&) {
+        return robot::SetFToEE::Response(robot::SetFToEE::Status::kCommandNotPossibleRejected);
+      })
+      .spinOnce();
+
+  try {
+    robot.configure(configuration);
+    FAIL() << "Expected CommandException";
+  } catch (const CommandException& e) {
+    std::string message = e.what();
+    EXPECT_THAT(message, ::testing::HasSubstr("2 of 3"));
+    EXPECT_THAT(message, ::testing::HasSubstr("Set Joint Impedance"));
+    EXPECT_THAT(message, ::testing::HasSubstr("Set F to EE"));
+    EXPECT_THAT(message, ::testing::Not(::testing::HasSubstr("Set Cartesian Impedance")));
+  }
+}
+
+TEST(Robot, AsyncCommandReportsRejection) {
+  RobotMockServer server;
+  Robot robot("127.0.0.1");
+
+  server
+      .waitForCommand<robot::AutomaticErrorRecovery>(
+          [](const robot::AutomaticErrorRecovery::Request&) {
+            return robot::AutomaticErrorRecovery::Response(
+                robot::AutomaticErrorRecovery::Status::kCommandNotPossibleRejected);
+          })
+      .spinOnce();
+
+  std::future<void> recovery = robot.automaticErrorRecoveryAsync();
+  EXPECT_THROW(recovery.get(), CommandException);
+}
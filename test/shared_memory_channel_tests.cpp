@@ -0,0 +1,403 @@
+// Copyright (c) 2017 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <franka/exception.h>
+#include <franka/robot.h>
+#include <franka/shared_memory_channel.h>
+#include <research_interface/robot/rbk_types.h>
+#include <research_interface/robot/service_types.h>
+
+#include "shared_memory_channel.h"
+
+using namespace std::chrono_literals;
+
+using franka::DatagramQueue;
+using franka::SharedMemoryChannel;
+
+using research_interface::robot::CommandHeader;
+using research_interface::robot::CommandMessage;
+using research_interface::robot::Connect;
+using research_interface::robot::Move;
+using research_interface::robot::RobotCommand;
+using research_interface::robot::RobotState;
+
+static_assert(sizeof(RobotState) <= SharedMemoryChannel::kMaxDatagramSize,
+              "Robot state does not fit into the shared memory channel.");
+
+namespace {
+
+template <typename T>
+void sendResponse(SharedMemoryChannel& channel,
+                  uint32_t command_id,
+                  const typename T::Response& response) {
+  CommandMessage<typename T::Response> message(
+      CommandHeader(T::kCommand, command_id, sizeof(CommandMessage<typename T::Response>)),
+      response);
+  channel.sendResponse(&message, sizeof(message));
+}
+
+// Answers the connection request. Closes the channel on failure, so that the robot side does not
+// wait for the response.
+auto acceptConnection(SharedMemoryChannel& channel) -> bool {
+  CommandMessage<Connect::Request> request;
+  if (!channel.receiveRequest(&request, sizeof(request), 1s) ||
+      request.header.command != research_interface::robot::Command::kConnect) {
+    ADD_FAILURE() << "Expected a Connect request.";
+    channel.close();
+    return false;
+  }
+  sendResponse<Connect>(channel, request.header.command_id,
+                        Connect::Response(Connect::Status::kSuccess));
+  return true;
+}
+
+}  // anonymous namespace
+
+TEST(DatagramQueue, DropsDatagramsIfFull) {
+  DatagramQueue queue(2, sizeof(uint32_t));
+
+  for (uint32_t i = 0; i < 3; i++) {
+    EXPECT_EQ(i < 2, queue.push(&i, sizeof(i)));
+  }
+
+  uint32_t value = 0;
+  size_t size = 0;
+  ASSERT_TRUE(queue.pop(&value, sizeof(value), &size, nullptr));
+  EXPECT_EQ(0u, value);
+  EXPECT_EQ(sizeof(value), size);
+  ASSERT_TRUE(queue.pop(&value, sizeof(value), &size, nullptr));
+  EXPECT_EQ(1u, value);
+  EXPECT_FALSE(queue.pop(&value, sizeof(value), &size, nullptr));
+}
+
+TEST(DatagramQueue, ThrowsIfDatagramDoesNotFit) {
+  DatagramQueue queue(2, sizeof(uint32_t));
+
+  uint32_t value = 1;
+  queue.push(&value, sizeof(value));
+
+  uint16_t too_small = 0;
+  size_t size = 0;
+  EXPECT_THROW(queue.pop(&too_small, sizeof(too_small), &size, nullptr),
+               franka::ProtocolException);
+  EXPECT_FALSE(queue.pop(&value, sizeof(value), &size, nullptr));
+}
+
+TEST(DatagramQueue, WakesUpBlockedConsumer) {
+  DatagramQueue queue(2, sizeof(uint32_t));
+
+  std::thread producer([&] {
+    // Long enough for the consumer to stop spinning and block.
+    std::this_thread::sleep_for(DatagramQueue::kSpinDuration * 20);
+    uint32_t value = 42;
+    queue.push(&value, sizeof(value));
+  });
+
+  uint32_t value = 0;
+  size_t size = 0;
+  EXPECT_TRUE(
+      queue.pop(&value, sizeof(value), &size, nullptr, std::chrono::steady_clock::now() + 5s));
+  EXPECT_EQ(42u, value);
+  producer.join();
+}
+
+TEST(DatagramQueue, TimesOutIfEmpty) {
+  DatagramQueue queue(2, sizeof(uint32_t));
+
+  uint32_t value = 0;
+  size_t size = 0;
+  EXPECT_FALSE(
+      queue.pop(&value, sizeof(value), &size, nullptr, std::chrono::steady_clock::now() + 1ms));
+}
+
+TEST(SharedMemoryChannel, CanConnectAndReadStates) {
+  SharedMemoryChannel channel;
+  std::atomic_bool running{true};
+
+  std::thread simulator([&] {
+    if (!acceptConnection(channel)) {
+      return;
+    }
+
+    RobotState state{};
+    while (running) {
+      state.message_id++;
+      channel.sendState(&state, sizeof(state));
+      std::this_thread::sleep_for(1ms);
+    }
+  });
+
+  {
+    franka::Robot robot(channel, franka::RealtimeConfig::kIgnore);
+    EXPECT_EQ(research_interface::robot::kVersion, robot.serverVersion());
+
+    franka::RobotState first_state = robot.readOnce();
+    franka::RobotState second_state = robot.readOnce();
+    EXPECT_LT(first_state.time.toMSec(), second_state.time.toMSec());
+    EXPECT_LE(3u, robot.packetStatistics().received);
+  }
+
+  running = false;
+  simulator.join();
+}
+
+namespace {
+
+// Ways to run the motion of expectCanControlRobot.
+enum class Runner { kControl, kMotionSession, kMotionChain };
+
+// Controls a robot served by a simulator which echoes the commanded joint positions into the
+// state, like a perfectly tracking robot.
+void expectCanControlRobot(const franka::NetworkConfig& network_config,
+                           Runner runner = Runner::kControl) {
+  SharedMemoryChannel channel;
+  std::atomic_bool running{true};
+  std::atomic<size_t> received_commands{0};
+  std::atomic<size_t> received_moves{0};
+  std::atomic_bool received_motion_finished{false};
+
+  std::thread simulator([&] {
+    if (!acceptConnection(channel)) {
+      return;
+    }
+
+    RobotState state{};
+    state.robot_mode = research_interface::robot::RobotMode::kIdle;
+    state.motion_generator_mode = research_interface::robot::MotionGeneratorMode::kIdle;
+    state.controller_mode = research_interface::robot::ControllerMode::kOther;
+    uint32_t move_id = 0;
+    while (running) {
+      CommandHeader header;
+      if (channel.receiveRequest(&header, sizeof(header), 0us)) {
+        std::vector<uint8_t> request(header.size - sizeof(header));
+        EXPECT_TRUE(channel.receiveRequest(request.data(), request.size(), 1s));
+        EXPECT_EQ(research_interface::robot::Command::kMove, header.command);
+        move_id = header.command_id;
+        received_moves++;
+        sendResponse<Move>(channel, move_id, Move::Response(Move::Status::kMotionStarted));
+        state.robot_mode = research_interface::robot::RobotMode::kMove;
+        state.motion_generator_mode =
+            research_interface::robot::MotionGeneratorMode::kJointPosition;
+        state.controller_mode = research_interface::robot::ControllerMode::kJointImpedance;
+      }
+
+      RobotCommand command{};
+      if (channel.receiveCommand(&command, sizeof(command), 1ms) == sizeof(command)) {
+        received_commands++;
+        state.q_d = command.motion.q_c;
+        if (command.motion.motion_generation_finished &&
+            state.robot_mode == research_interface::robot::RobotMode::kMove) {
+          received_motion_finished = true;
+          state.robot_mode = research_interface::robot::RobotMode::kIdle;
+          state.motion_generator_mode = research_interface::robot::MotionGeneratorMode::kIdle;
+          sendResponse<Move>(channel, move_id, Move::Response(Move::Status::kSuccess));
+        }
+      }
+
+      state.message_id++;
+      channel.sendState(&state, sizeof(state));
+    }
+  });
+
+  {
+    franka::Robot robot(channel, franka::RealtimeConfig::kIgnore, 50, network_config);
+
+    franka::JointPositions joint_positions{{0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7}};
+    size_t count = 0;
+    std::array<double, 7> last_q_d{};
+    auto next_command = [&](const franka::RobotState& robot_state) -> franka::JointPositions {
+      last_q_d = robot_state.q_d;
+      if (++count < 20) {
+        return joint_positions;
+      }
+      return franka::MotionFinished(joint_positions);
+    };
+    if (runner == Runner::kMotionSession) {
+      auto session = robot.startMotion<franka::JointPositions>(
+          franka::ControllerMode::kJointImpedance, false, franka::kMaxCutoffFrequency);
+      while (!session.finished()) {
+        session.sendCommand(next_command(session.waitForState()));
+      }
+    } else if (runner == Runner::kMotionChain) {
+      auto segment = [&](const franka::RobotState& robot_state, franka::Duration) {
+        franka::JointPositions command = next_command(robot_state);
+        command.motion_finished = count % 10 == 0;
+        return command;
+      };
+      franka::MotionChain<franka::JointPositions> chain;
+      chain.then(segment).then(segment);
+      robot.execute(chain, franka::ControllerMode::kJointImpedance, false,
+                    franka::kMaxCutoffFrequency);
+      EXPECT_EQ(1u, chain.currentSegment());
+    } else {
+      robot.control(
+          [&](const franka::RobotState& robot_state, franka::Duration) {
+            return next_command(robot_state);
+          },
+          franka::ControllerMode::kJointImpedance, false, franka::kMaxCutoffFrequency);
+    }
+
+    EXPECT_EQ(20u, count);
+    EXPECT_EQ(joint_positions.q, last_q_d);
+    EXPECT_LE(count - 1, received_commands);
+    EXPECT_EQ(1u, received_moves);
+    EXPECT_TRUE(received_motion_finished);
+  }
+
+  running = false;
+  simulator.join();
+}
+
+}  // anonymous namespace
+
+TEST(SharedMemoryChannel, CanControlRobot) {
+  expectCanControlRobot(franka::NetworkConfig());
+}
+
+TEST(SharedMemoryChannel, CanControlRobotWithUdpIoThread) {
+  franka::NetworkConfig network_config;
+  network_config.udp_io_thread = true;
+  network_config.udp_io_thread_realtime_config = franka::RealtimeConfig::kIgnore;
+  expectCanControlRobot(network_config);
+}
+
+TEST(SharedMemoryChannel, CanStepMotionSession) {
+  expectCanControlRobot(franka::NetworkConfig(), Runner::kMotionSession);
+}
+
+TEST(SharedMemoryChannel, ExecutesTrajectorySampleBySample) {
+  SharedMemoryChannel channel;
+  std::atomic_bool running{true};
+  std::vector<std::array<double, 7>> received_q_c;
+  std::atomic_bool received_motion_finished{false};
+
+  // Once the first command has been received, sends the next state only after the command for the
+  // previous one, so that every control step takes exactly one millisecond.
+  std::thread simulator([&] {
+    if (!acceptConnection(channel)) {
+      return;
+    }
+
+    RobotState state{};
+    state.robot_mode = research_interface::robot::RobotMode::kIdle;
+    state.motion_generator_mode = research_interface::robot::MotionGeneratorMode::kIdle;
+    state.controller_mode = research_interface::robot::ControllerMode::kOther;
+    uint32_t move_id = 0;
+    bool moving = false;
+    while (running) {
+      CommandHeader header;
+      if (moving) {
+        RobotCommand command{};
+        if (channel.receiveCommand(&command, sizeof(command), 1ms) == sizeof(command)) {
+          received_q_c.push_back(command.motion.q_c);
+          state.q_d = command.motion.q_c;
+        } else if (!received_q_c.empty()) {
+          continue;
+        }
+        if (command.motion.motion_generation_finished) {
+          received_motion_finished = true;
+          moving = false;
+          state.robot_mode = research_interface::robot::RobotMode::kIdle;
+          state.motion_generator_mode = research_interface::robot::MotionGeneratorMode::kIdle;
+          sendResponse<Move>(channel, move_id, Move::Response(Move::Status::kSuccess));
+        }
+      } else if (channel.receiveRequest(&header, sizeof(header), 0us)) {
+        std::vector<uint8_t> request(header.size - sizeof(header));
+        EXPECT_TRUE(channel.receiveRequest(request.data(), request.size(), 1s));
+        EXPECT_EQ(research_interface::robot::Command::kMove, header.command);
+        move_id = header.command_id;
+        moving = true;
+        sendResponse<Move>(channel, move_id, Move::Response(Move::Status::kMotionStarted));
+        state.robot_mode = research_interface::robot::RobotMode::kMove;
+        state.motion_generator_mode =
+            research_interface::robot::MotionGeneratorMode::kJointPosition;
+        state.controller_mode = research_interface::robot::ControllerMode::kJointImpedance;
+      } else {
+        std::this_thread::sleep_for(1ms);
+      }
+
+      state.message_id++;
+      channel.sendState(&state, sizeof(state));
+    }
+  });
+
+  franka::Trajectory<franka::JointPositions> trajectory;
+  std::vector<std::array<double, 7>> expected_q_c;
+  for (size_t i = 0; i < 5; i++) {
+    std::array<double, 7> q{};
+    for (size_t j = 0; j < q.size(); j++) {
+      q[j] = 0.1 * j + 0.01 * i;
+    }
+    trajectory.add(franka::JointPositions(q));
+    expected_q_c.push_back(q);
+  }
+
+  {
+    franka::Robot robot(channel, franka::RealtimeConfig::kIgnore);
+    robot.execute(trajectory, franka::ControllerMode::kJointImpedance, false,
+                  franka::kMaxCutoffFrequency);
+  }
+
+  running = false;
+  simulator.join();
+  EXPECT_EQ(expected_q_c, received_q_c);
+  EXPECT_TRUE(received_motion_finished);
+}
+
+TEST(SharedMemoryChannel, CanExecuteMotionChain) {
+  expectCanControlRobot(franka::NetworkConfig(), Runner::kMotionChain);
+}
+
+TEST(SharedMemoryChannel, ThrowsOnEmptyTrajectory) {
+  SharedMemoryChannel channel;
+  std::atomic_bool running{true};
+
+  std::thread simulator([&] {
+    if (!acceptConnection(channel)) {
+      return;
+    }
+
+    RobotState state{};
+    while (running) {
+      state.message_id++;
+      channel.sendState(&state, sizeof(state));
+      std::this_thread::sleep_for(1ms);
+    }
+  });
+
+  {
+    franka::Robot robot(channel, franka::RealtimeConfig::kIgnore);
+    EXPECT_THROW(robot.execute(franka::Trajectory<franka::JointPositions>()),
+                 std::invalid_argument);
+    EXPECT_THROW(robot.execute(franka::Trajectory<franka::Torques>()), std::invalid_argument);
+  }
+
+  running = false;
+  simulator.join();
+}
+
+TEST(SharedMemoryChannel, ThrowsIfSimulatorClosesChannel) {
+  SharedMemoryChannel channel;
+  channel.close();
+
+  EXPECT_THROW(franka::Robot(channel, franka::RealtimeConfig::kIgnore), franka::NetworkException);
+}
+
+TEST(SharedMemoryChannel, ThrowsIfSimulatorDoesNotAnswer) {
+  SharedMemoryChannel channel;
+  franka::NetworkConfig network_config;
+  network_config.tcp_timeout = 50ms;
+
+  auto start = std::chrono::steady_clock::now();
+  EXPECT_THROW(franka::Robot(channel, franka::RealtimeConfig::kIgnore, 50, network_config),
+               franka::NetworkException);
+  EXPECT_LT(std::chrono::steady_clock::now() - start, 5s);
+}
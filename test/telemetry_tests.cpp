@@ -0,0 +1,121 @@
+// Copyright (c) 2017 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <franka/exception.h>
+#include <franka/robot.h>
+#include <franka/telemetry.h>
+
+#include "mock_server.h"
+#include "telemetry.h"
+
+using franka::Record;
+using franka::TelemetryReader;
+using franka::TelemetryRecorder;
+using franka::TelemetryStatistics;
+
+namespace {
+
+auto telemetryPath() -> std::string {
+  return ::testing::TempDir() + "libfranka_telemetry_tests.bin";
+}
+
+}  // anonymous namespace
+
+TEST(Telemetry, ReadsRecordedStatesAndCommands) {
+  std::string path = telemetryPath();
+  TelemetryRecorder recorder(path, research_interface::robot::kVersion);
+
+  const std::chrono::system_clock::time_point start(std::chrono::seconds(1000));
+  for (size_t i = 0; i < 3; i++) {
+    research_interface::robot::RobotState state{};
+    state.message_id = 10 + i;
+    state.q[2] = 0.1 * i;
+    research_interface::robot::RobotCommand command{};
+    command.motion.q_c[4] = 0.2 * i;
+    franka::RobotState converted;
+    converted.host_receive_time = start + std::chrono::milliseconds(i);
+    converted.host_receive_latency = std::chrono::microseconds(5);
+    if (i > 0) {
+      converted.host_command_send_time =
+          converted.host_receive_time - std::chrono::microseconds(300);
+    }
+    recorder.record(state, command, converted);
+  }
+  TelemetryStatistics statistics = recorder.stop();
+  EXPECT_EQ(3u, statistics.recorded);
+  EXPECT_EQ(0u, statistics.dropped);
+
+  TelemetryReader reader(path);
+  Record record;
+  for (size_t i = 0; i < 3; i++) {
+    ASSERT_TRUE(reader.read(&record));
+    EXPECT_EQ(0.1 * i, record.state.q[2]);
+    EXPECT_EQ(0.2 * i, record.command.joint_positions.q[4]);
+    EXPECT_EQ(start + std::chrono::milliseconds(i), record.state.host_receive_time);
+    EXPECT_EQ(std::chrono::microseconds(5), record.state.host_receive_latency);
+    if (i > 0) {
+      EXPECT_EQ(std::chrono::microseconds(700), record.state.host_command_turnaround);
+    } else {
+      EXPECT_EQ(std::chrono::system_clock::time_point(), record.state.host_command_send_time);
+    }
+  }
+  EXPECT_FALSE(reader.read(&record));
+  std::remove(path.c_str());
+}
+
+TEST(Telemetry, ReaderRejectsInvalidFiles) {
+  std::string path = telemetryPath();
+  EXPECT_THROW(TelemetryReader(path + ".missing"), franka::Exception);
+
+  std::ofstream(path) << "not a telemetry file";
+  EXPECT_THROW(TelemetryReader reader(path), franka::Exception);
+
+  franka::TelemetryRecorder(path, research_interface::robot::kVersion + 1).stop();
+  EXPECT_THROW(TelemetryReader reader(path), franka::IncompatibleVersionException);
+
+  {
+    TelemetryRecorder recorder(path, research_interface::robot::kVersion);
+    recorder.record({}, {}, franka::RobotState());
+    recorder.stop();
+  }
+  std::ifstream file(path, std::ios::binary);
+  std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  std::ofstream(path, std::ios::binary) << contents.substr(0, contents.size() - 1);
+  TelemetryReader reader(path);
+  Record record;
+  EXPECT_THROW(reader.read(&record), franka::Exception);
+  std::remove(path.c_str());
+}
+
+TEST(Telemetry, RobotRecordsReadStates) {
+  std::string path = telemetryPath();
+  RobotMockServer server;
+  franka::Robot robot("127.0.0.1");
+
+  EXPECT_THROW(robot.stopTelemetryRecording(), franka::InvalidOperationException);
+  robot.startTelemetryRecording(path);
+  EXPECT_THROW(robot.startTelemetryRecording(path), franka::InvalidOperationException);
+
+  for (size_t i = 0; i < 3; i++) {
+    server.sendEmptyState<research_interface::robot::RobotState>().spinOnce();
+    robot.read([](const franka::RobotState&) { return false; });
+  }
+  TelemetryStatistics statistics = robot.stopTelemetryRecording();
+  EXPECT_EQ(3u, statistics.recorded);
+  EXPECT_EQ(0u, statistics.dropped);
+
+  TelemetryReader reader(path);
+  Record record;
+  size_t records = 0;
+  while (reader.read(&record)) {
+    records++;
+  }
+  EXPECT_EQ(3u, records);
+  std::remove(path.c_str());
+}
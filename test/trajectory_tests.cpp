@@ -0,0 +1,109 @@
+// Copyright (c) 2017 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <vector>
+
+#include <gmock/gmock.h>
+
+#include <franka/trajectory.h>
+
+#include "control_loop.h"
+#include "helpers.h"
+#include "mock_robot_control.h"
+
+using namespace ::testing;
+
+using franka::Duration;
+using franka::JointPositions;
+using franka::RobotState;
+using franka::Torques;
+using franka::Trajectory;
+using franka::TrajectoryPlayer;
+
+namespace {
+
+auto rampTrajectory(size_t size) -> Trajectory<JointPositions> {
+  Trajectory<JointPositions> trajectory;
+  trajectory.reserve(size);
+  for (size_t i = 0; i < size; i++) {
+    double q = static_cast<double>(i);
+    trajectory.add(JointPositions({q, q, q, q, q, q, q}));
+  }
+  return trajectory;
+}
+
+}  // anonymous namespace
+
+TEST(Trajectory, CanBeCreatedFromSamples) {
+  Trajectory<Torques> trajectory(
+      std::vector<Torques>{Torques({0, 0, 0, 0, 0, 0, 0}), Torques({1, 1, 1, 1, 1, 1, 1})});
+
+  EXPECT_EQ(2u, trajectory.size());
+  EXPECT_FALSE(trajectory.empty());
+  EXPECT_EQ(1.0, trajectory[1].tau_J[0]);
+  EXPECT_EQ(&trajectory[0], trajectory.data());
+  EXPECT_EQ(1u, trajectory.duration().toMSec());
+  EXPECT_EQ(0u, Trajectory<Torques>().duration().toMSec());
+}
+
+TEST(TrajectoryPlayer, ReturnsSamplesByElapsedTime) {
+  Trajectory<JointPositions> trajectory = rampTrajectory(5);
+  TrajectoryPlayer<JointPositions> player(trajectory);
+  RobotState robot_state;
+
+  JointPositions sample = player(robot_state, Duration(0));
+  EXPECT_EQ(0.0, sample.q[0]);
+  EXPECT_FALSE(sample.motion_finished);
+
+  sample = player(robot_state, Duration(1));
+  EXPECT_EQ(1.0, sample.q[0]);
+  EXPECT_FALSE(sample.motion_finished);
+
+  // A lost state skips the sample which was due in the meantime.
+  sample = player(robot_state, Duration(2));
+  EXPECT_EQ(3.0, sample.q[0]);
+  EXPECT_FALSE(sample.motion_finished);
+
+  sample = player(robot_state, Duration(5));
+  EXPECT_EQ(4.0, sample.q[0]);
+  EXPECT_TRUE(sample.motion_finished);
+  EXPECT_FALSE(trajectory[4].motion_finished);
+}
+
+TEST(TrajectoryPlayer, FinishesSingleSampleTrajectoryImmediately) {
+  Trajectory<JointPositions> trajectory = rampTrajectory(1);
+  TrajectoryPlayer<JointPositions> player(trajectory);
+
+  EXPECT_TRUE(player(RobotState(), Duration(0)).motion_finished);
+}
+
+TEST(TrajectoryPlayer, StreamsSamplesThroughControlLoop) {
+  NiceMock<MockRobotControl> robot;
+  RobotState robot_state = generateValidRobotState();
+  robot_state.time = Duration(0);
+  EXPECT_CALL(robot, update(_, _)).WillRepeatedly(Invoke([&](auto, auto) {
+    robot_state.time += Duration(1);
+    return robot_state;
+  }));
+
+  Trajectory<JointPositions> trajectory;
+  for (size_t i = 0; i < 3; i++) {
+    JointPositions sample(robot_state.q_d);
+    sample.q[0] += 0.001 * static_cast<double>(i);
+    trajectory.add(sample);
+  }
+
+  std::vector<double> commanded;
+  EXPECT_CALL(robot, finishMotion(_, NotNull(), nullptr))
+      .WillOnce(Invoke(
+          [&](uint32_t, const research_interface::robot::MotionGeneratorCommand* command, auto) {
+            commanded.push_back(command->q_c[0]);
+          }));
+
+  franka::ControlLoop<JointPositions, TrajectoryPlayer<JointPositions>> loop(
+      robot, franka::ControllerMode::kJointImpedance, TrajectoryPlayer<JointPositions>(trajectory),
+      false, franka::kMaxCutoffFrequency);
+  loop();
+
+  ASSERT_EQ(1u, commanded.size());
+  EXPECT_EQ(trajectory[2].q[0], commanded[0]);
+}
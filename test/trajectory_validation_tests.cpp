@@ -0,0 +1,176 @@
+// Copyright (c) 2017 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <franka/trajectory_validation.h>
+
+using franka::CartesianPose;
+using franka::CartesianVelocities;
+using franka::JointPositions;
+using franka::JointVelocities;
+using franka::Trajectory;
+using franka::TrajectoryValidationOptions;
+using franka::TrajectoryValidationReport;
+using franka::TrajectoryViolationType;
+
+namespace {
+
+constexpr std::array<double, 16> kIdentity{
+    {1.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.3, 0.0, 0.5, 1.0}};
+
+// Smooth motion of all joints which starts and ends at rest.
+auto smoothTrajectory(size_t size) -> Trajectory<JointPositions> {
+  Trajectory<JointPositions> trajectory;
+  for (size_t i = 0; i < size; i++) {
+    double t = size > 1 ? static_cast<double>(i) / static_cast<double>(size - 1) : 0.0;
+    double q = 0.05 * (1.0 - std::cos(2.0 * M_PI * t));
+    trajectory.add(JointPositions({q, q, q, q, q, q, q}));
+  }
+  return trajectory;
+}
+
+}  // anonymous namespace
+
+TEST(TrajectoryValidation, AcceptsSmoothTrajectory) {
+  TrajectoryValidationReport report = franka::validateTrajectory(smoothTrajectory(2000));
+
+  EXPECT_EQ(2000u, report.samples);
+  EXPECT_TRUE(report.valid());
+  EXPECT_TRUE(franka::validateTrajectory(Trajectory<JointPositions>()).valid());
+}
+
+TEST(TrajectoryValidation, ReportsStepsInJointPositions) {
+  Trajectory<JointPositions> smooth = smoothTrajectory(2000);
+  std::vector<JointPositions> samples(smooth.data(), smooth.data() + smooth.size());
+  for (size_t i = 1000; i < samples.size(); i++) {
+    samples[i].q[3] += 0.01;
+  }
+
+  TrajectoryValidationReport report =
+      franka::validateTrajectory(Trajectory<JointPositions>(samples));
+
+  ASSERT_FALSE(report.valid());
+  EXPECT_EQ(1000u, report.violations[0].sample);
+  EXPECT_EQ(3u, report.violations[0].component);
+  EXPECT_EQ(TrajectoryViolationType::kVelocityLimit, report.violations[0].type);
+  EXPECT_GT(report.violations[0].deviation, 0.0);
+  for (const auto& violation : report.violations) {
+    EXPECT_EQ(3u, violation.component);
+    EXPECT_LE(1000u, violation.sample);
+    EXPECT_GE(1002u, violation.sample);
+  }
+}
+
+TEST(TrajectoryValidation, ClassifiesJointVelocityViolations) {
+  std::vector<JointVelocities> samples(5, JointVelocities({0, 0, 0, 0, 0, 0, 0}));
+  // Joint 1 ramps up with an acceleration within the limit, but starts with too much jerk.
+  for (size_t i = 0; i < samples.size(); i++) {
+    samples[i].dq[0] = 10.0 * franka::kDeltaT * static_cast<double>(i + 1);
+  }
+  // Joint 3 jumps to a velocity within the limit.
+  samples[2].dq[2] = 0.5;
+
+  TrajectoryValidationReport report =
+      franka::validateTrajectory(Trajectory<JointVelocities>(samples));
+
+  ASSERT_FALSE(report.valid());
+  EXPECT_EQ(0u, report.violations[0].sample);
+  EXPECT_EQ(0u, report.violations[0].component);
+  EXPECT_EQ(TrajectoryViolationType::kJerkLimit, report.violations[0].type);
+  bool found_acceleration = false;
+  for (const auto& violation : report.violations) {
+    if (violation.sample == 2 && violation.component == 2) {
+      EXPECT_EQ(TrajectoryViolationType::kAccelerationLimit, violation.type);
+      found_acceleration = true;
+    }
+  }
+  EXPECT_TRUE(found_acceleration);
+}
+
+TEST(TrajectoryValidation, ReportsInvalidSamples) {
+  std::vector<JointPositions> joint_samples(3, JointPositions({0, 0, 0, 0, 0, 0, 0}));
+  joint_samples[1].q[4] = std::numeric_limits<double>::quiet_NaN();
+  TrajectoryValidationReport joint_report =
+      franka::validateTrajectory(Trajectory<JointPositions>(joint_samples));
+  ASSERT_EQ(1u, joint_report.violations.size());
+  EXPECT_EQ(1u, joint_report.violations[0].sample);
+  EXPECT_EQ(4u, joint_report.violations[0].component);
+  EXPECT_EQ(TrajectoryViolationType::kNotFinite, joint_report.violations[0].type);
+
+  std::vector<CartesianPose> pose_samples(4, CartesianPose(kIdentity, {0.0, 1.0}));
+  pose_samples[1].O_T_EE[0] = 2.0;
+  pose_samples[2].elbow[1] = 0.5;
+  TrajectoryValidationReport pose_report =
+      franka::validateTrajectory(Trajectory<CartesianPose>(pose_samples));
+  ASSERT_EQ(2u, pose_report.violations.size());
+  EXPECT_EQ(1u, pose_report.violations[0].sample);
+  EXPECT_EQ(0u, pose_report.violations[0].component);
+  EXPECT_EQ(TrajectoryViolationType::kInvalidTransformation, pose_report.violations[0].type);
+  EXPECT_EQ(2u, pose_report.violations[1].sample);
+  EXPECT_EQ(2u, pose_report.violations[1].component);
+  EXPECT_EQ(TrajectoryViolationType::kInvalidElbow, pose_report.violations[1].type);
+}
+
+TEST(TrajectoryValidation, ChecksCartesianMotions) {
+  std::vector<CartesianPose> poses(10, CartesianPose(kIdentity));
+  for (size_t i = 5; i < poses.size(); i++) {
+    poses[i].O_T_EE[12] += 0.01;
+  }
+  TrajectoryValidationReport pose_report =
+      franka::validateTrajectory(Trajectory<CartesianPose>(poses));
+  ASSERT_FALSE(pose_report.valid());
+  EXPECT_EQ(5u, pose_report.violations[0].sample);
+  EXPECT_EQ(0u, pose_report.violations[0].component);
+  EXPECT_EQ(TrajectoryViolationType::kVelocityLimit, pose_report.violations[0].type);
+
+  std::vector<CartesianVelocities> twists(10, CartesianVelocities({0, 0, 0, 0, 0, 0}));
+  twists[3].O_dP_EE[5] = 0.1;
+  TrajectoryValidationReport twist_report =
+      franka::validateTrajectory(Trajectory<CartesianVelocities>(twists));
+  ASSERT_FALSE(twist_report.valid());
+  EXPECT_EQ(3u, twist_report.violations[0].sample);
+  EXPECT_EQ(1u, twist_report.violations[0].component);
+  EXPECT_EQ(TrajectoryViolationType::kAccelerationLimit, twist_report.violations[0].type);
+}
+
+TEST(TrajectoryValidation, SplittingIntoChunksDoesNotChangeReports) {
+  std::vector<Trajectory<JointPositions>> trajectories;
+  for (size_t size : {1u, 100u, 2000u}) {
+    std::vector<JointPositions> samples;
+    Trajectory<JointPositions> smooth = smoothTrajectory(size);
+    for (size_t i = 0; i < smooth.size(); i++) {
+      samples.push_back(smooth[i]);
+      if (i % 37 == 0) {
+        samples.back().q[i % 7] += 0.001;
+      }
+    }
+    trajectories.emplace_back(samples);
+  }
+
+  TrajectoryValidationOptions sequential;
+  sequential.threads = 1;
+  TrajectoryValidationOptions parallel;
+  parallel.chunk_size = 13;
+  parallel.threads = 4;
+  std::vector<TrajectoryValidationReport> expected =
+      franka::validateTrajectories(trajectories, sequential);
+  std::vector<TrajectoryValidationReport> actual =
+      franka::validateTrajectories(trajectories, parallel);
+
+  ASSERT_EQ(trajectories.size(), actual.size());
+  for (size_t i = 0; i < trajectories.size(); i++) {
+    EXPECT_EQ(trajectories[i].size(), actual[i].samples);
+    ASSERT_EQ(expected[i].violations.size(), actual[i].violations.size());
+    for (size_t j = 0; j < expected[i].violations.size(); j++) {
+      EXPECT_EQ(expected[i].violations[j].sample, actual[i].violations[j].sample);
+      EXPECT_EQ(expected[i].violations[j].component, actual[i].violations[j].component);
+      EXPECT_EQ(expected[i].violations[j].type, actual[i].violations[j].type);
+      EXPECT_EQ(expected[i].violations[j].deviation, actual[i].violations[j].deviation);
+    }
+  }
+  EXPECT_FALSE(actual[2].valid());
+}